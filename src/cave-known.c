@@ -0,0 +1,109 @@
+/**
+ * \file cave-known.c
+ * \brief The player's memory of the map
+ *
+ * Copyright (c) 2014 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ *
+ * Rather than keep a second full chunk, the known map holds one feature byte
+ * for each grid and a bitset of the grids which have been remembered.
+ * Objects and traps are remembered on the objects and traps themselves, as
+ * before.
+ */
+
+#include "angband.h"
+#include "cave.h"
+
+/**
+ * The player's map memory of the current level
+ */
+struct known_map *known_map;
+
+/**
+ * Make an empty known map.
+ */
+struct known_map *known_map_new(int height, int width)
+{
+	struct known_map *k = mem_zalloc(sizeof(*k));
+
+	k->height = height;
+	k->width = width;
+	k->words = (width + PLANE_WORD_BITS - 1) / PLANE_WORD_BITS;
+	k->feat = mem_zalloc(height * width * sizeof(byte));
+	k->known = mem_zalloc(height * k->words * sizeof(u64b));
+
+	return k;
+}
+
+/**
+ * Free a known map.
+ */
+void known_map_free(struct known_map *k)
+{
+	mem_free(k->feat);
+	mem_free(k->known);
+	mem_free(k);
+}
+
+/* ------------------ Features ---------------- */
+
+/**
+ * Whether the player remembers anything about a grid.
+ */
+bool known_map_isknown(struct known_map *k, int y, int x)
+{
+	u64b bit = (u64b) 1 << (x % PLANE_WORD_BITS);
+
+	return (k->known[y * k->words + x / PLANE_WORD_BITS] & bit) ? TRUE : FALSE;
+}
+
+/**
+ * The remembered feature of a grid, or FEAT_NONE.
+ */
+int known_map_feat(struct known_map *k, int y, int x)
+{
+	return k->feat[y * k->width + x];
+}
+
+/**
+ * Remember the feature of a grid.
+ */
+void known_map_note_feat(struct known_map *k, int y, int x, int feat)
+{
+	k->feat[y * k->width + x] = feat;
+	k->known[y * k->words + x / PLANE_WORD_BITS] |=
+		(u64b) 1 << (x % PLANE_WORD_BITS);
+}
+
+/**
+ * Forget everything about a grid.
+ */
+void known_map_forget(struct known_map *k, int y, int x)
+{
+	k->feat[y * k->width + x] = FEAT_NONE;
+	k->known[y * k->words + x / PLANE_WORD_BITS] &=
+		~((u64b) 1 << (x % PLANE_WORD_BITS));
+}
+
+/**
+ * Remember the features of every grid of a chunk.
+ */
+void known_map_note_all(struct known_map *k, struct chunk *c)
+{
+	int y, x;
+
+	memset(k->known, 0xff, k->height * k->words * sizeof(u64b));
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			k->feat[y * k->width + x] = c->squares[y][x].feat;
+}
@@ -106,22 +106,21 @@ void map_info(unsigned y, unsigned x, grid_data *g)
 		if (!square_isglow(cave, y, x) && OPT(view_yellow_light))
 			g->lighting = LIGHTING_TORCH;
 
-		/* Remember seen feature */
-		cave_k->squares[y][x].feat = cave->squares[y][x].feat;
 	} else if (!square_ismark(cave, y, x)) {
 		g->f_idx = FEAT_NONE;
-		//cave_k->squares[y][x].feat = FEAT_NONE;
 	} else if (square_isglow(cave, y, x)) {
 		g->lighting = LIGHTING_LIT;
 	}
 
 	/* Use known feature */
-/*	g->f_idx = cave_k->squares[y][x].feat;
+/*	g->f_idx = known_map_feat(known_map, y, x);
 	if (f_info[g->f_idx].mimic)
 		g->f_idx = f_info[g->f_idx].mimic;*/
 
-    /* There is a trap in this square */
-    if (square_istrap(cave, y, x) && square_ismark(cave, y, x)) {
+    /* There is a player trap or rune in this square */
+    if (square_ismark(cave, y, x) &&
+		(square_trap_flag(cave, y, x, TRF_TRAP) ||
+		 square_trap_flag(cave, y, x, TRF_RUNE))) {
 		struct trap *trap = cave->squares[y][x].trap;
 
 		/* Scan the square trap list */
@@ -222,6 +221,10 @@ void square_note_spot(struct chunk *c, int y, int x)
 	for (obj = square_object(c, y, x); obj; obj = obj->next)
 		obj->marked = MARK_SEEN;
 
+	/* Update the player's map memory */
+	if (c == cave && known_map)
+		known_map_note_feat(known_map, y, x, c->squares[y][x].feat);
+
 	if (square_ismark(c, y, x))
 		return;
 
@@ -448,7 +451,9 @@ void wiz_light(struct chunk *c, bool full)
 					if (!square_isfloor(c, yy, xx) || 
 						square_isvisibletrap(c, yy, xx)) {
 						sqinfo_on(c->squares[yy][xx].info, SQUARE_MARK);
-						cave_k->squares[yy][xx].feat = c->squares[yy][xx].feat;
+						if (c == cave)
+							known_map_note_feat(known_map, yy, xx,
+												c->squares[yy][xx].feat);
 					}
 				}
 			}
@@ -748,11 +753,3 @@ void cave_update_flow(struct chunk *c)
 	}
 }
 
-/* Make map features known */
-void cave_known (void)
-{
-	int y,x;
-	for (y = 0; y < cave->height; y++)
-		for (x = 0; x < cave->width; x++)
-			cave_k->squares[y][x].feat = cave->squares[y][x].feat;
-}
@@ -0,0 +1,222 @@
+/**
+ * \file cave-region.c
+ * \brief Labelling of connected regions of a chunk
+ *
+ * Copyright (c) 2014 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ *
+ * Regions are found with the classic two pass labelling: the first pass
+ * walks the chunk in row order, giving each grid the label of a neighbour
+ * it has already seen (merging labels with a union-find forest when it sees
+ * more than one), and the second pass renumbers the labels so that regions
+ * are numbered in the order their first grid is met.  Regions can later be
+ * joined in constant time, rather than by repainting the whole chunk.
+ */
+
+#include "angband.h"
+#include "cave.h"
+
+/**
+ * Find the root of a label, halving the path on the way.
+ */
+static int region_root(int *parent, int label)
+{
+	while (parent[label] != label) {
+		parent[label] = parent[parent[label]];
+		label = parent[label];
+	}
+
+	return label;
+}
+
+/**
+ * Merge two labels, keeping the lower one as the root.
+ */
+static int region_union(int *parent, int a, int b)
+{
+	a = region_root(parent, a);
+	b = region_root(parent, b);
+
+	if (a < b) {
+		parent[b] = a;
+		return a;
+	}
+
+	parent[a] = b;
+	return b;
+}
+
+/**
+ * Label the regions of a chunk.
+ * \param c is the chunk
+ * \param pred picks the grids that belong to regions
+ * \param diagonal is whether regions connect diagonally as well as NESW
+ * \return the region map, to be freed with cave_regions_free()
+ */
+struct cave_regions *cave_regions_new(struct chunk *c, square_predicate pred,
+									  bool diagonal)
+{
+	struct cave_regions *r = mem_zalloc(sizeof(*r));
+	int h = c->height;
+	int w = c->width;
+	int y, x, i, num = 0;
+	int *parent, *relabel;
+
+	parent = mem_zalloc((h * w + 1) * sizeof(int));
+
+	r->height = h;
+	r->width = w;
+	r->label = mem_zalloc(h * w * sizeof(int));
+
+	/* First pass: provisional labels, merged where they meet */
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w; x++) {
+			int n = y * w + x;
+			int label = 0;
+
+			if (!pred(c, y, x)) continue;
+
+			/* Look at the neighbours already labelled */
+			if (x > 0 && r->label[n - 1])
+				label = r->label[n - 1];
+			if (y > 0) {
+				int up = n - w;
+				if (r->label[up])
+					label = label ? region_union(parent, label, r->label[up])
+						: r->label[up];
+				if (diagonal && x > 0 && r->label[up - 1])
+					label = label ? region_union(parent, label, r->label[up - 1])
+						: r->label[up - 1];
+				if (diagonal && x < w - 1 && r->label[up + 1])
+					label = label ? region_union(parent, label, r->label[up + 1])
+						: r->label[up + 1];
+			}
+
+			/* Start a new region if need be */
+			if (!label) {
+				label = ++num;
+				parent[label] = label;
+			}
+			r->label[n] = label;
+		}
+	}
+
+	/* Number the regions in the order their first grid was met */
+	relabel = mem_zalloc((num + 1) * sizeof(int));
+	for (i = 1; i <= num; i++)
+		if (region_root(parent, i) == i)
+			relabel[i] = ++r->num;
+
+	r->live = r->num;
+	r->parent = mem_zalloc((r->num + 1) * sizeof(int));
+	r->size = mem_zalloc((r->num + 1) * sizeof(int));
+	r->first = mem_zalloc((r->num + 1) * sizeof(struct loc));
+	for (i = 0; i <= r->num; i++)
+		r->parent[i] = i;
+
+	/* Second pass: final labels, sizes and first grids */
+	for (i = 0; i < h * w; i++) {
+		int label;
+
+		if (!r->label[i]) continue;
+		label = relabel[region_root(parent, r->label[i])];
+		r->label[i] = label;
+		if (!r->size[label]++) {
+			r->first[label].y = i / w;
+			r->first[label].x = i % w;
+		}
+	}
+
+	mem_free(relabel);
+	mem_free(parent);
+
+	return r;
+}
+
+/**
+ * Free a region map.
+ */
+void cave_regions_free(struct cave_regions *r)
+{
+	mem_free(r->label);
+	mem_free(r->parent);
+	mem_free(r->size);
+	mem_free(r->first);
+	mem_free(r);
+}
+
+/**
+ * Return the region a label now belongs to, or 0 for no region.
+ */
+int cave_region_find(struct cave_regions *r, int label)
+{
+	return region_root(r->parent, label);
+}
+
+/**
+ * Return the region of a grid, or 0 if the grid is in no region.
+ */
+int cave_region_at(struct cave_regions *r, int y, int x)
+{
+	return region_root(r->parent, r->label[y * r->width + x]);
+}
+
+/**
+ * Return the number of grids in a region.
+ */
+int cave_region_size(struct cave_regions *r, int region)
+{
+	return r->size[region_root(r->parent, region)];
+}
+
+/**
+ * Join region b into region a.
+ * \return the region they now form
+ */
+int cave_region_join(struct cave_regions *r, int a, int b)
+{
+	a = region_root(r->parent, a);
+	b = region_root(r->parent, b);
+	if (a == b) return a;
+
+	r->parent[b] = a;
+	if (r->size[a] && r->size[b]) r->live--;
+	r->size[a] += r->size[b];
+	r->size[b] = 0;
+
+	return a;
+}
+
+/**
+ * Drop a region, so it no longer counts as live.  Its grids keep their
+ * labels; callers clear the ones they remove.
+ */
+void cave_region_drop(struct cave_regions *r, int region)
+{
+	region = region_root(r->parent, region);
+	if (r->size[region]) r->live--;
+	r->size[region] = 0;
+}
+
+/**
+ * Return the lowest numbered live region, or 0 if there are none.
+ */
+int cave_region_first(struct cave_regions *r)
+{
+	int i;
+
+	for (i = 1; i <= r->num; i++)
+		if (r->parent[i] == i && r->size[i] > 0) return i;
+
+	return 0;
+}
@@ -107,6 +107,17 @@ bool feat_is_bright(int feat)
 	return tf_has(f_info[feat].flags, TF_BRIGHT);
 }
 
+/**
+ * Check a square's bit in one of its chunk's terrain bit planes
+ */
+static bool square_plane_has(struct chunk *c, enum square_plane plane,
+							 int y, int x)
+{
+	u64b word = c->planes[plane][y * c->plane_words + x / PLANE_WORD_BITS];
+
+	return (word >> (x % PLANE_WORD_BITS)) & 1;
+}
+
 /**
  * SQUARE FEATURE PREDICATES
  *
@@ -127,7 +138,7 @@ bool feat_is_bright(int feat)
  */
 bool square_isfloor(struct chunk *c, int y, int x)
 {
-	return tf_has(f_info[c->squares[y][x].feat].flags, TF_FLOOR);
+	return square_plane_has(c, PLANE_FLOOR, y, x);
 }
 
 /**
@@ -507,7 +518,7 @@ bool square_is_monster_walkable(struct chunk *c, int y, int x)
  */
 bool square_ispassable(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_passable(c->squares[y][x].feat);
+	return square_plane_has(c, PLANE_PASSABLE, y, x);
 }
 
 /**
@@ -517,7 +528,7 @@ bool square_ispassable(struct chunk *c, int y, int x) {
  */
 bool square_isprojectable(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_projectable(c->squares[y][x].feat);
+	return square_plane_has(c, PLANE_PROJECT, y, x);
 }
 
 /**
@@ -546,7 +557,7 @@ bool square_isstrongwall(struct chunk *c, int y, int x) {
  */
 bool square_isbright(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_bright(c->squares[y][x].feat);
+	return square_plane_has(c, PLANE_BRIGHT, y, x);
 }
 
 bool square_iswarded(struct chunk *c, int y, int x)
@@ -726,6 +737,42 @@ void square_excise_pile(struct chunk *c, int y, int x) {
 }
 
 
+/**
+ * Bring a square's bits in the terrain bit planes into line with its
+ * terrain.  Only needed by code which copies terrain directly rather than
+ * using square_set_feat().
+ */
+void square_set_planes(struct chunk *c, int y, int x)
+{
+	int feat = c->squares[y][x].feat;
+	size_t word = y * c->plane_words + x / PLANE_WORD_BITS;
+	u64b bit = (u64b)1 << (x % PLANE_WORD_BITS);
+	bool has[PLANE_MAX];
+	int i;
+
+	has[PLANE_PROJECT] = feat_is_projectable(feat);
+	has[PLANE_PASSABLE] = feat_is_passable(feat);
+	has[PLANE_BRIGHT] = feat_is_bright(feat);
+	has[PLANE_FLOOR] = tf_has(f_info[feat].flags, TF_FLOOR);
+
+	for (i = 0; i < PLANE_MAX; i++) {
+		if (has[i])
+			c->planes[i][word] |= bit;
+		else
+			c->planes[i][word] &= ~bit;
+	}
+}
+
+/**
+ * Get one row of a terrain bit plane; bit (x % PLANE_WORD_BITS) of word
+ * (x / PLANE_WORD_BITS) is set if the property holds at (y, x).
+ */
+const u64b *square_plane_row(struct chunk *c, enum square_plane plane, int y)
+{
+	assert(y >= 0 && y < c->height);
+	return &c->planes[plane][y * c->plane_words];
+}
+
 /**
  * Set the terrain type for a square.
  *
@@ -746,6 +793,7 @@ void square_set_feat(struct chunk *c, int y, int x, int feat)
 
 	/* Make the change */
 	c->squares[y][x].feat = feat;
+	square_set_planes(c, y, x);
 
 	/* Make the new terrain feel at home */
 	if (character_dungeon) {
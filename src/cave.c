@@ -34,7 +34,6 @@
 
 struct feature *f_info;
 struct chunk *cave = NULL;
-struct chunk *cave_k = NULL;
 
 /**
  * Global array for looping through the "keypad directions".
@@ -116,7 +115,8 @@ void set_terrain(void)
  * Allocate a new chunk of the world
  */
 struct chunk *cave_new(int height, int width) {
-	int y, x;
+	int y, x, i;
+	int old_tag = mem_tag_set(MEM_TAG_CAVE);
 
 	struct chunk *c = mem_zalloc(sizeof *c);
 	c->height = height;
@@ -130,11 +130,20 @@ struct chunk *cave_new(int height, int width) {
 			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
 	}
 
-	c->monsters = mem_zalloc(z_info->level_monster_max *sizeof(struct monster));
+	c->plane_words = (c->width + PLANE_WORD_BITS - 1) / PLANE_WORD_BITS;
+	for (i = 0; i < PLANE_MAX; i++)
+		c->planes[i] = mem_zalloc(c->height * c->plane_words * sizeof(u64b));
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			square_set_planes(c, y, x);
+
+	c->monsters = mem_zalloc_tag(z_info->level_monster_max *
+								 sizeof(struct monster), MEM_TAG_MONSTER);
 	c->mon_max = 1;
 	c->mon_current = -1;
 
 	c->created_at = turn;
+	mem_tag_set(old_tag);
 	return c;
 }
 
@@ -142,7 +151,7 @@ struct chunk *cave_new(int height, int width) {
  * Free a chunk
  */
 void cave_free(struct chunk *c) {
-	int y, x;
+	int y, x, i;
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
@@ -156,8 +165,13 @@ void cave_free(struct chunk *c) {
 	}
 	mem_free(c->squares);
 
+	for (i = 0; i < PLANE_MAX; i++)
+		mem_free(c->planes[i]);
+
 	mem_free(c->feat_count);
 	mem_free(c->monsters);
+	mem_free(c->traps);
+	mem_free(c->trap_flags);
 	if (c->name)
 		string_free(c->name);
 	mem_free(c);
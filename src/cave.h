@@ -142,6 +142,22 @@ struct square {
 	struct trap *trap;
 };
 
+/**
+ * Terrain properties which each chunk also keeps as bit planes, one bit per
+ * grid and rows packed into words, so they can be tested without looking up
+ * the feature, or a word's worth of grids at a time (see square_plane_row())
+ */
+enum square_plane {
+	PLANE_PROJECT = 0,
+	PLANE_PASSABLE,
+	PLANE_BRIGHT,
+	PLANE_FLOOR,
+
+	PLANE_MAX
+};
+
+#define PLANE_WORD_BITS 64
+
 struct chunk {
 	char *name;
 	s32b created_at;
@@ -163,10 +179,18 @@ struct chunk {
 
 	struct square **squares;
 
+	u64b *planes[PLANE_MAX];
+	int plane_words;	/* Words per row of each plane */
+
 	struct monster *monsters;
 	u16b mon_max;
 	u16b mon_cnt;
 	int mon_current;
+
+	struct trap **traps;	/* Every trap in the chunk, in no order */
+	int trap_num;
+	int trap_alloc;
+	bitflag *trap_flags;	/* Flags of all the traps on each grid */
 };
 
 /*** Feature Indexes (see "lib/edit/terrain.txt") ***/
@@ -207,10 +231,6 @@ int FEAT_DTRAP_WALL;
 
 /* Real cave */
 struct chunk *cave;
-/* Known cave */
-struct chunk *cave_k;
-struct chunk **chunk_list;
-u16b chunk_list_max;
 
 /* cave-view.c */
 int distance(int y1, int x1, int y2, int x2);
@@ -237,6 +257,58 @@ void cave_forget_flow(struct chunk *c);
  */
 typedef bool (*square_predicate)(struct chunk *c, int y, int x);
 
+/* cave-region.c */
+/**
+ * Connected regions of a chunk.  Regions are numbered from 1 in the order
+ * their first grid comes in row order; 0 means no region.
+ */
+struct cave_regions {
+	int height;
+	int width;
+	int *label;			/* region label of each grid, 0 for none */
+	int *parent;		/* union-find forest over the labels */
+	int *size;			/* number of grids in each region, kept at the root */
+	struct loc *first;	/* first grid of each label in row order */
+	int num;			/* number of labels */
+	int live;			/* number of regions with grids left */
+};
+
+struct cave_regions *cave_regions_new(struct chunk *c, square_predicate pred,
+									  bool diagonal);
+void cave_regions_free(struct cave_regions *r);
+int cave_region_find(struct cave_regions *r, int label);
+int cave_region_at(struct cave_regions *r, int y, int x);
+int cave_region_size(struct cave_regions *r, int region);
+int cave_region_join(struct cave_regions *r, int a, int b);
+void cave_region_drop(struct cave_regions *r, int region);
+int cave_region_first(struct cave_regions *r);
+
+/* cave-known.c */
+/**
+ * The player's memory of the map
+ */
+struct known_map {
+	int height;
+	int width;
+	int words;					/* words per row of the known bitset */
+	byte *feat;					/* remembered feature of each grid */
+	u64b *known;				/* bitset of remembered grids */
+};
+
+extern struct known_map *known_map;
+
+struct known_map *known_map_new(int height, int width);
+void known_map_free(struct known_map *k);
+bool known_map_isknown(struct known_map *k, int y, int x);
+int known_map_feat(struct known_map *k, int y, int x);
+void known_map_note_feat(struct known_map *k, int y, int x, int feat);
+void known_map_forget(struct known_map *k, int y, int x);
+void known_map_note_all(struct known_map *k, struct chunk *c);
+
+/* TERRAIN BIT PLANES */
+void square_set_planes(struct chunk *c, int y, int x);
+const u64b *square_plane_row(struct chunk *c, enum square_plane plane, int y);
+
 /* FEATURE PREDICATES */
 bool feat_is_magma(int feat);
 bool feat_is_quartz(int feat);
@@ -368,6 +440,5 @@ int count_feats(int *y, int *x, bool (*test)(struct chunk *cave, int y, int x),
 void cave_generate(struct chunk **c, struct player *p);
 bool is_quest(int level);
 
-void cave_known(void);
 
 #endif /* !CAVE_H */
@@ -223,6 +223,9 @@ void process_command(cmd_context ctx, struct command *cmd)
 	if (game_cmds[idx].fn)
 		game_cmds[idx].fn(cmd);
 
+	/* Anything the player knows may have changed */
+	player->upkeep->version++;
+
 	/* If the command hasn't changed nrepeats, count this execution. */
 	if (cmd->nrepeats > 0 && oldrepeats == cmd_get_nrepeats())
 		cmd_set_repeat(oldrepeats - 1);
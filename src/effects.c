@@ -906,7 +906,8 @@ bool effect_handler_MAP_AREA(effect_handler_context_t *context)
 					/* Memorize walls (etc) */
 					if (square_seemslikewall(cave, yy, xx)) {
 						sqinfo_on(cave->squares[yy][xx].info, SQUARE_MARK);
-						cave_k->squares[yy][xx].feat = cave->squares[yy][xx].feat;
+						known_map_note_feat(known_map, yy, xx,
+											cave->squares[yy][xx].feat);
 						square_light_spot(cave, yy, xx);
 					}
 				}
@@ -925,7 +926,7 @@ bool effect_handler_MAP_AREA(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_TRAPS(effect_handler_context_t *context)
 {
-	int x, y;
+	int x, y, i, num;
 	int x1, x2, y1, y2;
 	int y_dist = context->value.dice;
 	int x_dist = context->value.sides;
@@ -933,6 +934,7 @@ bool effect_handler_DETECT_TRAPS(effect_handler_context_t *context)
 	bool detect = FALSE;
 
 	object_type *obj;
+	struct trap **traps;
 
 	/* Pick an area to detect */
 	y1 = player->py - y_dist;
@@ -946,17 +948,25 @@ bool effect_handler_DETECT_TRAPS(effect_handler_context_t *context)
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
 
+	/* Detect traps, looking only at the traps there are */
+	traps = chunk_traps(cave, &num);
+	for (i = 0; i < num; i++) {
+		y = traps[i]->fy;
+		x = traps[i]->fx;
+		if (y < y1 || y >= y2 || x < x1 || x >= x2) continue;
+		if (!square_in_bounds_fully(cave, y, x)) continue;
+
+		/* Reveal trap */
+		if (square_isplayertrap(cave, y, x))
+			if (square_reveal_trap(cave, y, x, 100, FALSE))
+				detect = TRUE;
+	}
+
 	/* Scan the dungeon */
 	for (y = y1; y < y2; y++) {
 		for (x = x1; x < x2; x++) {
 			if (!square_in_bounds_fully(cave, y, x)) continue;
 
-			/* Detect traps */
-			if (square_isplayertrap(cave, y, x))
-				/* Reveal trap */
-				if (square_reveal_trap(cave, y, x, 100, FALSE))
-					detect = TRUE;
-
 			/* Scan all objects in the grid to look for traps on chests */
 			for (obj = square_object(cave, y, x); obj; obj = obj->next) {
 				/* Skip anything not a trapped chest */
@@ -1051,7 +1061,8 @@ bool effect_handler_DETECT_DOORS(effect_handler_context_t *context)
 			if (square_isdoor(cave, y, x)) {
 				/* Hack -- Memorize */
 				sqinfo_on(cave->squares[y][x].info, SQUARE_MARK);
-				cave_k->squares[y][x].feat = cave->squares[y][x].feat;
+				known_map_note_feat(known_map, y, x,
+									cave->squares[y][x].feat);
 				/* Redraw */
 				square_light_spot(cave, y, x);
 
@@ -1104,7 +1115,8 @@ bool effect_handler_DETECT_STAIRS(effect_handler_context_t *context)
 			if (square_isstairs(cave, y, x)) {
 				/* Hack -- Memorize */
 				sqinfo_on(cave->squares[y][x].info, SQUARE_MARK);
-				cave_k->squares[y][x].feat = cave->squares[y][x].feat;
+				known_map_note_feat(known_map, y, x,
+									cave->squares[y][x].feat);
 				/* Redraw */
 				square_light_spot(cave, y, x);
 
@@ -4331,8 +4343,13 @@ bool effect_do(struct effect *effect, bool *ident, bool aware, int dir, int beam
 			return FALSE;
 		}
 
-		if (effect->dice != NULL)
-			random_choices = dice_roll(effect->dice, &value);
+		/* Only random effects roll here; handlers roll their own values */
+		if (effect->dice != NULL) {
+			if (effect->index == EF_RANDOM)
+				random_choices = dice_roll(effect->dice, &value);
+			else
+				dice_random_value(effect->dice, &value);
+		}
 
 		/* Deal with special random effect */
 		if (effect->index == EF_RANDOM) {
@@ -41,6 +41,16 @@ bool character_generated;	/* The character exists */
 bool character_dungeon;		/* The character has a dungeon */
 bool character_saved;		/* The character was just saved to a savefile */
 
+/**
+ * Called after each command with the microseconds spent in each part of
+ * the game (indexed by "enum turn_timer"); no timing is done while NULL.
+ */
+void (*turn_timer_hook)(const u32b *usecs);
+
+static clock_t timer_start[TIMER_MAX];
+static clock_t timer_total[TIMER_MAX];
+static int timer_depth[TIMER_MAX];
+
 /**
  * This table allows quick conversion from "speed" to "energy"
  * The basic function WAS ((S>=110) ? (S-110) : (100 / (120-S)))
@@ -508,6 +518,47 @@ void process_world(struct chunk *c)
 }
 
 
+/**
+ * Start timing a part of the game; nested calls are only counted once, and
+ * parts are only counted while the game loop itself is being timed.
+ */
+void turn_timer_start(enum turn_timer t)
+{
+	if (!turn_timer_hook) return;
+	if (t != TIMER_TOTAL && !timer_depth[TIMER_TOTAL]) return;
+
+	if (timer_depth[t]++ == 0)
+		timer_start[t] = clock();
+}
+
+/**
+ * Stop timing a part of the game
+ */
+void turn_timer_stop(enum turn_timer t)
+{
+	if (!turn_timer_hook || !timer_depth[t]) return;
+
+	if (--timer_depth[t] == 0)
+		timer_total[t] += clock() - timer_start[t];
+}
+
+/**
+ * Pass the times for the last command on, and start afresh
+ */
+static void turn_timer_report(void)
+{
+	u32b usecs[TIMER_MAX];
+	int i;
+
+	for (i = 0; i < TIMER_MAX; i++) {
+		usecs[i] = (u32b)(timer_total[i] * (1000000.0 / CLOCKS_PER_SEC));
+		timer_total[i] = 0;
+	}
+
+	turn_timer_hook(usecs);
+}
+
+
 /**
  * Housekeeping after the processing of a player command
  */
@@ -716,7 +767,7 @@ static void on_leave_level(void) {
  * This function will run until the player needs to enter a command, or closes
  * the game, or the character dies.
  */
-void run_game_loop(void)
+static void run_game_loop_aux(void)
 {
 	/* Tidy up after the player's command */
 	process_player_cleanup();
@@ -832,3 +883,20 @@ void run_game_loop(void)
 		}
 	}
 }
+
+/**
+ * Run the main game loop, timing it if anyone is interested (see
+ * "turn_timer_hook").
+ */
+void run_game_loop(void)
+{
+	if (!turn_timer_hook) {
+		run_game_loop_aux();
+		return;
+	}
+
+	turn_timer_start(TIMER_TOTAL);
+	run_game_loop_aux();
+	turn_timer_stop(TIMER_TOTAL);
+	turn_timer_report();
+}
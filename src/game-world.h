@@ -30,12 +30,30 @@ bool character_dungeon;
 bool character_saved;
 const byte extract_energy[200];
 
+/**
+ * Parts of the game which are timed for each command (see run_game_loop())
+ */
+enum turn_timer {
+	TIMER_TOTAL = 0,
+	TIMER_VIEW,
+	TIMER_FLOW,
+	TIMER_MONSTERS,
+	TIMER_PROJECT,
+	TIMER_REDRAW,
+
+	TIMER_MAX
+};
+
+extern void (*turn_timer_hook)(const u32b *usecs);
+
 bool is_daytime(void);
 int turn_energy(int speed);
 void play_ambient_sound(void);
 void process_world(struct chunk *c);
 void on_new_level(void);
 void process_player(void);
+void turn_timer_start(enum turn_timer t);
+void turn_timer_stop(enum turn_timer t);
 void run_game_loop(void);
 
 #endif /* !GAME_WORLD_H */
@@ -106,6 +106,8 @@ static void build_streamer(struct chunk *c, int feat, int chance)
     int i, tx, ty;
     int y, x, dir;
 
+    gen_phase_start(GEN_PHASE_STREAMERS);
+
     /* Hack -- Choose starting point */
     y = rand_spread(c->height / 2, 10);
     x = rand_spread(c->width / 2, 15);
@@ -139,6 +141,8 @@ static void build_streamer(struct chunk *c, int feat, int chance)
 		/* Stop at dungeon edge */
 		if (!square_in_bounds(c, y, x)) break;
     }
+
+    gen_phase_stop(GEN_PHASE_STREAMERS);
 }
 
 
@@ -178,6 +182,8 @@ static void build_tunnel(struct chunk *c, int row1, int col1, int row2, int col2
 
     /* Used to prevent excessive door creation along overlapping corridors. */
     bool door_flag = FALSE;
+
+    gen_phase_start(GEN_PHASE_TUNNELS);
 	
     /* Reset the arrays */
     dun->tunn_n = 0;
@@ -349,6 +355,8 @@ static void build_tunnel(struct chunk *c, int row1, int col1, int row2, int col2
 		if (randint0(100) < dun->profile->tun.pen)
 			place_random_door(c, y, x);
     }
+
+    gen_phase_stop(GEN_PHASE_TUNNELS);
 }
 
 /**
@@ -888,115 +896,210 @@ struct chunk *labyrinth_gen(struct player *p) {
 /* ---------------- CAVERNS ---------------------- */
 
 /**
- * Initialize the dungeon array, with a random percentage of squares open.
- * \param c is the current chunk
+ * Caverns are grown on a packed bitboard with one bit per grid (set for
+ * walls), so each pass of the automaton counts neighbours a whole word of
+ * grids at a time.  The chunk itself is only written once, when the final
+ * shape is known.
+ */
+struct cavern_board {
+	int height;
+	int width;
+	int words;		/* words per row */
+	u64b *wall;		/* current generation */
+	u64b *next;		/* generation being built */
+	u64b *solid;	/* walls with more than five wall neighbours */
+	u64b *inner;	/* per-word mask of the columns the automaton may change */
+};
+
+#define CAVERN_BIT(x)	((u64b) 1 << ((x) % 64))
+
+/**
+ * Allocate a cavern board for a chunk of the given size.
+ */
+static struct cavern_board *cavern_board_new(int h, int w)
+{
+	struct cavern_board *b = mem_zalloc(sizeof(*b));
+	int x;
+
+	b->height = h;
+	b->width = w;
+	b->words = (w + 63) / 64;
+	b->wall = mem_zalloc(h * b->words * sizeof(u64b));
+	b->next = mem_zalloc(h * b->words * sizeof(u64b));
+	b->solid = mem_zalloc(h * b->words * sizeof(u64b));
+	b->inner = mem_zalloc(b->words * sizeof(u64b));
+
+	for (x = 1; x < w - 1; x++)
+		b->inner[x / 64] |= CAVERN_BIT(x);
+
+	return b;
+}
+
+/**
+ * Free a cavern board.
+ */
+static void cavern_board_free(struct cavern_board *b)
+{
+	mem_free(b->wall);
+	mem_free(b->next);
+	mem_free(b->solid);
+	mem_free(b->inner);
+	mem_free(b);
+}
+
+/**
+ * Initialize the board, with a random percentage of squares open.
+ * \param b is the cavern board
  * \param density is the percentage of floors we are aiming for
  */
-static void init_cavern(struct chunk *c, int density) {
-    int h = c->height;
-    int w = c->width;
+static void init_cavern(struct cavern_board *b, int density) {
+    int h = b->height;
+    int w = b->width;
     int size = h * w;
+	int i, x;
 	
     int count = (size * density) / 100;
 
-    /* Fill the entire chunk with rock */
-    fill_rectangle(c, 0, 0, h - 1, w - 1, FEAT_GRANITE, SQUARE_WALL_SOLID);
+    /* Fill the entire board with rock */
+	memset(b->solid, 0, h * b->words * sizeof(u64b));
+	memset(b->wall, 0, h * b->words * sizeof(u64b));
+	for (i = 0; i < h; i++)
+		for (x = 0; x < w; x++)
+			b->wall[i * b->words + x / 64] |= CAVERN_BIT(x);
 	
     while (count > 0) {
 		int y = randint1(h - 2);
-		int x = randint1(w - 2);
-		if (square_isrock(c, y, x)) {
-			square_set_feat(c, y, x, FEAT_FLOOR);
+		u64b *word;
+
+		x = randint1(w - 2);
+		word = &b->wall[y * b->words + x / 64];
+		if (*word & CAVERN_BIT(x)) {
+			*word &= ~CAVERN_BIT(x);
 			count--;
 		}
     }
 }
 
 /**
- * Return the number of walls (0-8) adjacent to this square.
- * \param c is the current chunk
- * \param y
- * \param x are the co-ordinates
+ * Add one neighbour bit to each of 64 bit-sliced counters.
+ * \param sum holds the counters, least significant bit plane first
+ * \param bit is the neighbour bit for each counter
  */
-static int count_adj_walls(struct chunk *c, int y, int x) {
-    int yd, xd;
-    int count = 0;
-
-    for (yd = -1; yd <= 1; yd++) {
-		for (xd = -1; xd <= 1; xd++) {
-			if (yd == 0 && xd == 0) continue;
-			if (square_isfloor(c, y + yd, x + xd)) continue;
-			count++;
-		}
-    }
+static void cavern_add(u64b sum[4], u64b bit)
+{
+	int i;
 
-    return count;
+	for (i = 0; i < 3; i++) {
+		u64b carry = sum[i] & bit;
+		sum[i] ^= bit;
+		bit = carry;
+	}
+	sum[3] |= bit;
 }
 
 /**
- * Run a single pass of the cellular automata rules (4,5) on the dungeon.
- * \param c is the chunk being mutated
+ * Run a single pass of the cellular automata rules (4,5) on the board.
+ * \param b is the board being mutated
+ * \param last is whether this is the final pass, so solid walls are noted
  */
-static void mutate_cavern(struct chunk *c) {
-    int y, x;
-    int h = c->height;
-    int w = c->width;
+static void mutate_cavern(struct cavern_board *b, bool last) {
+    int y, i;
+    int h = b->height;
+	int n = b->words;
+	u64b *swap;
 
-    int *temp = mem_zalloc(h * w * sizeof(int));
+	memcpy(b->next, b->wall, h * n * sizeof(u64b));
 
     for (y = 1; y < h - 1; y++) {
-		for (x = 1; x < w - 1; x++) {
-			int count = count_adj_walls(c, y, x);
-			if (count > 5)
-				temp[y * w + x] = FEAT_GRANITE;
-			else if (count < 4)
-				temp[y * w + x] = FEAT_FLOOR;
-			else
-				temp[y * w + x] = c->squares[y][x].feat;
+		for (i = 0; i < n; i++) {
+			u64b sum[4] = { 0, 0, 0, 0 };
+			u64b more_than_five, more_than_three, keep;
+			int r;
+
+			/* Count the walls in the rows above, at and below */
+			for (r = y - 1; r <= y + 1; r++) {
+				const u64b *row = &b->wall[r * n];
+				u64b west = (row[i] << 1) | (i > 0 ? row[i - 1] >> 63 : 0);
+				u64b east = (row[i] >> 1) | (i < n - 1 ? row[i + 1] << 63 : 0);
+
+				cavern_add(sum, west);
+				cavern_add(sum, east);
+				if (r != y) cavern_add(sum, row[i]);
+			}
+
+			/* Over five becomes wall, under four floor, otherwise unchanged */
+			more_than_five = sum[3] | (sum[2] & sum[1]);
+			more_than_three = sum[3] | sum[2];
+			keep = more_than_five | (more_than_three & b->wall[y * n + i]);
+
+			b->next[y * n + i] = (keep & b->inner[i]) |
+				(b->wall[y * n + i] & ~b->inner[i]);
+			if (last)
+				b->solid[y * n + i] = more_than_five & b->inner[i];
 		}
     }
 
-    for (y = 1; y < h - 1; y++) {
-		for (x = 1; x < w - 1; x++) {
-			if (temp[y * w + x] == FEAT_GRANITE)
-				set_marked_granite(c, y, x, SQUARE_WALL_SOLID);
-			else
-				square_set_feat(c, y, x, temp[y * w + x]);
+	swap = b->wall;
+	b->wall = b->next;
+	b->next = swap;
+}
+
+/**
+ * Count the floor grids on the board.
+ */
+static int cavern_floor_count(struct cavern_board *b)
+{
+	int y, i, walls = 0;
+
+	for (y = 1; y < b->height - 1; y++) {
+		for (i = 0; i < b->words; i++) {
+			u64b bits = b->wall[y * b->words + i] & b->inner[i];
+			while (bits) {
+				bits &= bits - 1;
+				walls++;
+			}
 		}
-    }
+	}
 
-    mem_free(temp);
+	return (b->height - 2) * (b->width - 2) - walls;
 }
 
 /**
- * Fill an int[] with a single value.
- * \param data is the array
- * \param value is what it's being filled with
- * \param size is the array length
+ * Write the finished board into the chunk.  Walls that became granite on the
+ * last pass are marked solid; walls left alone by it are unmarked.
+ * \param c is the chunk being built
+ * \param b is the finished board
  */
-static void array_filler(int data[], int value, int size) {
-    int i;
-    for (i = 0; i < size; i++) data[i] = value;
+static void cavern_materialise(struct chunk *c, struct cavern_board *b)
+{
+	int y, x;
+	int h = b->height;
+	int w = b->width;
+
+	fill_rectangle(c, 0, 0, h - 1, w - 1, FEAT_GRANITE, SQUARE_WALL_SOLID);
+
+	for (y = 1; y < h - 1; y++) {
+		for (x = 1; x < w - 1; x++) {
+			int i = y * b->words + x / 64;
+			if (!(b->wall[i] & CAVERN_BIT(x)))
+				square_set_feat(c, y, x, FEAT_FLOOR);
+			else if (!(b->solid[i] & CAVERN_BIT(x)))
+				square_set_feat(c, y, x, FEAT_GRANITE);
+		}
+	}
 }
 
 /**
- * Determine if we need to worry about coloring a point, or can ignore it.
+ * Determine whether a grid belongs to a region we need to connect.
  * \param c is the current chunk
- * \param colors is the array of current point colors
  * \param y
  * \param x are the co-ordinates
  */
-static int ignore_point(struct chunk *c, int colors[], int y, int x) {
-    int h = c->height;
-    int w = c->width;
-    int n = yx_to_i(y, x, w);
-
-    if (y < 0 || x < 0 || y >= h || x >= w) return TRUE;
-    if (colors[n]) return TRUE;
-    //if (square_isvault(c, y, x)) return FALSE;
-    if (square_ispassable(c, y, x)) return FALSE;
-    if (square_isdoor(c, y, x)) return FALSE;
-    return TRUE;
+static bool square_is_region_point(struct chunk *c, int y, int x) {
+    //if (square_isvault(c, y, x)) return TRUE;
+    if (square_ispassable(c, y, x)) return TRUE;
+    if (square_isdoor(c, y, x)) return TRUE;
+    return FALSE;
 }
 
 static int xds[] = {0, 0, 1, -1, -1, -1, 1, 1};
@@ -1012,164 +1115,47 @@ static void glow_point(struct chunk *c, int y, int x) {
 #endif
 
 /**
- * Color a particular point, and all adjacent points.
- * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param y
- * \param x are the co-ordinates
- * \param color is the color we are coloring
- * \param diagonal controls whether we can progress diagonally
- */
-static void build_color_point(struct chunk *c, int colors[], int counts[], int y, int x, int color, bool diagonal) {
-    int h = c->height;
-    int w = c->width;
-    int size = h * w;
-    struct queue *queue = q_new(size);
-
-    int dslimit = diagonal ? 8 : 4;
-
-    int *added = mem_zalloc(size * sizeof(int));
-    array_filler(added, 0, size);
-
-    q_push_int(queue, yx_to_i(y, x, w));
-
-    counts[color] = 0;
-
-    while (q_len(queue) > 0) {
-		int i, y2, x2;
-		int n2 = q_pop_int(queue);
-
-		i_to_yx(n2, w, &y2, &x2);
-
-		if (ignore_point(c, colors, y2, x2)) continue;
-
-		colors[n2] = color;
-		counts[color]++;
-
-		/*if (lit) glow_point(c, y2, x2);*/
-
-		for (i = 0; i < dslimit; i++) {
-			int y3 = y2 + yds[i];
-			int x3 = x2 + xds[i];
-			int n3 = yx_to_i(y3, x3, w);
-			if (ignore_point(c, colors, y3, x3)) continue;
-			if (added[n3]) continue;
-
-			q_push_int(queue, n3);
-			added[n3] = 1;
-		}
-    }
-
-    mem_free(added);
-    q_free(queue);
-}
-
-/**
- * Create a color for each "NESW contiguous" region of the dungeon.
+ * Create a color for each contiguous region of the dungeon.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
  * \param diagonal controls whether we can progress diagonally
  */
-static void build_colors(struct chunk *c, int colors[], int counts[], bool diagonal) {
-    int y, x;
-    int h = c->height;
-    int w = c->width;
-    int color = 1;
-
-    for (y = 0; y < h; y++) {
-		for (x = 0; x < w; x++) {
-			if (ignore_point(c, colors, y, x)) continue;
-			build_color_point(c, colors, counts, y, x, color, diagonal);
-			color++;
-		}
-    }
+static struct cave_regions *build_colors(struct chunk *c, bool diagonal) {
+	return cave_regions_new(c, square_is_region_point, diagonal);
 }
 
 /**
  * Find and delete all small (<9 square) open regions.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the current region map
  */
-static void clear_small_regions(struct chunk *c, int colors[], int counts[]) {
+static void clear_small_regions(struct chunk *c, struct cave_regions *r) {
     int i, y, x;
-    int h = c->height;
-    int w = c->width;
-    int size = h * w;
 
-    int *deleted = mem_zalloc(size * sizeof(int));
-    array_filler(deleted, 0, size);
-
-    for (i = 0; i < size; i++) {
-		if (counts[i] < 9) {
-			deleted[i] = 1;
-			counts[i] = 0;
-		}
-    }
+    for (i = 1; i <= r->num; i++)
+		if (cave_region_size(r, i) < 9)
+			cave_region_drop(r, i);
 
     for (y = 1; y < c->height - 1; y++) {
 		for (x = 1; x < c->width - 1; x++) {
-			i = yx_to_i(y, x, w);
+			i = yx_to_i(y, x, c->width);
 
-			if (!deleted[colors[i]]) continue;
+			if (cave_region_size(r, r->label[i])) continue;
 
-			colors[i] = 0;
+			r->label[i] = 0;
 			set_marked_granite(c, y, x, SQUARE_WALL_SOLID);
 		}
     }
-    mem_free(deleted);
-}
-
-/**
- * Return the number of colors which have active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
- */
-static int count_colors(int counts[], int size) {
-    int i;
-    int num = 0;
-    for (i = 0; i < size; i++) if (counts[i] > 0) num++;
-    return num;
-}
-
-/**
- * Return the first color which has one or more active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
- */
-static int first_color(int counts[], int size) {
-    int i;
-    for (i = 0; i < size; i++) if (counts[i] > 0) return i;
-    return -1;
-}
-
-/**
- * Find all cells of 'fromcolor' and repaint them to 'tocolor'.
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param from is the color to change
- * \param to is the color to change to
- * \param size is the total area
- */
-static void fix_colors(int colors[], int counts[], int from, int to, int size) {
-    int i;
-    for (i = 0; i < size; i++) if (colors[i] == from) colors[i] = to;
-    counts[to] += counts[from];
-    counts[from] = 0;
 }
 
 /**
  * Create a tunnel connecting a region to one of its nearest neighbors.
  * Set new_color = -1 for any neighbour, the required color for a specific one
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the current region map
  * \param color is the color of the region we want to connect
  * \param new_color is the color of the region we want to connect to (if used)
  */
-static void join_region(struct chunk *c, int colors[], int counts[], int color,
+static void join_region(struct chunk *c, struct cave_regions *r, int color,
 	int new_color)
 {
     int i;
@@ -1183,12 +1169,12 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
     /* Allocate an array to keep track of handled squares, and which square
      * we reached them from.
      */
-    int *previous = mem_zalloc(size * sizeof(int));
-    array_filler(previous, -1, size);
+    int *previous = mem_alloc(size * sizeof(int));
+    for (i = 0; i < size; i++) previous[i] = -1;
 
     /* Push all squares of the given color onto the queue */
     for (i = 0; i < size; i++) {
-		if (colors[i] == color) {
+		if (r->label[i] && cave_region_find(r, r->label[i]) == color) {
 			q_push_int(queue, i);
 			previous[i] = i;
 		}
@@ -1198,7 +1184,7 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
     while (q_len(queue) > 0) {
 		/* Get the current square and its color */
 		int n = q_pop_int(queue);
-		int color2 = colors[n];
+		int color2 = cave_region_find(r, r->label[n]);
 
 		/* If we're not looking for a specific color, any new one will do */
 		if ((new_color == -1) && color2 && (color2 != color))
@@ -1207,18 +1193,18 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 		/* See if we've reached a square with a new color */
 		if (color2 == new_color) {
 			/* Step backward through the path, turning stone to tunnel */
-			while (colors[n] != color) {
+			while (cave_region_find(r, r->label[n]) != color) {
 				int x, y;
 				i_to_yx(n, w, &y, &x);
-				colors[n] = color;
+				r->label[n] = color;
 				if (!square_isperm(c, y, x) && !square_isvault(c, y, x)) {
 					square_set_feat(c, y, x, FEAT_FLOOR);
 				}
 				n = previous[n];
 			}
 
-			/* Update the color mapping to combine the two colors */
-			fix_colors(colors, counts, color2, color, size);
+			/* Combine the two colors */
+			cave_region_join(r, color, color2);
 
 			/* We're done now */
 			break;
@@ -1256,21 +1242,17 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 /**
  * Start connecting regions, stopping when the cave is entirely connected.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the current region map
  */
-static void join_regions(struct chunk *c, int colors[], int counts[]) {
-    int h = c->height;
-    int w = c->width;
-    int size = h * w;
-    int num = count_colors(counts, size);
+static void join_regions(struct chunk *c, struct cave_regions *r) {
+    int num = r->live;
 
     /* While we have multiple colors (i.e. disconnected regions), join one of
      * the regions to another one.
      */
     while (num > 1) {
-		int color = first_color(counts, size);
-		join_region(c, colors, counts, color, -1);
+		int color = cave_region_first(r);
+		join_region(c, r, color, -1);
 		num--;
     }
 }
@@ -1284,15 +1266,11 @@ static void join_regions(struct chunk *c, int colors[], int counts[]) {
  * information to join them into one conected region.
  */
 void ensure_connectedness(struct chunk *c) {
-    int size = c->height * c->width;
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
+    struct cave_regions *r = build_colors(c, TRUE);
 
-    build_colors(c, colors, counts, TRUE);
-    join_regions(c, colors, counts);
+    join_regions(c, r);
 
-    mem_free(colors);
-    mem_free(counts);
+    cave_regions_free(r);
 }
 
 
@@ -1312,13 +1290,11 @@ struct chunk *cavern_chunk(int depth, int h, int w)
     int density = rand_range(25, 40);
     int times = rand_range(3, 6);
 
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
+    int tries, floors = 0;
 
-    int tries;
-
-	struct chunk *c = cave_new(h, w);
-	c->depth = depth;
+	struct chunk *c;
+	struct cave_regions *r;
+	struct cavern_board *b = cavern_board_new(h, w);
 
     ROOM_LOG("cavern h=%d w=%d size=%d density=%d times=%d", h, w, size,
 			 density, times);
@@ -1326,30 +1302,34 @@ struct chunk *cavern_chunk(int depth, int h, int w)
 	/* Start trying to build caverns */
 	for (tries = 0; tries < MAX_CAVERN_TRIES; tries++) {
 		/* Build a random cavern and mutate it a number of times */
-		init_cavern(c, density);
-		for (i = 0; i < times; i++) mutate_cavern(c);
+		init_cavern(b, density);
+		for (i = 0; i < times; i++) mutate_cavern(b, i == times - 1);
 
 		/* If there are enough open squares then we're done */
-		if (c->feat_count[FEAT_FLOOR] >= limit) {
-			ROOM_LOG("cavern ok (%d vs %d)", c->feat_count[FEAT_FLOOR], limit);
+		floors = cavern_floor_count(b);
+		if (floors >= limit) {
+			ROOM_LOG("cavern ok (%d vs %d)", floors, limit);
 			break;
 		}
-		ROOM_LOG("cavern failed--try again (%d vs %d)",
-				 c->feat_count[FEAT_FLOOR], limit);
+		ROOM_LOG("cavern failed--try again (%d vs %d)", floors, limit);
 	}
 
 	/* If we couldn't make a big enough cavern then fail */
 	if (tries == MAX_CAVERN_TRIES) {
-		cave_free(c);
+		cavern_board_free(b);
 		return NULL;
 	}
 
-	build_colors(c, colors, counts, FALSE);
-	clear_small_regions(c, colors, counts);
-	join_regions(c, colors, counts);
+	/* Only now build the chunk */
+	c = cave_new(h, w);
+	c->depth = depth;
+	cavern_materialise(c, b);
+	cavern_board_free(b);
 
-    mem_free(colors);
-    mem_free(counts);
+	r = build_colors(c, FALSE);
+	clear_small_regions(c, r);
+	join_regions(c, r);
+	cave_regions_free(r);
 
 	return c;
 }
@@ -2082,32 +2062,24 @@ struct chunk *vault_chunk(struct player *p)
 void connect_caverns(struct chunk *c, struct loc floor[])
 {
 	int i;
-    int size = c->height * c->width;
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
+	struct cave_regions *r;
 	int color_of_floor[4];
 
 	/* Color the regions, find which cavern os which color */
-    build_colors(c, colors, counts, TRUE);
-	for (i = 0; i < 4; i++) {
-		int spot = yx_to_i(floor[i].y, floor[i].x, c->width);
-		color_of_floor[i] = colors[spot];
-	}
+    r = build_colors(c, TRUE);
+	for (i = 0; i < 4; i++)
+		color_of_floor[i] = cave_region_at(r, floor[i].y, floor[i].x);
 
 	/* Join left and upper, right and lower */
-	join_region(c, colors, counts, color_of_floor[0], color_of_floor[1]);
-	join_region(c, colors, counts, color_of_floor[2], color_of_floor[3]);
-
-	/* Redo the colors, join the two big caverns */
-    build_colors(c, colors, counts, TRUE);
-	for (i = 1; i < 3; i++) {
-		int spot = yx_to_i(floor[i].y, floor[i].x, c->width);
-		color_of_floor[i] = colors[spot];
-	}
-	join_region(c, colors, counts, color_of_floor[1], color_of_floor[2]);
+	join_region(c, r, color_of_floor[0], color_of_floor[1]);
+	join_region(c, r, color_of_floor[2], color_of_floor[3]);
+
+	/* Join the two big caverns */
+	for (i = 1; i < 3; i++)
+		color_of_floor[i] = cave_region_at(r, floor[i].y, floor[i].x);
+	join_region(c, r, color_of_floor[1], color_of_floor[2]);
 
-    mem_free(colors);
-    mem_free(counts);
+    cave_regions_free(r);
 }
 /**
  * Generate a hard centre level - a greater vault surrounded by caverns
@@ -18,6 +18,9 @@
  * This file maintains a list of saved chunks of world which can be reloaded
  * at any time.  The intitial example of this is the town, which is saved 
  * immediately after generation and restored when the player returns there.
+ * The list keeps to a memory budget: chunks which have not been used lately
+ * are squeezed into savefile-form snapshots and then written out to disk,
+ * and are rebuilt when they are next asked for.
  *
  * The copying routines are also useful for generating a level in pieces and
  * then copying those pieces into the actual level chunk.
@@ -29,11 +32,41 @@
 #include "init.h"
 #include "mon-make.h"
 #include "obj-util.h"
+#include "player.h"
+#include "savefile.h"
 #include "trap.h"
 
 #define CHUNK_LIST_INCR 10
-struct chunk **chunk_list;     /**< list of pointers to saved chunks */
-u16b chunk_list_max = 0;      /**< current max actual chunk index */
+
+/**
+ * An entry in the chunk list.  Each saved chunk is kept in one of three ways:
+ * as a live chunk, as a snapshot in savefile form, or as a snapshot written
+ * out to a file.  Chunks which have not been used for a while are squeezed
+ * into snapshots, and then sent out to disk, whenever the list goes over its
+ * memory budget; they are brought back to life the next time they are found.
+ */
+struct chunk_entry {
+	char *name;			/**< name of the chunk */
+	u32b hash;			/**< hash of the name, for quick lookup */
+	int depth;			/**< depth of the chunk */
+	struct chunk *chunk;	/**< the live chunk, or NULL */
+	byte *snapshot;		/**< snapshot in savefile form, or NULL */
+	u32b snapshot_size;	/**< length of the snapshot */
+	bool on_disk;		/**< whether the snapshot is in a file */
+	u32b id;			/**< number for the snapshot file name */
+	u32b used;			/**< when the chunk was last used */
+	size_t footprint;	/**< memory held by the chunk or its snapshot */
+};
+
+static struct chunk_entry *chunk_list;	/**< the saved chunks */
+static u16b chunk_list_max = 0;			/**< current number of saved chunks */
+static u32b chunk_list_clock = 0;		/**< ticks for each use of a chunk */
+static u32b chunk_list_next_id = 0;		/**< next snapshot file number */
+
+/**
+ * Memory the chunk list may use before it starts evicting chunks
+ */
+size_t chunk_list_budget = CHUNK_LIST_BUDGET;
 
 /**
  * Write a chunk to memory and return a pointer to it.  Optionally write
@@ -60,6 +93,7 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 		for (x = 0; x < width; x++) {
 			/* Terrain */
 			new->squares[y][x].feat = cave->squares[y0 + y][x0 + x].feat;
+			square_set_planes(new, y, x);
 			sqinfo_copy(new->squares[y][x].info,
 						cave->squares[y0 + y][x0 + x].info);
 
@@ -68,10 +102,12 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 				struct object *obj = square_object(cave, y0 + y, x0 + x);
 				if (obj) {
 					new->squares[y][x].obj = obj;
+					cave->squares[y0 + y][x0 + x].obj = NULL;
 					while (obj) {
 						/* Adjust stuff */
 						obj->iy = y;
 						obj->ix = x;
+						obj = obj->next;
 					}
 				}
 			}
@@ -107,13 +143,17 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 			/* Traps */
 			if (traps) {
 				/* Copy over */
-				struct trap *trap = cave->squares[y][x].trap;
+				struct trap *trap = cave->squares[y0 + y][x0 + x].trap;
+				square_unindex_traps(cave, y0 + y, x0 + x);
 				new->squares[y][x].trap = trap;
-				cave->squares[y][x].trap = NULL;
+				cave->squares[y0 + y][x0 + x].trap = NULL;
 
 				/* Adjust position */
-				trap->fy = y;
-				trap->fx = x;
+				for (; trap; trap = trap->next) {
+					trap->fy = y;
+					trap->fx = x;
+				}
+				square_index_traps(new, y, x);
 			}
 		}
 	}
@@ -122,57 +162,313 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 }
 
 /**
- * Add an entry to the chunk list - any problems with the length of this will
- * be more in the memory used by the chunks themselves rather than the list
- * \param c the chunk being added to the list
+ * Hash a chunk name
+ */
+static u32b chunk_name_hash(const char *name)
+{
+	u32b hash = 5381;
+
+	while (*name)
+		hash = hash * 33 + (byte) *name++;
+
+	return hash;
+}
+
+/**
+ * Estimate the memory used by a live chunk
+ */
+static size_t chunk_footprint(struct chunk *c)
+{
+	size_t size = sizeof(*c) + c->height * sizeof(struct square *);
+	int y, x;
+
+	size += c->height * c->width * (sizeof(struct square) + SQUARE_SIZE);
+	size += PLANE_MAX * c->height * c->plane_words * sizeof(u64b);
+	size += (z_info->f_max + 1) * sizeof(int);
+	size += z_info->level_monster_max * sizeof(struct monster);
+
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++) {
+			struct object *obj;
+			for (obj = square_object(c, y, x); obj; obj = obj->next)
+				size += sizeof(*obj);
+		}
+
+	return size;
+}
+
+/**
+ * Total memory held by the chunk list
+ */
+static size_t chunk_list_footprint(void)
+{
+	size_t size = 0;
+	int i;
+
+	for (i = 0; i < chunk_list_max; i++)
+		size += chunk_list[i].footprint;
+
+	return size;
+}
+
+/**
+ * Name of the file holding the snapshot of a chunk
+ */
+static void chunk_entry_path(struct chunk_entry *entry, char *buf, size_t len)
+{
+	char name[80];
+
+	strnfmt(name, sizeof(name), "%s-level%u.tmp",
+			player_safe_name(player, FALSE), entry->id);
+	path_build(buf, len, ANGBAND_DIR_USER, name);
+}
+
+/**
+ * Squeeze a live chunk into a snapshot.  Monsters in a snapshot are not
+ * counted as alive, just as in a savefile.
+ */
+static void chunk_entry_squeeze(struct chunk_entry *entry)
+{
+	entry->snapshot = savefile_write_chunk(entry->chunk, &entry->snapshot_size);
+	entry->footprint = entry->snapshot_size;
+	cave_free(entry->chunk);
+	entry->chunk = NULL;
+}
+
+/**
+ * Send a snapshot out to disk
+ * \return success
+ */
+static bool chunk_entry_spill(struct chunk_entry *entry)
+{
+	char path[1024];
+	ang_file *f;
+	bool ok;
+
+	chunk_entry_path(entry, path, sizeof(path));
+	f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!f) return FALSE;
+	ok = file_write(f, (char *) entry->snapshot, entry->snapshot_size);
+	file_close(f);
+	if (!ok) {
+		file_delete(path);
+		return FALSE;
+	}
+
+	mem_free(entry->snapshot);
+	entry->snapshot = NULL;
+	entry->on_disk = TRUE;
+	entry->footprint = 0;
+
+	return TRUE;
+}
+
+/**
+ * Read a snapshot back from disk
+ * \return the snapshot, to be freed by the caller, or NULL on failure
+ */
+static byte *chunk_entry_unspill(struct chunk_entry *entry)
+{
+	char path[1024];
+	byte *block = mem_alloc(MAX(entry->snapshot_size, 1));
+	ang_file *f;
+	int read;
+
+	chunk_entry_path(entry, path, sizeof(path));
+	f = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!f) {
+		mem_free(block);
+		return NULL;
+	}
+	read = file_read(f, (char *) block, entry->snapshot_size);
+	file_close(f);
+	if (read != (int) entry->snapshot_size) {
+		mem_free(block);
+		return NULL;
+	}
+
+	return block;
+}
+
+/**
+ * Bring a chunk back to life from its snapshot
+ * \return success
+ */
+static bool chunk_entry_wake(struct chunk_entry *entry)
+{
+	byte *block = entry->on_disk ? chunk_entry_unspill(entry) : entry->snapshot;
+	struct chunk *c;
+	int i;
+
+	if (!block) return FALSE;
+	c = savefile_read_chunk(block, entry->snapshot_size);
+	if (block != entry->snapshot) mem_free(block);
+	if (!c) return FALSE;
+
+	/* Savefiles don't keep the depth */
+	c->depth = entry->depth;
+
+	/* Reading placed the monsters; stored chunks don't count them */
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		mon->race->cur_num--;
+		if (rf_has(mon->race->flags, RF_MULTIPLY)) num_repro--;
+	}
+
+	/* Forget the snapshot */
+	if (entry->on_disk) {
+		char path[1024];
+		chunk_entry_path(entry, path, sizeof(path));
+		file_delete(path);
+		entry->on_disk = FALSE;
+	}
+	mem_free(entry->snapshot);
+	entry->snapshot = NULL;
+
+	entry->chunk = c;
+	entry->footprint = chunk_footprint(c);
+
+	return TRUE;
+}
+
+/**
+ * Free everything held by an entry
+ */
+static void chunk_entry_free(struct chunk_entry *entry)
+{
+	if (entry->on_disk) {
+		char path[1024];
+		chunk_entry_path(entry, path, sizeof(path));
+		file_delete(path);
+	}
+	if (entry->chunk)
+		cave_free(entry->chunk);
+	mem_free(entry->snapshot);
+	string_free(entry->name);
+}
+
+/**
+ * Bring the chunk list back within its budget, evicting the least recently
+ * used chunks first: live chunks become snapshots, and then snapshots go out
+ * to disk.
+ * \param keep an entry which is not to be evicted, or NULL
+ */
+static void chunk_list_trim(struct chunk_entry *keep)
+{
+	while (chunk_list_footprint() > chunk_list_budget) {
+		struct chunk_entry *victim = NULL;
+		int i;
+
+		/* Squeeze the least recently used live chunk */
+		for (i = 0; i < chunk_list_max; i++) {
+			struct chunk_entry *entry = &chunk_list[i];
+			if (entry == keep || !entry->chunk) continue;
+			if (!victim || entry->used < victim->used) victim = entry;
+		}
+		if (victim) {
+			chunk_entry_squeeze(victim);
+			continue;
+		}
+
+		/* Then send the least recently used snapshot to disk */
+		for (i = 0; i < chunk_list_max; i++) {
+			struct chunk_entry *entry = &chunk_list[i];
+			if (entry == keep || !entry->snapshot) continue;
+			if (!victim || entry->used < victim->used) victim = entry;
+		}
+		if (!victim || !chunk_entry_spill(victim))
+			break;
+	}
+}
+
+/**
+ * Find the live chunk for an entry, waking it if need be
+ */
+static struct chunk *chunk_entry_use(struct chunk_entry *entry)
+{
+	if (!entry->chunk && !chunk_entry_wake(entry))
+		return NULL;
+
+	entry->used = ++chunk_list_clock;
+	chunk_list_trim(entry);
+
+	return entry->chunk;
+}
+
+/**
+ * Add an entry to the chunk list - the list keeps its memory use within
+ * chunk_list_budget by evicting chunks which haven't been used recently
+ * \param c the chunk being added to the list, which must have a name
  */
 void chunk_list_add(struct chunk *c)
 {
-	int newsize = (chunk_list_max + CHUNK_LIST_INCR) *	sizeof(struct chunk *);
+	int newsize = (chunk_list_max + CHUNK_LIST_INCR) *
+		sizeof(struct chunk_entry);
+	struct chunk_entry *entry;
 
 	/* Lengthen the list if necessary */
 	if (chunk_list_max == 0)
 		chunk_list = mem_zalloc(newsize);
 	else if ((chunk_list_max % CHUNK_LIST_INCR) == 0)
-		chunk_list = (struct chunk **) mem_realloc(chunk_list, newsize);
+		chunk_list = mem_realloc(chunk_list, newsize);
 
 	/* Add the new one */
-	chunk_list[chunk_list_max++] = c;
+	entry = &chunk_list[chunk_list_max++];
+	memset(entry, 0, sizeof(*entry));
+	entry->name = string_make(c->name);
+	entry->hash = chunk_name_hash(c->name);
+	entry->depth = c->depth;
+	entry->chunk = c;
+	entry->id = chunk_list_next_id++;
+	entry->used = ++chunk_list_clock;
+	entry->footprint = chunk_footprint(c);
+
+	chunk_list_trim(entry);
 }
 
 /**
- * Remove an entry from the chunk list, return whether it was found
+ * Remove an entry from the chunk list and free it, return whether it was found
  * \param name the name of the chunk being removed from the list
  * \return whether it was found; success means it was successfully removed
  */
 bool chunk_list_remove(char *name)
 {
-	int i, j;
-	int newsize = 0;
+	u32b hash = chunk_name_hash(name);
+	int i;
 
 	for (i = 0; i < chunk_list_max; i++) {
 		/* Find the match */
-		if (!strcmp(name, chunk_list[i]->name)) {
-			/* Copy all the succeeding ones back one */
-			for (j = i + 1; j < chunk_list_max; j++)
-				chunk_list[j - 1] = chunk_list[j];
-
-			/* Destroy the last one, and shorten the list */
-			if ((chunk_list_max % CHUNK_LIST_INCR) == 0)
-				newsize = (chunk_list_max - CHUNK_LIST_INCR) *	
-					sizeof(struct chunk *);
-			chunk_list_max--;
-			chunk_list[chunk_list_max] = NULL;
-			if (newsize)
-				chunk_list = (struct chunk **) mem_realloc(chunk_list, newsize);
-
-			return TRUE;
-		}
+		if (chunk_list[i].hash != hash || strcmp(name, chunk_list[i].name))
+			continue;
+
+		chunk_entry_free(&chunk_list[i]);
+
+		/* Copy all the succeeding ones back one */
+		memmove(&chunk_list[i], &chunk_list[i + 1],
+				(chunk_list_max - i - 1) * sizeof(struct chunk_entry));
+		chunk_list_max--;
+
+		return TRUE;
 	}
 
 	return FALSE;
 }
 
+/**
+ * Free the whole chunk list
+ */
+void chunk_list_free(void)
+{
+	int i;
+
+	for (i = 0; i < chunk_list_max; i++)
+		chunk_entry_free(&chunk_list[i]);
+	mem_free(chunk_list);
+	chunk_list = NULL;
+	chunk_list_max = 0;
+}
+
 /**
  * Find a chunk by name
  * \param name the name of the chunk being sought
@@ -180,15 +476,34 @@ bool chunk_list_remove(char *name)
  */
 struct chunk *chunk_find_name(char *name)
 {
+	u32b hash = chunk_name_hash(name);
 	int i;
 
 	for (i = 0; i < chunk_list_max; i++)
-		if (!strcmp(name, chunk_list[i]->name))
-			return chunk_list[i];
+		if (chunk_list[i].hash == hash && !strcmp(name, chunk_list[i].name))
+			return chunk_entry_use(&chunk_list[i]);
 
 	return NULL;
 }
 
+/**
+ * Find the most recently used chunk at a given depth
+ * \param depth the depth of the chunk being sought
+ * \return the pointer to the chunk
+ */
+struct chunk *chunk_find_depth(int depth)
+{
+	struct chunk_entry *found = NULL;
+	int i;
+
+	for (i = 0; i < chunk_list_max; i++)
+		if (chunk_list[i].depth == depth &&
+			(!found || chunk_list[i].used > found->used))
+			found = &chunk_list[i];
+
+	return found ? chunk_entry_use(found) : NULL;
+}
+
 /**
  * Find a chunk by pointer
  * \param c the actual pointer to the sought chunk
@@ -199,11 +514,43 @@ bool chunk_find(struct chunk *c)
 	int i;
 
 	for (i = 0; i < chunk_list_max; i++)
-		if (c == chunk_list[i]) return TRUE;
+		if (c == chunk_list[i].chunk) return TRUE;
 
 	return FALSE;
 }
 
+/**
+ * Number of chunks in the chunk list
+ */
+u16b chunk_list_count(void)
+{
+	return chunk_list_max;
+}
+
+/**
+ * Make a snapshot of a chunk in the chunk list, in savefile form, without
+ * waking it if it is asleep
+ * \param idx the index of the chunk in the list
+ * \param size is set to the length of the snapshot
+ * \return the snapshot, to be freed with mem_free()
+ */
+byte *chunk_list_snapshot(int idx, u32b *size)
+{
+	struct chunk_entry *entry = &chunk_list[idx];
+	byte *block;
+
+	if (entry->chunk)
+		return savefile_write_chunk(entry->chunk, size);
+
+	*size = entry->snapshot_size;
+	if (entry->on_disk)
+		return chunk_entry_unspill(entry);
+
+	block = mem_alloc(MAX(entry->snapshot_size, 1));
+	memcpy(block, entry->snapshot, entry->snapshot_size);
+	return block;
+}
+
 /**
  * Transform y, x coordinates by rotation, reflection and translation
  * Stolen from PosChengband
@@ -274,6 +621,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 
 			/* Terrain */
 			dest->squares[dest_y][dest_x].feat = source->squares[y][x].feat;
+			square_set_planes(dest, dest_y, dest_x);
 			sqinfo_copy(dest->squares[dest_y][dest_x].info,
 						source->squares[y][x].info);
 
@@ -324,7 +672,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 			/* Traps */
 			if (source->squares[y][x].trap) {
 				struct trap *trap = source->squares[y][x].trap;
-				dest->squares[y][x].trap = trap;
+				dest->squares[dest_y][dest_x].trap = trap;
 
 				/* Traverse the trap list */
 				while (trap) {
@@ -333,6 +681,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 					trap->fx = dest_x;
 					trap = trap->next;
 				}
+				square_index_traps(dest, dest_y, dest_x);
 			}
 
 			/* Player */
@@ -734,6 +734,11 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 
 
 
+/**
+ * Times find_space() has failed, for the generation stats
+ */
+static int find_space_failures;
+
 /**
  * Find a good spot for the next room.
  *
@@ -814,6 +819,7 @@ static bool find_space(int *y, int *x, int height, int width)
 	}
 
 	/* Failure. */
+	find_space_failures++;
 	return (FALSE);
 }
 
@@ -2972,12 +2978,15 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 
 	int y, x;
 	int by, bx;
+	int space_failures = find_space_failures;
 
-	/* Enforce the room profile's minimum depth */
-	if (c->depth < profile.level) return FALSE;
-
-	/* Only allow at most two pit/nests room per level */
-	if ((dun->pit_num >= z_info->level_pit_max) && (profile.pit)) return FALSE;
+	/* Enforce the room profile's minimum depth, and allow at most two
+	 * pit/nests room per level */
+	if ((c->depth < profile.level) ||
+		((dun->pit_num >= z_info->level_pit_max) && (profile.pit))) {
+		gen_stats_room(profile.name, ROOM_FAIL_LEVEL);
+		return FALSE;
+	}
 
 	/* Expand the number of blocks if we might overflow */
 	if (profile.height % dun->block_hgt) by2++;
@@ -2986,18 +2995,28 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 	/* Does the profile allocate space, or the room find it? */
 	if (finds_own_space) {
 		/* Try to build a room, pass silly place so room finds its own */
-		if (!profile.builder(c, c->height, c->width))
+		if (!profile.builder(c, c->height, c->width)) {
+			gen_stats_room(profile.name,
+						   find_space_failures > space_failures ?
+						   ROOM_FAIL_SPACE : ROOM_FAIL_BUILD);
 			return FALSE;
+		}
 	} else {
 		/* Never run off the screen */
-		if (by1 < 0 || by2 >= dun->row_blocks) return FALSE;
-		if (bx1 < 0 || bx2 >= dun->col_blocks) return FALSE;
+		if (by1 < 0 || by2 >= dun->row_blocks ||
+			bx1 < 0 || bx2 >= dun->col_blocks) {
+			gen_stats_room(profile.name, ROOM_FAIL_BLOCKS);
+			return FALSE;
+		}
 
 		/* Verify open space */
 		for (by = by1; by <= by2; by++) {
 			for (bx = bx1; bx <= bx2; bx++) {
 				/* previous rooms prevent new ones */
-				if (dun->room_map[by][bx]) return FALSE;
+				if (dun->room_map[by][bx]) {
+					gen_stats_room(profile.name, ROOM_FAIL_BLOCKS);
+					return FALSE;
+				}
 			}
 		}
 
@@ -3006,7 +3025,10 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 		x = ((bx1 + bx2 + 1) * dun->block_wid) / 2;
 
 		/* Try to build a room */
-		if (!profile.builder(c, y, x)) return FALSE;
+		if (!profile.builder(c, y, x)) {
+			gen_stats_room(profile.name, ROOM_FAIL_BUILD);
+			return FALSE;
+		}
 
 		/* Save the room location */
 		if (dun->cent_n < z_info->level_room_max) {
@@ -3027,5 +3049,6 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 	if (profile.pit) dun->pit_num++;
 
 	/* Success */
+	gen_stats_room(profile.name, ROOM_BUILT);
 	return TRUE;
 }
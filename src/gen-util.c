@@ -582,10 +582,12 @@ void alloc_stairs(struct chunk *c, int feat, int num, int walls)
 void alloc_objects(struct chunk *c, int set, int typ, int num, int depth, byte origin)
 {
     int k, l = 0;
+    gen_phase_start(GEN_PHASE_OBJECTS);
     for (k = 0; k < num; k++) {
 		bool ok = alloc_object(c, set, typ, depth, origin);
 		if (!ok) l++;
     }
+    gen_phase_stop(GEN_PHASE_OBJECTS);
 }
 
 
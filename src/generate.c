@@ -809,6 +809,200 @@ const struct cave_profile *choose_profile(int depth)
 	return NULL;
 }
 
+/* ------------------ GENERATION STATISTICS ---------------- */
+
+/**
+ * Whether levels being generated are counted and timed; see gen_stats_dump()
+ */
+bool gen_stats_on;
+
+#define GEN_FAIL_REASONS	16
+
+static struct {
+	u32b attempts;
+	u32b built;
+	u32b failed;
+	clock_t ticks;
+} profile_stats[N_ELEMENTS(cave_builders)];
+
+static u32b room_stats[N_ELEMENTS(room_builders)][ROOM_RESULT_MAX];
+
+static struct {
+	const char *reason;
+	u32b count;
+} fail_stats[GEN_FAIL_REASONS];
+
+static u32b levels_generated;
+static clock_t phase_ticks[GEN_PHASE_MAX];
+static clock_t phase_mark;
+static enum gen_phase phase_stack[GEN_PHASE_MAX * 2];
+static int phase_depth;
+
+/**
+ * Forget all the generation statistics gathered so far
+ */
+void gen_stats_reset(void)
+{
+	memset(profile_stats, 0, sizeof(profile_stats));
+	memset(room_stats, 0, sizeof(room_stats));
+	memset(fail_stats, 0, sizeof(fail_stats));
+	memset(phase_ticks, 0, sizeof(phase_ticks));
+	levels_generated = 0;
+}
+
+/**
+ * Start timing a part of level generation, pausing the part that called it.
+ * Parts are only timed inside cave_generate(), which times the layout.
+ */
+void gen_phase_start(enum gen_phase phase)
+{
+	clock_t now;
+
+	if (!gen_stats_on) return;
+	if (phase != GEN_PHASE_LAYOUT && !phase_depth) return;
+	if (phase_depth == (int) N_ELEMENTS(phase_stack)) return;
+
+	now = clock();
+	if (phase_depth)
+		phase_ticks[phase_stack[phase_depth - 1]] += now - phase_mark;
+	phase_mark = now;
+	phase_stack[phase_depth++] = phase;
+}
+
+/**
+ * Stop timing a part of level generation, resuming the part that called it
+ */
+void gen_phase_stop(enum gen_phase phase)
+{
+	clock_t now;
+
+	if (!gen_stats_on || !phase_depth) return;
+
+	now = clock();
+	phase_ticks[phase_stack[phase_depth - 1]] += now - phase_mark;
+	phase_mark = now;
+
+	/* Unwind to the part being stopped, in case an inner one was left */
+	while (phase_depth && phase_stack[--phase_depth] != phase)
+		;
+}
+
+/**
+ * Count an attempt to build a room of the named type
+ */
+void gen_stats_room(const char *name, enum room_result result)
+{
+	size_t i;
+
+	if (!gen_stats_on) return;
+
+	for (i = 0; i < N_ELEMENTS(room_builders); i++) {
+		if (streq(name, room_builders[i].name)) {
+			room_stats[i][result]++;
+			return;
+		}
+	}
+}
+
+/**
+ * Count an attempt to build a level with a profile
+ * \param profile is the profile used
+ * \param error is why the level was rejected, or NULL if it was kept
+ * \param started is when the attempt began
+ */
+static void gen_stats_attempt(const struct cave_profile *profile,
+							  const char *error, clock_t started)
+{
+	size_t i;
+
+	if (!gen_stats_on) return;
+
+	for (i = 0; i < N_ELEMENTS(cave_builders); i++)
+		if (profile->builder == cave_builders[i].builder) break;
+	if (i == N_ELEMENTS(cave_builders)) return;
+
+	profile_stats[i].attempts++;
+	profile_stats[i].ticks += clock() - started;
+	if (!error) {
+		profile_stats[i].built++;
+		return;
+	}
+	profile_stats[i].failed++;
+
+	/* Reasons are string constants, but compare them properly anyway */
+	for (i = 0; i < GEN_FAIL_REASONS; i++) {
+		if (!fail_stats[i].reason) fail_stats[i].reason = error;
+		if (streq(fail_stats[i].reason, error)) {
+			fail_stats[i].count++;
+			break;
+		}
+	}
+}
+
+/**
+ * Convert clock ticks into milliseconds
+ */
+static double gen_stats_msecs(clock_t ticks)
+{
+	return ticks * (1000.0 / CLOCKS_PER_SEC);
+}
+
+/**
+ * Write out the generation statistics gathered since the last reset
+ */
+void gen_stats_dump(ang_file *f)
+{
+	size_t i;
+	int j;
+	clock_t total = 0;
+	static const char *phase_names[GEN_PHASE_MAX] = {
+		"layout", "tunnels", "streamers", "monsters", "objects"
+	};
+
+	file_putf(f, "Levels generated: %lu\n\n", (unsigned long) levels_generated);
+
+	file_putf(f, "%-20s %9s %9s %9s %11s\n", "Profile", "Attempts", "Built",
+			  "Failed", "Avg ms");
+	for (i = 0; i < N_ELEMENTS(cave_builders); i++) {
+		if (!profile_stats[i].attempts) continue;
+		file_putf(f, "%-20s %9lu %9lu %9lu %11.2f\n", cave_builders[i].name,
+				  (unsigned long) profile_stats[i].attempts,
+				  (unsigned long) profile_stats[i].built,
+				  (unsigned long) profile_stats[i].failed,
+				  gen_stats_msecs(profile_stats[i].ticks) /
+				  profile_stats[i].attempts);
+	}
+
+	for (j = 0; j < GEN_PHASE_MAX; j++)
+		total += phase_ticks[j];
+	file_putf(f, "\n%-20s %11s %9s\n", "Phase", "Total ms", "Share");
+	for (j = 0; j < GEN_PHASE_MAX; j++)
+		file_putf(f, "%-20s %11.1f %8.1f%%\n", phase_names[j],
+				  gen_stats_msecs(phase_ticks[j]),
+				  total ? (100.0 * phase_ticks[j]) / total : 0.0);
+
+	file_putf(f, "\n%-20s %9s %9s %9s %9s %9s %9s\n", "Room", "Tries",
+			  "Built", "Level", "Blocks", "Space", "Builder");
+	for (i = 0; i < N_ELEMENTS(room_builders); i++) {
+		u32b tries = 0;
+
+		for (j = 0; j < ROOM_RESULT_MAX; j++)
+			tries += room_stats[i][j];
+		if (!tries) continue;
+
+		file_putf(f, "%-20s %9lu", room_builders[i].name,
+				  (unsigned long) tries);
+		for (j = 0; j < ROOM_RESULT_MAX; j++)
+			file_putf(f, " %9lu", (unsigned long) room_stats[i][j]);
+		file_putf(f, "\n");
+	}
+
+	file_putf(f, "\n%-40s %9s\n", "Rejected because", "Levels");
+	for (i = 0; i < GEN_FAIL_REASONS && fail_stats[i].reason; i++)
+		file_putf(f, "%-40s %9lu\n", fail_stats[i].reason,
+				  (unsigned long) fail_stats[i].count);
+}
+
 /**
  * Generate a random level.
  *
@@ -826,6 +1020,7 @@ void cave_generate(struct chunk **c, struct player *p) {
 	/* Generate */
 	for (tries = 0; tries < 100 && error; tries++) {
 		struct dun_data dun_body;
+		clock_t started = gen_stats_on ? clock() : 0;
 
 		error = NULL;
 
@@ -841,9 +1036,12 @@ void cave_generate(struct chunk **c, struct player *p) {
 
 		/* Choose a profile and build the level */
 		dun->profile = choose_profile(p->depth);
+		gen_phase_start(GEN_PHASE_LAYOUT);
 		chunk = dun->profile->builder(p);
 		if (!chunk) {
 			error = "Failed to find builder";
+			gen_phase_stop(GEN_PHASE_LAYOUT);
+			gen_stats_attempt(dun->profile, error, started);
 			mem_free(dun->cent);
 			mem_free(dun->door);
 			mem_free(dun->wall);
@@ -854,6 +1052,7 @@ void cave_generate(struct chunk **c, struct player *p) {
 		/* Ensure quest monsters */
 		if (is_quest(chunk->depth)) {
 			int i;
+			gen_phase_start(GEN_PHASE_MONSTERS);
 			for (i = 1; i < z_info->r_max; i++) {
 				monster_race *r_ptr = &r_info[i];
 				int y, x;
@@ -867,6 +1066,7 @@ void cave_generate(struct chunk **c, struct player *p) {
 				find_empty(chunk, &y, &x);
 				place_new_monster(chunk, y, x, r_ptr, TRUE, TRUE, ORIGIN_DROP);
 			}
+			gen_phase_stop(GEN_PHASE_MONSTERS);
 		}
 
 		/* Clear generation flags. */
@@ -884,6 +1084,8 @@ void cave_generate(struct chunk **c, struct player *p) {
 			error = "too many monsters";
 
 		if (error) ROOM_LOG("Generation restarted: %s.", error);
+		gen_phase_stop(GEN_PHASE_LAYOUT);
+		gen_stats_attempt(dun->profile, error, started);
 
 		mem_free(dun->cent);
 		mem_free(dun->door);
@@ -892,6 +1094,7 @@ void cave_generate(struct chunk **c, struct player *p) {
 	}
 
 	if (error) quit_fmt("cave_generate() failed 100 times!");
+	if (gen_stats_on) levels_generated++;
 
 	/* Free the old cave, use the new one */
 	if (*c)
@@ -919,11 +1122,11 @@ void cave_generate(struct chunk **c, struct player *p) {
 	character_dungeon = TRUE;
 
 	/* Free old and allocate new known level */
-	if (cave_k)
-		cave_free(cave_k);
-	cave_k = cave_new(cave->height, cave->width);
+	if (known_map)
+		known_map_free(known_map);
+	known_map = known_map_new(cave->height, cave->width);
 	if (!cave->depth)
-		cave_known();
+		known_map_note_all(known_map, cave);
 
 	(*c)->created_at = turn;
 }
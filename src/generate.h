@@ -35,6 +35,11 @@ enum
 	TYP_GREAT	/*!< Great object */
 };
 
+/**
+ * Memory the chunk list may hold before it starts evicting chunks, in bytes
+ */
+#define CHUNK_LIST_BUDGET	(2 * 1024 * 1024)
+
 /**
  * Monster base for a pit
  */
@@ -241,6 +246,39 @@ struct dun_data *dun;
 struct vault *vaults;
 struct room_template *room_templates;
 
+/**
+ * Parts of level generation timed by the generation statistics; each part
+ * is timed exclusive of any other part it calls
+ */
+enum gen_phase {
+	GEN_PHASE_LAYOUT = 0,	/*!< Rooms, caverns and everything else */
+	GEN_PHASE_TUNNELS,		/*!< Tunnels between rooms */
+	GEN_PHASE_STREAMERS,	/*!< Mineral veins */
+	GEN_PHASE_MONSTERS,		/*!< Random and quest monsters */
+	GEN_PHASE_OBJECTS,		/*!< Random objects, gold, traps and rubble */
+	GEN_PHASE_MAX
+};
+
+/**
+ * Outcomes of an attempt to build a room, for the generation statistics
+ */
+enum room_result {
+	ROOM_BUILT = 0,
+	ROOM_FAIL_LEVEL,	/*!< Too shallow, or too many pits already */
+	ROOM_FAIL_BLOCKS,	/*!< The chosen blocks were off the map or in use */
+	ROOM_FAIL_SPACE,	/*!< find_space() found no room for the room */
+	ROOM_FAIL_BUILD,	/*!< The room builder itself gave up */
+	ROOM_RESULT_MAX
+};
+
+/* generate.c */
+extern bool gen_stats_on;
+void gen_stats_reset(void);
+void gen_phase_start(enum gen_phase phase);
+void gen_phase_stop(enum gen_phase phase);
+void gen_stats_room(const char *name, enum room_result result);
+void gen_stats_dump(ang_file *f);
+
 /* gen-cave.c */
 struct chunk *town_gen(struct player *p);
 struct chunk *classic_gen(struct player *p);
@@ -256,10 +294,15 @@ struct chunk *gauntlet_gen(struct player *p);
 /* gen-chunk.c */
 struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 						 bool objects, bool traps);
+extern size_t chunk_list_budget;
 void chunk_list_add(struct chunk *c);
 bool chunk_list_remove(char *name);
+void chunk_list_free(void);
 struct chunk *chunk_find_name(char *name);
+struct chunk *chunk_find_depth(int depth);
 bool chunk_find(struct chunk *c);
+u16b chunk_list_count(void);
+byte *chunk_list_snapshot(int idx, u32b *size);
 bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 				int rotate, bool reflect);
 
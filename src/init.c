@@ -39,6 +39,7 @@
 #include "mon-util.h"
 #include "monster.h"
 #include "obj-ignore.h"
+#include "obj-info.h"
 #include "obj-list.h"
 #include "obj-make.h"
 #include "obj-randart.h"
@@ -4446,21 +4447,20 @@ void cleanup_angband(void)
 	event_remove_all_handlers();
 
 	/* Free the chunk list */
-	for (i = 0; i < chunk_list_max; i++)
-		cave_free(chunk_list[i]);
-	mem_free(chunk_list);
+	chunk_list_free();
 
 	/* Free the main cave */
 	if (cave)
 		cave_free(cave);
-	if (cave_k)
-		cave_free(cave_k);
+	if (known_map)
+		known_map_free(known_map);
 
 	/* Free the history */
 	history_clear();
 
 	monster_list_finalize();
 	object_list_finalize();
+	object_info_cache_free();
 
 	cleanup_game_constants();
 
@@ -827,13 +827,29 @@ int rd_ignore(void)
 }
 
 
-int rd_misc(void)
+/**
+ * Read the misc block; savefiles before version 2 don't say how their
+ * randarts were made, as they all came from a single RNG stream
+ */
+static int rd_misc_aux(bool has_mode)
 {
 	byte tmp8u;
 	
-	/* Read the randart seed */
+	/* Read the randart seed, and how the artifacts were made from it */
 	rd_u32b(&seed_randart);
-	if (OPT(birth_randarts)) do_randart(seed_randart, TRUE);
+	if (has_mode) {
+		rd_byte(&tmp8u);
+		randart_single_stream = tmp8u ? TRUE : FALSE;
+	} else {
+		randart_single_stream = TRUE;
+	}
+
+	if (OPT(birth_randarts)) {
+		if (randart_single_stream)
+			do_randart_single_stream(seed_randart, TRUE);
+		else
+			do_randart(seed_randart, TRUE);
+	}
 
 	/* Read the flavors seed */
 	rd_u32b(&seed_flavor);
@@ -854,6 +870,16 @@ int rd_misc(void)
 	return 0;
 }
 
+int rd_misc(void)
+{
+	return rd_misc_aux(TRUE);
+}
+
+int rd_misc_1(void)
+{
+	return rd_misc_aux(FALSE);
+}
+
 int rd_player_hp(void)
 {
 	int i;
@@ -1217,6 +1243,13 @@ static int rd_traps_aux(struct chunk *c)
 	}
 
 	mem_free(trap);
+
+	/* Index the traps */
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			if (c->squares[y][x].trap)
+				square_index_traps(c, y, x);
+
     return 0;
 }
 
@@ -1224,6 +1257,8 @@ int rd_dungeon(void)
 {
 	u16b depth;
 	u16b py, px;
+	struct chunk *known;
+	int y, x;
 
 	/* Only if the player's alive */
 	if (player->is_dead)
@@ -1261,9 +1296,18 @@ int rd_dungeon(void)
 	/* The dungeon is ready */
 	character_dungeon = TRUE;
 
-	/* Read known cave */
-	if (rd_dungeon_aux(&cave_k))
+	/* Read the player's map memory, kept as a chunk */
+	if (rd_dungeon_aux(&known))
 		return 1;
+	if (known_map)
+		known_map_free(known_map);
+	known_map = known_map_new(known->height, known->width);
+	for (y = 0; y < known->height; y++)
+		for (x = 0; x < known->width; x++)
+			if (known->squares[y][x].feat != FEAT_NONE)
+				known_map_note_feat(known_map, y, x,
+									known->squares[y][x].feat);
+	cave_free(known);
 
 	return 0;
 }
@@ -1274,11 +1318,19 @@ int rd_dungeon(void)
  */
 int rd_objects(void)
 {
+	struct chunk *known;
+	int result;
+
 	if (rd_objects_aux(rd_item, cave))
 		return -1;
-	if (rd_objects_aux(rd_item, cave_k))
-		return -1;
-	return 0;
+	if (player->is_dead)
+		return 0;
+
+	/* The map memory has no use for these, so read them and drop them */
+	known = cave_new(cave->height, cave->width);
+	result = rd_objects_aux(rd_item, known);
+	cave_free(known);
+	return result ? -1 : 0;
 }
 
 /**
@@ -1286,11 +1338,19 @@ int rd_objects(void)
  */
 int rd_monsters (void)
 {
+	struct chunk *known;
+	int result;
+
 	if (rd_monsters_aux(cave))
 		return -1;
-	if (rd_monsters_aux(cave_k))
-		return -1;
-	return 0;
+	if (player->is_dead)
+		return 0;
+
+	/* The map memory has no use for these, so read them and drop them */
+	known = cave_new(cave->height, cave->width);
+	result = rd_monsters_aux(known);
+	cave_free(known);
+	return result ? -1 : 0;
 }
 
 /**
@@ -1298,13 +1358,74 @@ int rd_monsters (void)
  */
 int rd_traps(void)
 {
+	struct chunk *known;
+	int result;
+
 	if (rd_traps_aux(cave))
 		return -1;
-	if (rd_traps_aux(cave_k))
+	if (player->is_dead)
+		return 0;
+
+	/* The map memory has no use for these, so read them and drop them */
+	known = cave_new(cave->height, cave->width);
+	result = rd_traps_aux(known);
+	cave_free(known);
+	return result ? -1 : 0;
+}
+
+/**
+ * Read a single chunk, as stored in the chunk list
+ */
+int rd_chunk(struct chunk **c)
+{
+	/* Read the dungeon */
+	if (rd_dungeon_aux(c))
+		return -1;
+
+	/* Read the objects */
+	if (rd_objects_aux(rd_item, *c))
+		return -1;
+
+	/* Read the monsters */
+	if (rd_monsters_aux(*c))
 		return -1;
+
+	/* Read traps */
+	if (rd_traps_aux(*c))
+		return -1;
+
 	return 0;
 }
 
+/**
+ * Read a chunk snapshot taken by this game, which uses the sizes of things
+ * in this version rather than those of the savefile
+ */
+int rd_chunk_snapshot(struct chunk **c)
+{
+	byte sizes[] = { square_size, obj_mod_max, of_size, id_size, elem_max,
+					 mflag_size };
+	int result;
+
+	square_size = SQUARE_SIZE;
+	obj_mod_max = OBJ_MOD_MAX;
+	of_size = OF_SIZE;
+	id_size = ID_SIZE;
+	elem_max = ELEM_MAX;
+	mflag_size = MFLAG_SIZE;
+
+	result = rd_chunk(c);
+
+	square_size = sizes[0];
+	obj_mod_max = sizes[1];
+	of_size = sizes[2];
+	id_size = sizes[3];
+	elem_max = sizes[4];
+	mflag_size = sizes[5];
+
+	return result;
+}
+
 /**
  * Read the chunk list
  */
@@ -1320,20 +1441,7 @@ int rd_chunks(void)
 	for (j = 0; j < chunk_max; j++) {
 		struct chunk *c;
 
-		/* Read the dungeon */
-		if (rd_dungeon_aux(&c))
-			return -1;
-
-		/* Read the objects */
-		if (rd_objects_aux(rd_item, c))
-			return -1;
-
-		/* Read the monsters */
-		if (rd_monsters_aux(c))
-			return -1;
-
-		/* Read traps */
-		if (rd_traps_aux(c))
+		if (rd_chunk(&c))
 			return -1;
 
 		chunk_list_add(c);
@@ -796,6 +796,29 @@ static errr Term_wipe_gcu(int x, int y, int n) {
 }
 
 
+#ifdef A_COLOR
+/**
+ * Translate an attribute into a curses mode
+ */
+static int gcu_attr_mode(int a) {
+	/* the lower 7 bits of the attribute indicate the fg/bg */
+	int attr = a & 127;
+	int color = colortable[attr];
+
+	/* the high bit of the attribute indicates a reversed fg/bg */
+	bool reversed = a > 127;
+
+	/* the following check for A_BRIGHT is to avoid #1813 */
+	if (reversed && (color & A_BRIGHT))
+		return (color & ~A_BRIGHT) | A_BLINK | A_REVERSE;
+	else if (reversed)
+		return color | A_REVERSE;
+	else
+		return color | A_NORMAL;
+}
+#endif
+
+
 /**
  * Place some text on the screen using an attribute
  */
@@ -804,23 +827,7 @@ static errr Term_text_gcu(int x, int y, int n, int a, const wchar_t *s) {
 
 #ifdef A_COLOR
 	if (can_use_color) {
-		/* the lower 7 bits of the attribute indicate the fg/bg */
-		int attr = a & 127;
-		int color = colortable[attr];
-
-		/* the high bit of the attribute indicates a reversed fg/bg */
-		bool reversed = a > 127;
-
-		/* the following check for A_BRIGHT is to avoid #1813 */
-		int mode;
-		if (reversed && (color & A_BRIGHT))
-			mode = (color & ~A_BRIGHT) | A_BLINK | A_REVERSE;
-		else if (reversed)
-			mode = color | A_REVERSE;
-		else
-			mode = color | A_NORMAL;
-
-		wattrset(td->win, mode);
+		wattrset(td->win, gcu_attr_mode(a));
 		mvwaddnwstr(td->win, y, x, s, n);
 		wattrset(td->win, A_NORMAL);
 		return 0;
@@ -832,6 +839,47 @@ static errr Term_text_gcu(int x, int y, int n, int a, const wchar_t *s) {
 }
 
 
+/**
+ * Draw a frame's worth of text and blank spaces
+ *
+ * The attribute is only changed when it differs from the last run drawn,
+ * which saves curses (and a slow terminal) a lot of redundant attribute
+ * switching when most of the screen is the same colour.
+ */
+static errr Term_batch_gcu(const struct term_span *spans, int n) {
+	term_data *td = (term_data *)(Term->data);
+	int mode = A_NORMAL;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		const struct term_span *span = &spans[i];
+
+		if (!span->s) {
+			/* Wipes are drawn with the normal attribute */
+			if (mode != A_NORMAL) {
+				mode = A_NORMAL;
+				wattrset(td->win, mode);
+			}
+			Term_wipe_gcu(span->x, span->y, span->n);
+			continue;
+		}
+
+#ifdef A_COLOR
+		if (can_use_color && (gcu_attr_mode(span->a) != mode)) {
+			mode = gcu_attr_mode(span->a);
+			wattrset(td->win, mode);
+		}
+#endif
+
+		mvwaddnwstr(td->win, span->y, span->x, span->s, span->n);
+	}
+
+	if (mode != A_NORMAL) wattrset(td->win, A_NORMAL);
+
+	return 0;
+}
+
+
 /**
  * Create a window for the given "term_data" argument.
  *
@@ -868,6 +916,7 @@ static errr term_data_init_gcu(term_data *td, int rows, int cols, int y, int x)
 	/* Set some more hooks */
 	t->text_hook = Term_text_gcu;
 	t->wipe_hook = Term_wipe_gcu;
+	t->batch_hook = Term_batch_gcu;
 	t->curs_hook = Term_curs_gcu;
 	t->xtra_hook = Term_xtra_gcu;
 
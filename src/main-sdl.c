@@ -154,6 +154,43 @@ char *FontList[MAX_FONTS];
 static int num_fonts = 0;
 
 
+/**
+ * The glyph atlas
+ * Glyphs drawn by sdl_mapFontDraw() are rendered once for each pair of
+ * colours into a cell of one of a few surface pages, then drawn by
+ * blitting the cell. A glyph can live in any of GLYPH_WAYS cells picked by
+ * hashing it, and the least recently used of those is replaced.
+ */
+#define GLYPH_PAGE_COLS		64
+#define GLYPH_PAGE_ROWS		16
+#define GLYPH_PAGE_CELLS	(GLYPH_PAGE_COLS * GLYPH_PAGE_ROWS)
+#define GLYPH_PAGES			4
+#define GLYPH_CELLS			(GLYPH_PAGE_CELLS * GLYPH_PAGES)
+#define GLYPH_WAYS			4
+
+/* Colours whose printable ASCII is rendered as soon as the atlas is made */
+#define GLYPH_WARM_COLOURS	16
+
+typedef struct sdl_Glyph sdl_Glyph;
+struct sdl_Glyph
+{
+	wchar_t ch;					/* The character in this cell */
+	Uint32 fg;					/* Its colours, as 0xRRGGBB */
+	Uint32 bg;
+	Uint32 used;				/* When last drawn; 0 for an empty cell */
+};
+
+typedef struct sdl_GlyphAtlas sdl_GlyphAtlas;
+struct sdl_GlyphAtlas
+{
+	int width;					/* The dimensions of a cell (in pixels) */
+	int height;
+
+	SDL_Surface *pages[GLYPH_PAGES];	/* The rendered glyphs */
+	sdl_Glyph glyphs[GLYPH_CELLS];		/* What is in each cell */
+	Uint32 clock;
+};
+
 /**
  * A font structure
  * Note that the data is only valid for a surface with matching
@@ -174,6 +211,7 @@ struct sdl_Font
 
 	int *data;					/* The data */
 	TTF_Font *sdl_font;			/* The native font */
+	sdl_GlyphAtlas *atlas;		/* Glyphs already rendered */
 };
 
 static sdl_Font SystemFont;
@@ -472,10 +510,12 @@ static errr sdl_CheckFont(const char *fontname, int *width, int *height)
 /**
  * Free any memory assigned by Create()
  */
+static void sdl_AtlasFree(sdl_Font *font);
 static void sdl_FontFree(sdl_Font *font)
 {
 	/* Finished with the font */
 	TTF_CloseFont(font->sdl_font);
+	sdl_AtlasFree(font);
 }
 
 
@@ -507,11 +547,169 @@ static errr sdl_FontCreate(sdl_Font *font, const char *fontname, SDL_Surface *su
 	font->bpp = surface->format->BytesPerPixel;
 	font->sdl_font = ttf_font;
 
+	/* Glyphs rendered for the old surface or font are no use */
+	sdl_AtlasFree(font);
+
 	/* Success */
 	return (0);
 }
 
 
+/**
+ * The glyph atlas routines
+ */
+
+/**
+ * Free the glyph atlas of a font
+ */
+static void sdl_AtlasFree(sdl_Font *font)
+{
+	int i;
+
+	if (!font->atlas) return;
+
+	for (i = 0; i < GLYPH_PAGES; i++)
+		if (font->atlas->pages[i]) SDL_FreeSurface(font->atlas->pages[i]);
+
+	mem_free(font->atlas);
+	font->atlas = NULL;
+}
+
+/**
+ * Make a glyph atlas for a font, in the format of the surface it draws on
+ */
+static sdl_GlyphAtlas *sdl_AtlasNew(sdl_Font *font, SDL_Surface *surface)
+{
+	sdl_GlyphAtlas *atlas = mem_zalloc(sizeof(*atlas));
+	int i;
+
+	atlas->width = font->width;
+	atlas->height = font->height;
+
+	for (i = 0; i < GLYPH_PAGES; i++) {
+		atlas->pages[i] = SDL_CreateRGBSurface(SDL_SWSURFACE,
+											   GLYPH_PAGE_COLS * atlas->width,
+											   GLYPH_PAGE_ROWS * atlas->height,
+											   surface->format->BitsPerPixel,
+											   surface->format->Rmask,
+											   surface->format->Gmask,
+											   surface->format->Bmask,
+											   surface->format->Amask);
+
+		/* Bugger */
+		if (!atlas->pages[i]) {
+			while (i--) SDL_FreeSurface(atlas->pages[i]);
+			mem_free(atlas);
+			return NULL;
+		}
+	}
+
+	return atlas;
+}
+
+/**
+ * Find where a cell of the atlas is
+ */
+static SDL_Surface *sdl_AtlasCell(sdl_GlyphAtlas *atlas, int cell,
+								  SDL_Rect *rc)
+{
+	int n = cell % GLYPH_PAGE_CELLS;
+
+	RECT((n % GLYPH_PAGE_COLS) * atlas->width,
+		 (n / GLYPH_PAGE_COLS) * atlas->height,
+		 atlas->width, atlas->height, rc);
+
+	return atlas->pages[cell / GLYPH_PAGE_CELLS];
+}
+
+/**
+ * Mark a cell as just used
+ */
+static void sdl_AtlasTouch(sdl_GlyphAtlas *atlas, int cell)
+{
+	int i;
+
+	/* On the (rare) wrap of the clock, start again from even footing */
+	if (++atlas->clock == 0) {
+		for (i = 0; i < GLYPH_CELLS; i++)
+			if (atlas->glyphs[i].used) atlas->glyphs[i].used = 1;
+		atlas->clock = 2;
+	}
+
+	atlas->glyphs[cell].used = atlas->clock;
+}
+
+/**
+ * Find a glyph in the atlas, rendering it into a cell first if need be
+ * Returns the cell, or -1 if the glyph can't be rendered.
+ */
+static int sdl_AtlasGlyph(sdl_Font *font, wchar_t ch, SDL_Color fg,
+						  SDL_Color bg)
+{
+	sdl_GlyphAtlas *atlas = font->atlas;
+	Uint32 fg_rgb = (fg.r << 16) | (fg.g << 8) | fg.b;
+	Uint32 bg_rgb = (bg.r << 16) | (bg.g << 8) | bg.b;
+	Uint32 hash = ((Uint32)ch * 2654435761U) ^ (fg_rgb * 40503U) ^ bg_rgb;
+	int set = (hash % (GLYPH_CELLS / GLYPH_WAYS)) * GLYPH_WAYS;
+	int cell = set;
+	int i, len;
+	char mbstr[MB_LEN_MAX + 1];
+	SDL_Surface *page, *text;
+	SDL_Rect rc, dest;
+
+	/* Look in the cells this glyph may use */
+	for (i = set; i < set + GLYPH_WAYS; i++) {
+		sdl_Glyph *glyph = &atlas->glyphs[i];
+
+		if (glyph->used && (glyph->ch == ch) && (glyph->fg == fg_rgb) &&
+			(glyph->bg == bg_rgb)) {
+			sdl_AtlasTouch(atlas, i);
+			return i;
+		}
+
+		if (glyph->used < atlas->glyphs[cell].used) cell = i;
+	}
+
+	/* Render it on its own */
+	len = wctomb(mbstr, ch);
+	if (len <= 0) return -1;
+	mbstr[len] = '\0';
+	text = TTF_RenderUTF8_Shaded(font->sdl_font, mbstr, fg, bg);
+	if (!text) return -1;
+
+	/* Keep it in the least recently used of the cells */
+	page = sdl_AtlasCell(atlas, cell, &rc);
+	SDL_FillRect(page, &rc, SDL_MapRGB(page->format, bg.r, bg.g, bg.b));
+	SDL_SetClipRect(page, &rc);
+	dest = rc;
+	SDL_BlitSurface(text, NULL, page, &dest);
+	SDL_SetClipRect(page, NULL);
+	SDL_FreeSurface(text);
+
+	atlas->glyphs[cell].ch = ch;
+	atlas->glyphs[cell].fg = fg_rgb;
+	atlas->glyphs[cell].bg = bg_rgb;
+	sdl_AtlasTouch(atlas, cell);
+
+	return cell;
+}
+
+/**
+ * Render the printable ASCII characters in the basic colours, which is most
+ * of what a map or a menu is drawn with
+ */
+static void sdl_AtlasWarm(sdl_Font *font)
+{
+	int a;
+	wchar_t ch;
+
+	for (a = 0; a < GLYPH_WARM_COLOURS; a++)
+		for (ch = L' '; ch <= L'~'; ch++)
+			sdl_AtlasGlyph(font, ch, text_colours[a],
+						   text_colours[COLOUR_DARK]);
+}
+
+
 
 
 /**
@@ -519,32 +717,45 @@ static errr sdl_FontCreate(sdl_Font *font, const char *fontname, SDL_Surface *su
  * The surface is first checked to see if it is compatible with
  * this font, if it isn't the the font will be 're-precalculated'
  *
+ * Each glyph is drawn from the font's glyph atlas, so is only rendered the
+ * first time it is drawn in a pair of colours.
+ *
  * You can, I suppose, use one font on many surfaces, but it is
  * definitely not recommended. One font per surface is good enough.
  */
 static errr sdl_mapFontDraw(sdl_Font *font, SDL_Surface *surface,
 							SDL_Color colour, SDL_Color bg, int x, int y,
-							int n , const char *s)
+							int n, const wchar_t *s)
 {
 	Uint8 bpp = surface->format->BytesPerPixel;
 	Uint16 pitch = surface->pitch;
 
-	SDL_Rect rc;
-	SDL_Surface *text;
+	SDL_Rect rc, src;
+	SDL_Surface *page;
+	int i, cell;
 
 	if ((bpp != font->bpp) || (pitch != font->pitch))
 		sdl_FontCreate(font, font->name, surface);
 
+	/* Make the atlas if we need to */
+	if (!font->atlas) {
+		font->atlas = sdl_AtlasNew(font, surface);
+		if (!font->atlas) return (-1);
+		sdl_AtlasWarm(font);
+	}
+
 	/* Lock the window surface (if necessary) */
 	if (SDL_MUSTLOCK(surface))
 		if (SDL_LockSurface(surface) < 0)
 			return (-1);
 
-	RECT(x, y, n * font->width, font->height, &rc);
-	text = TTF_RenderUTF8_Shaded(font->sdl_font, s, colour, bg);
-	if (text) {
-	    SDL_BlitSurface(text, NULL, surface, &rc);
-	    SDL_FreeSurface(text);
+	for (i = 0; i < n; i++) {
+		cell = sdl_AtlasGlyph(font, s[i], colour, bg);
+		if (cell < 0) continue;
+
+		page = sdl_AtlasCell(font->atlas, cell, &src);
+		RECT(x + i * font->width, y, font->width, font->height, &rc);
+		SDL_BlitSurface(page, &src, surface, &rc);
 	}
 
 	/* Unlock the surface */
@@ -972,6 +1183,7 @@ static void term_windowFree(term_window* win)
 }
 
 static errr save_prefs(void);
+static void sdl_TileSheetsFree(void);
 static void hook_quit(const char *str)
 {
 	int i;
@@ -988,6 +1200,7 @@ static void hook_quit(const char *str)
 
 	/* Free the graphics surface */
 	if (GfxSurface) SDL_FreeSurface(GfxSurface);
+	sdl_TileSheetsFree();
 
 	close_graphics_modes();
 	if (GfxButtons) mem_free(GfxButtons);
@@ -2811,9 +3024,6 @@ static errr Term_text_sdl(int col, int row, int n, int a, const wchar_t *s)
 	SDL_Color bg = text_colours[COLOUR_DARK];
 	int x = col * win->tile_wid;
 	int y = row * win->tile_hgt;
-	wchar_t src[255];
-	char mbstr[MB_LEN_MAX * 255];
-	size_t len;
 
 	/* Translate */
 	x += win->border;
@@ -2825,13 +3035,6 @@ static errr Term_text_sdl(int col, int row, int n, int a, const wchar_t *s)
 	/* Clear the way */
 	Term_wipe_sdl(col, row, n);
 
-	/* Take a copy of the incoming string, but truncate it at n chars */
-	wcsncpy(src, s, n);
-	src[n] = L'\0';
-	/* Convert to UTF-8 for display */
-	len = wcstombs(mbstr, src, n * MB_LEN_MAX);
-	mbstr[len] = '\0';
-
 	/* Handle background */
 	switch (a / MAX_COLORS)
 	{
@@ -2849,178 +3052,268 @@ static errr Term_text_sdl(int col, int row, int n, int a, const wchar_t *s)
 	}
 
 	/* Draw it */
-	return (sdl_mapFontDraw(&win->font, win->surface, colour, bg, x, y, n,
-							mbstr));
+	return (sdl_mapFontDraw(&win->font, win->surface, colour, bg, x, y, n, s));
 }
 
 /**
- * Do a 'stretched blit'
- * SDL has no support for stretching... What a bastard!
- * 
+ * The tile sheet cache
+ * Scaling the graphics to a window's tile size is done once for the whole
+ * sheet, and the scaled sheets are shared between windows with the same
+ * tile size. Windows hold a reference to their sheets (SDL surfaces are
+ * reference counted), so freeing them with SDL_FreeSurface() as usual is
+ * fine; the cache holds its own reference, dropped when the graphics change.
  */
-static void sdl_StretchBlit(SDL_Surface *src, SDL_Rect *srcRect, SDL_Surface *dest, SDL_Rect *destRect)
+#define TILE_SHEETS 4
+
+static struct {
+	SDL_Surface *sheet;			/* The scaled sheet, or NULL */
+	int width;					/* The size of its tiles */
+	int height;
+} tile_sheets[TILE_SHEETS];
+static int tile_sheet_next;		/* The entry to replace next */
+
+/**
+ * How the pixels of a row or column of a tile map to the scaled one: each
+ * scaled pixel is a weighted average of 'count' source pixels from 'first',
+ * the weights being how much of the scaled pixel each covers (out of 256).
+ */
+typedef struct sdl_ScaleAxis sdl_ScaleAxis;
+struct sdl_ScaleAxis
 {
-	int x, y;
-	int sx, sy, dx, dy;
-	Uint8 *ps, *pd;
+	int span;					/* The most source pixels a pixel covers */
+	int *first;
+	int *count;
+	int *weight;				/* 'span' weights per scaled pixel */
+};
+
+/**
+ * Work out the weights for scaling src pixels to dst pixels
+ */
+static void sdl_ScaleAxisInit(sdl_ScaleAxis *axis, int src, int dst)
+{
+	int d, s;
+
+	axis->span = src / dst + 2;
+	axis->first = mem_zalloc(dst * sizeof(int));
+	axis->count = mem_zalloc(dst * sizeof(int));
+	axis->weight = mem_zalloc(dst * axis->span * sizeof(int));
+
+	/* Measured in 1/dst of a source pixel, scaled pixel d covers
+	 * [d * src, (d + 1) * src) and source pixel s covers
+	 * [s * dst, (s + 1) * dst) */
+	for (d = 0; d < dst; d++) {
+		int *weight = &axis->weight[d * axis->span];
+		int start = d * src;
+		int end = (d + 1) * src;
+		int total = 0;
+
+		axis->first[d] = start / dst;
+		for (s = axis->first[d]; s * dst < end; s++) {
+			int lo = MAX(start, s * dst);
+			int hi = MIN(end, (s + 1) * dst);
+
+			weight[s - axis->first[d]] = (hi - lo) * 256 / src;
+			total += weight[s - axis->first[d]];
+		}
+		axis->count[d] = s - axis->first[d];
+
+		/* Make the weights add up exactly */
+		weight[axis->count[d] - 1] += 256 - total;
+	}
+}
+
+static void sdl_ScaleAxisFree(sdl_ScaleAxis *axis)
+{
+	mem_free(axis->first);
+	mem_free(axis->count);
+	mem_free(axis->weight);
+}
+
+/**
+ * Scale one tile by averaging the source pixels under each scaled pixel
+ * Colours are weighted by their alpha, so transparent pixels don't darken
+ * the edges of what they surround. Both surfaces are 32 bit.
+ */
+static void sdl_ScaleTile(SDL_Surface *src, SDL_Rect *srcRect,
+						  SDL_Surface *dest, SDL_Rect *destRect,
+						  sdl_ScaleAxis *ax, sdl_ScaleAxis *ay)
+{
+	SDL_PixelFormat *fmt = src->format;
+	int x, y, i, j;
 
 	for (y = 0; y < destRect->h; y++) {
+		int *wy = &ay->weight[y * ay->span];
+		Uint32 *pd = (Uint32 *)((Uint8 *)dest->pixels +
+								(destRect->y + y) * dest->pitch) + destRect->x;
+
 		for (x = 0; x < destRect->w; x++) {
-			/* Actual source coords */
-			sx = (srcRect->w * x / (destRect->w)) + srcRect->x;
-			sy = (srcRect->h * y / (destRect->h)) + srcRect->y;
-			
-			/* Find a source pixel */
-			ps = (Uint8 *)src->pixels + (sx * src->format->BytesPerPixel) +
-				(sy * src->pitch);
-#if 0
-			/* Do we need to draw it? */
-			switch (src->format->BytesPerPixel)
-			{
-				case 1:
-				{
-					if (*ps == src->format->colorkey) continue;
-					break;
-				}
-				case 2:
-				{
-					Uint16 *ps16 = (Uint16*) ps;
-					if (*ps16 == src->format->colorkey) continue;
-					break;
-				}
-				case 3:
-				case 4:
-				{
-					Uint32 *ps32 = (Uint32*) ps;
-					if (*ps32 == src->format->colorkey) continue;
-					break;
+			int *wx = &ax->weight[x * ax->span];
+			u64b r = 0, g = 0, b = 0, a = 0;
+
+			for (j = 0; j < ay->count[y]; j++) {
+				Uint32 *ps = (Uint32 *)((Uint8 *)src->pixels +
+										(srcRect->y + ay->first[y] + j) *
+										src->pitch) +
+					srcRect->x + ax->first[x];
+
+				for (i = 0; i < ax->count[x]; i++) {
+					Uint32 p = ps[i];
+					u64b alpha = fmt->Amask ?
+						(p & fmt->Amask) >> fmt->Ashift : 255;
+					u64b w = (u64b)(wy[j] * wx[i]) * alpha;
+
+					r += w * ((p & fmt->Rmask) >> fmt->Rshift);
+					g += w * ((p & fmt->Gmask) >> fmt->Gshift);
+					b += w * ((p & fmt->Bmask) >> fmt->Bshift);
+					a += w;
 				}
 			}
-#endif
-					
-			/* Actual destination pixel coords */
-			dx = x + destRect->x;
-			dy = y + destRect->y;
-			
-			/* Destination pixel */
-			pd = (Uint8 *)dest->pixels + (dx * dest->format->BytesPerPixel) +
-				(dy * dest->pitch);
-			
-			switch (dest->format->BytesPerPixel)
-			{
-				case 1:
-				{
-					*pd = *ps;
-					break;
-				}
-				case 2:
-				{
-					Uint16 *ps16 = (Uint16*) ps;
-					Uint16 *pd16 = (Uint16*) pd;
-					*pd16 = *ps16;
-					break;
-				}
-				case 3:
-				case 4:
-				{
-					Uint32 *ps32 = (Uint32*) ps;
-					Uint32 *pd32 = (Uint32*) pd;
-					*pd32 = *ps32;
-				}
+
+			/* Wholly transparent */
+			if (!a) {
+				pd[x] = 0;
+				continue;
 			}
-			
+
+			pd[x] = ((Uint32)(r / a) << fmt->Rshift) |
+				((Uint32)(g / a) << fmt->Gshift) |
+				((Uint32)(b / a) << fmt->Bshift) |
+				(((Uint32)(a / (256 * 256)) << fmt->Ashift) & fmt->Amask);
 		}
 	}
-
 }
 
 /**
- * Make the 'pre-stretched' tiles for this window
- * Assumes the tiles surface was freed elsewhere
+ * Make a copy of the graphics with every tile scaled to width x height
  */
-static errr sdl_BuildTileset(term_window *win)
+static SDL_Surface *sdl_ScaleSheet(int width, int height)
 {
-	int x, y;
-	int ta, td;
-	int xx, yy;
-	graphics_mode *info;
+	graphics_mode *info = get_graphics_mode(use_graphics);
+	SDL_Surface *sheet;
+	sdl_ScaleAxis ax, ay;
+	int ta, td, xx, yy;
 
-	if (!GfxSurface) return (1);
-
-	info = get_graphics_mode(use_graphics);
-	if (info->grafID == 0) return (1);
+	/* The scaler works on whole pixels */
+	if (GfxSurface->format->BytesPerPixel != 4) return NULL;
 
 	/* Calculate the number of tiles across & down*/
 	ta = GfxSurface->w / info->cell_width;
 	td = GfxSurface->h / info->cell_height;
 
-	/* Calculate the size of the new surface */
-	x = ta * win->tile_wid * tile_width;
-	y = td * win->tile_hgt * tile_height;
-
 	/* Make it */
-	win->tiles = SDL_CreateRGBSurface(SDL_SWSURFACE, x, y,
-									  GfxSurface->format->BitsPerPixel,
-									  GfxSurface->format->Rmask,
-									  GfxSurface->format->Gmask,
-									  GfxSurface->format->Bmask,
-									  GfxSurface->format->Amask);
+	sheet = SDL_CreateRGBSurface(SDL_SWSURFACE, ta * width, td * height,
+								 GfxSurface->format->BitsPerPixel,
+								 GfxSurface->format->Rmask,
+								 GfxSurface->format->Gmask,
+								 GfxSurface->format->Bmask,
+								 GfxSurface->format->Amask);
 
 	/* Bugger */
-	if (!win->tiles) return (1);
+	if (!sheet) return NULL;
+
+	if (SDL_MUSTLOCK(GfxSurface)) SDL_LockSurface(GfxSurface);
+	if (SDL_MUSTLOCK(sheet)) SDL_LockSurface(sheet);
+
+	/* Every tile scales the same way */
+	sdl_ScaleAxisInit(&ax, info->cell_width, width);
+	sdl_ScaleAxisInit(&ay, info->cell_height, height);
 
 	/* For every tile... */
 	for (xx = 0; xx < ta; xx++) {
 		for (yy = 0; yy < td; yy++) {
 			SDL_Rect src, dest;
-			int dwid = win->tile_wid * tile_width;
-			int dhgt = win->tile_hgt * tile_height;
 
 			/* Source rectangle (on GfxSurface) */
 			RECT(xx * info->cell_width, yy * info->cell_height,
 				 info->cell_width, info->cell_height, &src);
 
-			/* Destination rectangle (win->tiles) */
-			RECT(xx * dwid, yy * dhgt, dwid, dhgt, &dest);
+			/* Destination rectangle (on the sheet) */
+			RECT(xx * width, yy * height, width, height, &dest);
 
-			/* Do the stretch thing */
-			sdl_StretchBlit(GfxSurface, &src, win->tiles, &dest);
+			sdl_ScaleTile(GfxSurface, &src, sheet, &dest, &ax, &ay);
 		}
 	}
 
-	/* see if we need to make a seperate surface for the map view */
-	if (!((tile_width == 1) && (tile_height == 1))) {
-		/* Calculate the size of the new surface */
-		x = ta * win->tile_wid;
-		y = td * win->tile_hgt;
+	sdl_ScaleAxisFree(&ax);
+	sdl_ScaleAxisFree(&ay);
 
-		/* Make it */
-		win->onebyone = SDL_CreateRGBSurface(SDL_SWSURFACE, x, y,
-				GfxSurface->format->BitsPerPixel,
-				GfxSurface->format->Rmask, GfxSurface->format->Gmask,
-				GfxSurface->format->Bmask, GfxSurface->format->Amask);
+	if (SDL_MUSTLOCK(sheet)) SDL_UnlockSurface(sheet);
+	if (SDL_MUSTLOCK(GfxSurface)) SDL_UnlockSurface(GfxSurface);
 
-		/* Bugger */
-		if (!win->onebyone) return (1);
+	return sheet;
+}
+
+/**
+ * Get the graphics scaled to width x height tiles, from the cache if they
+ * have been scaled already; the caller frees the sheet when done with it
+ */
+static SDL_Surface *sdl_TileSheet(int width, int height)
+{
+	SDL_Surface *sheet;
+	int i;
+
+	for (i = 0; i < TILE_SHEETS; i++) {
+		if (tile_sheets[i].sheet && (tile_sheets[i].width == width) &&
+			(tile_sheets[i].height == height)) {
+			tile_sheets[i].sheet->refcount++;
+			return tile_sheets[i].sheet;
+		}
+	}
 
-		/* For every tile... */
-		for (xx = 0; xx < ta; xx++) {
-			for (yy = 0; yy < td; yy++) {
-				SDL_Rect src, dest;
-				int dwid = win->tile_wid;
-				int dhgt = win->tile_hgt;
+	sheet = sdl_ScaleSheet(width, height);
+	if (!sheet) return NULL;
 
-				/* Source rectangle (on GfxSurface) */
-				RECT(xx * info->cell_width, yy * info->cell_height,
-					 info->cell_width, info->cell_height, &src);
+	/* Keep it, in place of the oldest */
+	i = tile_sheet_next;
+	tile_sheet_next = (tile_sheet_next + 1) % TILE_SHEETS;
+	if (tile_sheets[i].sheet) SDL_FreeSurface(tile_sheets[i].sheet);
+	tile_sheets[i].sheet = sheet;
+	tile_sheets[i].width = width;
+	tile_sheets[i].height = height;
 
-				/* Destination rectangle (win->tiles) */
-				RECT(xx * dwid, yy * dhgt, dwid, dhgt, &dest);
+	sheet->refcount++;
+	return sheet;
+}
 
-				/* Do the stretch thing */
-				sdl_StretchBlit(GfxSurface, &src, win->onebyone, &dest);
-			}
-		}
+/**
+ * Forget the scaled sheets, when the graphics change
+ */
+static void sdl_TileSheetsFree(void)
+{
+	int i;
+
+	for (i = 0; i < TILE_SHEETS; i++) {
+		if (tile_sheets[i].sheet) SDL_FreeSurface(tile_sheets[i].sheet);
+		tile_sheets[i].sheet = NULL;
+	}
+	tile_sheet_next = 0;
+}
+
+/**
+ * Get the 'pre-stretched' tiles for this window
+ * Assumes the tiles surface was freed elsewhere
+ */
+static errr sdl_BuildTileset(term_window *win)
+{
+	graphics_mode *info;
+
+	if (!GfxSurface) return (1);
+
+	info = get_graphics_mode(use_graphics);
+	if (info->grafID == 0) return (1);
+
+	win->tiles = sdl_TileSheet(win->tile_wid * tile_width,
+							   win->tile_hgt * tile_height);
+
+	/* Bugger */
+	if (!win->tiles) return (1);
+
+	/* see if we need to make a seperate surface for the map view */
+	if (!((tile_width == 1) && (tile_height == 1))) {
+		win->onebyone = sdl_TileSheet(win->tile_wid, win->tile_hgt);
+
+		/* Bugger */
+		if (!win->onebyone) return (1);
 	}
 
 	return (0);
@@ -3040,8 +3333,6 @@ static errr Term_pict_sdl(int col, int row, int n, const int *ap,
 
 	SDL_Rect rc, src;
 	int i, j;
-	char mbforeground[MB_LEN_MAX * 255];
-	char mbterrain[MB_LEN_MAX * 255];
 
 	/* First time a pict is requested we load the tileset in */
 	if (!win->tiles) {
@@ -3070,9 +3361,6 @@ static errr Term_pict_sdl(int col, int row, int n, const int *ap,
 		for (j = 0; j < tile_height; j++)
 			Term_wipe_sdl(col + i, row + j, n);
 
-	wcstombs(mbforeground, cp, n * MB_LEN_MAX);
-	wcstombs(mbterrain, tcp, n * MB_LEN_MAX);
-
 	/* Blit 'em! (it) */
 	for (i = 0; i < n; i++) {
 		/* Get the terrain tile */
@@ -3315,8 +3603,10 @@ static errr load_gfx(void)
 		filename = NULL;
 	}
 
-	/* Free the old surface */
+	/* Free the old surface, and anything scaled from it */
 	if (GfxSurface) SDL_FreeSurface(GfxSurface);
+	GfxSurface = NULL;
+	sdl_TileSheetsFree();
 
 	/* This may be called when GRAPHICS_NONE is set */
 	if (!filename) return (0);
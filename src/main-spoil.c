@@ -0,0 +1,165 @@
+/**
+ * \file main-spoil.c
+ * \brief Pseudo-UI for writing spoiler files without playing
+ *
+ * Copyright (c) 2014 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+
+#ifdef USE_SPOIL
+
+#include "init.h"
+#include "main.h"
+#include "player.h"
+#include "player-birth.h"
+#include "wizard.h"
+
+static const char *spoil_name = "spoilers";
+static int spoil_formats = SPOIL_TEXT | SPOIL_CSV | SPOIL_JSON;
+static bool spoil_classic = FALSE;
+static bool spoiled = FALSE;
+
+/**
+ * Write the requested spoilers and leave
+ */
+static errr run_spoilers(void)
+{
+	bool ok = TRUE;
+
+	/* Object descriptions and powers are worked out for a plain player */
+	player_init(player);
+	player_generate(player, races, classes);
+	player_embody(player);
+
+	if (spoil_formats)
+		ok = spoil_data(spoil_name, spoil_formats);
+	if (spoil_classic)
+		spoil_text();
+
+	cleanup_angband();
+
+	/* quit() only gives a failing exit status along with a message */
+	quit(ok ? NULL : "Cannot write the spoiler files.");
+	return 0;
+}
+
+typedef struct term_data term_data;
+struct term_data {
+	term t;
+};
+
+static term_data td;
+
+static void term_init_spoil(term *t) {
+	return;
+}
+
+static void term_nuke_spoil(term *t) {
+	return;
+}
+
+static errr term_xtra_spoil(int n, int v) {
+	/* The first wait for input comes once the game data is loaded */
+	if (n == TERM_XTRA_EVENT && !spoiled) {
+		spoiled = TRUE;
+		return run_spoilers();
+	}
+
+	return 0;
+}
+
+static errr term_curs_spoil(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_spoil(int x, int y, int n) {
+	return 0;
+}
+
+static errr term_text_spoil(int x, int y, int n, int a, const wchar_t *s) {
+	return 0;
+}
+
+static void term_data_link(int i) {
+	term *t = &td.t;
+
+	term_init(t, 80, 24, 256);
+
+	/* Ignore some actions for efficiency and safety */
+	t->never_bored = TRUE;
+	t->never_frosh = TRUE;
+
+	t->init_hook = term_init_spoil;
+	t->nuke_hook = term_nuke_spoil;
+
+	t->xtra_hook = term_xtra_spoil;
+	t->curs_hook = term_curs_spoil;
+	t->wipe_hook = term_wipe_spoil;
+	t->text_hook = term_text_spoil;
+
+	t->data = &td;
+
+	Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+const char help_spoil[] = "Spoiler mode, subopts -o<name> -f<formats: t,c,j> -s(poiler text files)";
+
+/**
+ * Usage:
+ *
+ * angband -mspoil -- [-o<name>] [-f<formats>] [-s]
+ *
+ *   -o<name>     Base name for the data files (default: spoilers)
+ *   -f<formats>  Any of t(ext), c(sv) and j(son lines); an empty list
+ *                writes no data files (default: tcj)
+ *   -s           Also write the text spoiler (.spo) files
+ *
+ * All files are written to the user directory (see -duser=<path>).
+ */
+errr init_spoil(int argc, char *argv[]) {
+	int i;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (prefix(argv[i], "-o") && argv[i][2]) {
+			spoil_name = &argv[i][2];
+			continue;
+		}
+		if (prefix(argv[i], "-f")) {
+			const char *f;
+
+			spoil_formats = 0;
+			for (f = &argv[i][2]; *f; f++) {
+				if (*f == 't') spoil_formats |= SPOIL_TEXT;
+				else if (*f == 'c') spoil_formats |= SPOIL_CSV;
+				else if (*f == 'j') spoil_formats |= SPOIL_JSON;
+				else printf("init-spoil: bad format '%c'\n", *f);
+			}
+			continue;
+		}
+		if (streq(argv[i], "-s")) {
+			spoil_classic = TRUE;
+			continue;
+		}
+		printf("init-spoil: bad argument '%s'\n", argv[i]);
+	}
+
+	term_data_link(0);
+	return 0;
+}
+
+#endif /* USE_SPOIL */
@@ -22,6 +22,7 @@
 
 #include "buildid.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "main.h"
 #include "mon-make.h"
@@ -1487,6 +1488,64 @@ static void stats_cleanup_angband_run(void)
 	if (player->history) mem_free(player->history);
 }
 
+/**
+ * Write the level generation statistics next to the database
+ */
+static void stats_write_gen_stats(void)
+{
+	char buf[1024];
+	ang_file *f;
+
+	path_build(buf, sizeof(buf), ANGBAND_DIR_STATS, "generation.txt");
+	f = file_open(buf, MODE_WRITE, FTYPE_TEXT);
+	if (!f) {
+		printf("Couldn't write %s.\n", buf);
+		return;
+	}
+
+	gen_stats_dump(f);
+	file_close(f);
+	gen_stats_on = FALSE;
+}
+
+/**
+ * Add the memory use of each subsystem after a number of runs to the
+ * memory log next to the database; run 0 starts a new log.
+ */
+static void stats_write_mem_stats(u32b run)
+{
+	char buf[1024];
+	ang_file *f;
+	int i;
+
+	path_build(buf, sizeof(buf), ANGBAND_DIR_STATS, "memory.txt");
+	f = file_open(buf, run ? MODE_APPEND : MODE_WRITE, FTYPE_TEXT);
+	if (!f) {
+		printf("Couldn't write %s.\n", buf);
+		return;
+	}
+
+	file_putf(f, "After %d runs:\n", run);
+	for (i = 0; i <= MEM_TAG_MAX; i++) {
+		const struct mem_stats *stats = mem_tag_stats(i);
+		int j;
+
+		file_putf(f, "  %-10s live %10lu peak %10lu blocks %8lu allocs %10lu"
+				  " frees %10lu\n", mem_tag_name(i),
+				  (unsigned long) stats->live, (unsigned long) stats->peak,
+				  (unsigned long) stats->blocks,
+				  (unsigned long) stats->allocs,
+				  (unsigned long) stats->frees);
+
+		/* Size histogram, by powers of two from 16 bytes */
+		file_putf(f, "  %-10s sizes", "");
+		for (j = 0; j < MEM_SIZE_CLASSES; j++)
+			file_putf(f, " %lu", (unsigned long) stats->sizes[j]);
+		file_putf(f, "\n");
+	}
+	file_close(f);
+}
+
 static errr run_stats(void)
 {
 	u32b run;
@@ -1518,6 +1577,14 @@ static errr run_stats(void)
 		fflush(stdout);
 	}
 
+	/* Count and time level generation throughout */
+	gen_stats_reset();
+	gen_stats_on = TRUE;
+
+	/* Account memory by subsystem from here on */
+	mem_flags |= MEM_ACCOUNT;
+	stats_write_mem_stats(0);
+
 	start = time(NULL);
 	for (run = 1; run <= num_runs; run++) {
 		if (!quiet) progress_bar(run - 1, start);
@@ -1540,6 +1607,7 @@ static errr run_stats(void)
 				quit_fmt("Problems writing to database!  sqlite3 errno %d.",
 						 err);
 			}
+			stats_write_mem_stats(run);
 		}
 
 		if (quiet && run % 1000 == 0) {
@@ -1558,6 +1626,9 @@ static errr run_stats(void)
 	stats_db_close();
 	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
 
+	stats_write_gen_stats();
+	stats_write_mem_stats(run - 1);
+
 	if (randarts)
 		mem_free(a_info_save);
 	free_stats_memory();
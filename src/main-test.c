@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "buildid.h"
+#include "game-world.h"
 #include "main.h"
 #include "player.h"
 #include "player-birth.h"
@@ -28,6 +29,23 @@ static int prompt = 0;
 static int verbose = 0;
 static int nextkey = 0;
 
+/**
+ * Keys queued up by "keys" commands, fed to the game one at a time
+ */
+static struct keypress script_keys[1024];
+static int script_pos = 0;
+
+/**
+ * Per-command timings collected while profiling, one array per timer
+ */
+static u32b *samples[TIMER_MAX];
+static size_t num_samples = 0;
+static size_t max_samples = 0;
+
+static const char *timer_names[TIMER_MAX] = {
+	"total", "view", "flow", "monsters", "project", "redraw"
+};
+
 static void c_key(char *rest) {
 	if (!strcmp(rest, "left")) {
 		nextkey = ARROW_LEFT;
@@ -48,6 +66,19 @@ static void c_key(char *rest) {
 	}
 }
 
+static void c_keys(char *rest) {
+	int len = 0;
+
+	if (!rest) return;
+
+	/* Append to whatever is still pending */
+	while (script_keys[script_pos + len].code) len++;
+	memmove(script_keys, script_keys + script_pos, len * sizeof(*script_keys));
+	script_pos = 0;
+	keypress_from_text(script_keys + len, N_ELEMENTS(script_keys) - len - 1,
+					   rest);
+}
+
 static void c_noop(char *rest) {
 
 }
@@ -70,6 +101,90 @@ static void c_version(char *rest) {
 	printf("cmd-version: %s %s\n", VERSION_NAME, VERSION_STRING);
 }
 
+static void c_seed(char *rest) {
+	u32b seed = rest ? strtoul(rest, NULL, 0) : 0;
+
+	Rand_state_init(seed);
+	printf("cmd-seed: %lu\n", (unsigned long)seed);
+}
+
+/**
+ * Profiling commands
+ */
+static void profile_turn(const u32b *usecs) {
+	int i;
+
+	if (num_samples == max_samples) {
+		max_samples = max_samples ? 2 * max_samples : 1024;
+		for (i = 0; i < TIMER_MAX; i++)
+			samples[i] = mem_realloc(samples[i],
+									 max_samples * sizeof(**samples));
+	}
+
+	for (i = 0; i < TIMER_MAX; i++)
+		samples[i][num_samples] = usecs[i];
+	num_samples++;
+}
+
+static void c_profile(char *rest) {
+	int i;
+
+	for (i = 0; i < TIMER_MAX; i++)
+		mem_free(samples[i]);
+	memset(samples, 0, sizeof(samples));
+	num_samples = max_samples = 0;
+
+	if (rest && !strcmp(rest, "0")) {
+		printf("cmd-profile: off\n");
+		turn_timer_hook = NULL;
+	} else {
+		printf("cmd-profile: on\n");
+		turn_timer_hook = profile_turn;
+	}
+}
+
+static int cmp_u32b(const void *a, const void *b) {
+	u32b x = *(const u32b *)a;
+	u32b y = *(const u32b *)b;
+
+	return (x > y) - (x < y);
+}
+
+static u32b percentile(const u32b *sorted, int pct) {
+	return sorted[(num_samples - 1) * pct / 100];
+}
+
+static void c_profile_report(char *rest) {
+	int i;
+
+	printf("profile: %lu commands, times in usec\n",
+		   (unsigned long)num_samples);
+	if (!num_samples) return;
+
+	printf("profile: %-9s %10s %8s %8s %8s %8s %8s\n", "part", "sum",
+		   "mean", "p50", "p90", "p99", "max");
+	for (i = 0; i < TIMER_MAX; i++) {
+		u32b *sorted = mem_alloc(num_samples * sizeof(*sorted));
+		u64b sum = 0;
+		size_t j;
+
+		for (j = 0; j < num_samples; j++)
+			sum += samples[i][j];
+		memcpy(sorted, samples[i], num_samples * sizeof(*sorted));
+		sort(sorted, num_samples, sizeof(*sorted), cmp_u32b);
+
+		printf("profile: %-9s %10lu %8lu %8lu %8lu %8lu %8lu\n",
+			   timer_names[i], (unsigned long)sum,
+			   (unsigned long)(sum / num_samples),
+			   (unsigned long)percentile(sorted, 50),
+			   (unsigned long)percentile(sorted, 90),
+			   (unsigned long)percentile(sorted, 99),
+			   (unsigned long)sorted[num_samples - 1]);
+
+		mem_free(sorted);
+	}
+}
+
 /**
  * Player commands
  */
@@ -110,6 +225,30 @@ static void c_player_race(char *rest) {
 	printf("player-race: %s\n", player->race->name);
 }
 
+/**
+ * Commands are read one per line from stdin whenever the game waits for
+ * a key.  Besides the basic ones, these allow a recorded session to be
+ * replayed as a benchmark:
+ *
+ *   seed <n>          Reseed the RNG, so the replay is repeatable
+ *   keys <text>       Queue keys in keymap syntax, e.g. "R[Enter]" or "^A";
+ *                     they are fed to the game before more commands are read
+ *   profile [0]       Start (or stop) timing each command given to the game
+ *   profile-report    Print latency percentiles for the commands so far, in
+ *                     total and for each timed part of the game
+ *
+ * For example, "angband -mtest -n < replay.txt" with replay.txt holding
+ *
+ *   seed 42
+ *   keys xaaa[Enter][Enter]y[Enter]
+ *   profile
+ *   keys 2222266664444888
+ *   profile-report
+ *   quit
+ *
+ * makes a human warrior (if there is no savefile to base one on), takes
+ * sixteen steps in town and reports the cost.
+ */
 typedef struct {
 	const char *name;
 	void (*func)(char *args);
@@ -118,11 +257,16 @@ typedef struct {
 static test_cmd cmds[] = {
 	{ "#", c_noop },
 	{ "key", c_key },
+	{ "keys", c_keys },
 	{ "noop", c_noop },
 	{ "quit", c_quit },
+	{ "seed", c_seed },
 	{ "verbose", c_verbose },
 	{ "version?", c_version },
 
+	{ "profile", c_profile },
+	{ "profile-report", c_profile_report },
+
 	{ "player-birth", c_player_birth },
 	{ "player-class?", c_player_class },
 	{ "player-race?", c_player_race },
@@ -214,6 +358,15 @@ static errr term_xtra_event(int v) {
 		Term_keypress(nextkey, 0);
 		nextkey = 0;
 	}
+
+	/* Only feed scripted keys, or read more commands, when the game waits */
+	if (!v) return 0;
+
+	if (script_keys[script_pos].code) {
+		struct keypress *k = &script_keys[script_pos++];
+		return Term_keypress(k->code, k->mods);
+	}
+
 	return test_docmd();
 }
 
@@ -1430,12 +1430,43 @@ static errr Infofnt_init_data(const char *name)
 }
 
 
+/**
+ * Draw text at a pixel location, over a background which is already erased
+ */
+static void Infofnt_text_draw(int x, int y, const wchar_t *str, int len)
+{
+	int i;
+
+	term_data *td = (term_data*)(Term->data);
+
+	/*** Actually draw 'str' onto the infowin ***/
+	y += Infofnt->asc;
+
+
+	/*** Handle the fake mono we can enforce on fonts ***/
+
+	/* Monotize the font */
+	if (Infofnt->mono) {
+		/* Do each character */
+		for (i = 0; i < len; ++i) {
+			/* Note that the Infoclr is set up to contain the Infofnt */
+			XwcDrawImageString(Metadpy->dpy, Infowin->win, Infofnt->fs,
+							   Infoclr->gc, x + i * td->tile_wid + Infofnt->off,
+							   y, str + i, 1);
+		}
+	} else {
+		/* Note that the Infoclr is set up to contain the Infofnt */
+		XwcDrawImageString(Metadpy->dpy, Infowin->win, Infofnt->fs, Infoclr->gc,
+		                 x, y, str, len);
+	}
+}
+
+
 /**
  * Standard Text
  */
 static errr Infofnt_text_std(int x, int y, const wchar_t *str, int len)
 {
-	int i;
 	int w, h;
 
 	term_data *td = (term_data*)(Term->data);
@@ -1472,26 +1503,8 @@ static errr Infofnt_text_std(int x, int y, const wchar_t *str, int len)
 				   x, y, w, h);
 
 
-	/*** Actually draw 'str' onto the infowin ***/
-	y += Infofnt->asc;
-
-
-	/*** Handle the fake mono we can enforce on fonts ***/
-
-	/* Monotize the font */
-	if (Infofnt->mono) {
-		/* Do each character */
-		for (i = 0; i < len; ++i) {
-			/* Note that the Infoclr is set up to contain the Infofnt */
-			XwcDrawImageString(Metadpy->dpy, Infowin->win, Infofnt->fs,
-							   Infoclr->gc, x + i * td->tile_wid + Infofnt->off,
-							   y, str + i, 1);
-		}
-	} else {
-		/* Note that the Infoclr is set up to contain the Infofnt */
-		XwcDrawImageString(Metadpy->dpy, Infowin->win, Infofnt->fs, Infoclr->gc,
-		                 x, y, str, len);
-	}
+	/*** Draw the text ***/
+	Infofnt_text_draw(x, y, str, len);
 
 	/* Success */
 	return (0);
@@ -2075,6 +2088,44 @@ static errr Term_text_x11(int x, int y, int n, int a, const wchar_t *s)
 }
 
 
+/**
+ * Draw a frame's worth of text and blank spaces.
+ *
+ * The background of every run, wiped or not, is erased with a single
+ * request, and then the text is drawn over it; this roughly halves the
+ * number of requests sent to the X server for a typical redraw.
+ */
+static errr Term_batch_x11(const struct term_span *spans, int n)
+{
+	term_data *td = (term_data*)(Term->data);
+	XRectangle *rects = mem_alloc(n * sizeof(*rects));
+	int i;
+
+	/* Erase the background of every run */
+	for (i = 0; i < n; i++) {
+		rects[i].x = spans[i].x * td->tile_wid + Infowin->ox;
+		rects[i].y = spans[i].y * td->tile_hgt + Infowin->oy;
+		rects[i].width = spans[i].n * td->tile_wid;
+		rects[i].height = td->tile_hgt;
+	}
+	XFillRectangles(Metadpy->dpy, Infowin->win, clr[COLOUR_DARK]->gc, rects,
+					n);
+
+	/* Draw the text */
+	for (i = 0; i < n; i++) {
+		if (!spans[i].s) continue;
+
+		Infoclr_set(clr[spans[i].a]);
+		Infofnt_text_draw(rects[i].x, rects[i].y, spans[i].s, spans[i].n);
+	}
+
+	mem_free(rects);
+
+	/* Success */
+	return (0);
+}
+
+
 
 
 static void save_prefs(void)
@@ -2477,6 +2528,7 @@ static errr term_data_init(term_data *td, int i)
 	t->bigcurs_hook = Term_bigcurs_x11;
 	t->wipe_hook = Term_wipe_x11;
 	t->text_hook = Term_text_x11;
+	t->batch_hook = Term_batch_x11;
 
 	/* Save the data */
 	t->data = td;
@@ -67,6 +67,10 @@ static const struct module modules[] =
 #ifdef USE_STATS
 	{ "stats", help_stats, init_stats },
 #endif /* USE_STATS */
+
+#ifdef USE_SPOIL
+	{ "spoil", help_spoil, init_spoil },
+#endif /* USE_SPOIL */
 };
 
 static int init_sound_dummy(int argc, char *argv[]) {
@@ -122,30 +122,39 @@ static void remove_bad_spells(struct monster *m_ptr, bitflag f[RSF_SIZE])
 }
 
 
+/**
+ * Offsets of the grids within distance 2, in the order they are checked
+ */
+static const struct loc summon_offsets[] = {
+	{ -1, -2 }, { 0, -2 }, { 1, -2 },
+	{ -2, -1 }, { -1, -1 }, { 0, -1 }, { 1, -1 }, { 2, -1 },
+	{ -2, 0 }, { -1, 0 }, { 0, 0 }, { 1, 0 }, { 2, 0 },
+	{ -2, 1 }, { -1, 1 }, { 0, 1 }, { 1, 1 }, { 2, 1 },
+	{ -1, 2 }, { 0, 2 }, { 1, 2 }
+};
+
 /**
  * Determine if there is a space near the selected spot in which
  * a summoned creature can appear
  */
 static bool summon_possible(int y1, int x1)
 {
-	int y, x;
+	size_t i;
 
-	/* Start at the location, and check 2 grids in each dir */
-	for (y = y1 - 2; y <= y1 + 2; y++) {
-		for (x = x1 - 2; x <= x1 + 2; x++) {
-			/* Ignore illegal locations */
-			if (!square_in_bounds(cave, y, x)) continue;
+	/* Check the circular area of radius 2 around the location */
+	for (i = 0; i < N_ELEMENTS(summon_offsets); i++) {
+		int y = y1 + summon_offsets[i].y;
+		int x = x1 + summon_offsets[i].x;
 
-			/* Only check a circular area */
-			if (distance(y1, x1, y, x) > 2) continue;
+		/* Ignore illegal locations */
+		if (!square_in_bounds(cave, y, x)) continue;
 
-			/* Hack: no summon on glyph of warding */
-			if (square_iswarded(cave, y, x)) continue;
+		/* Hack: no summon on glyph of warding */
+		if (square_iswarded(cave, y, x)) continue;
 
-			/* If it's empty floor grid in line of sight, we're good */
-			if (square_isempty(cave, y, x) && los(cave, y1, x1, y, x))
-				return (TRUE);
-		}
+		/* If it's empty floor grid in line of sight, we're good */
+		if (square_isempty(cave, y, x) && los(cave, y1, x1, y, x))
+			return (TRUE);
 	}
 
 	return FALSE;
@@ -172,8 +181,9 @@ static int choose_attack_spell(struct monster *m_ptr, bitflag f[RSF_SIZE])
 	int i;
 
 	/* Extract all spells: "innate", "normal", "bizarre" */
-	for (i = FLAG_START, num = 0; i < RSF_MAX; i++)
-		if (rsf_has(f, i)) spells[num++] = i;
+	for (i = 0; i < m_ptr->race->num_spells; i++)
+		if (rsf_has(f, m_ptr->race->spells[i]))
+			spells[num++] = m_ptr->race->spells[i];
 
 	/* Paranoia */
 	if (num == 0) return 0;
@@ -299,7 +309,8 @@ bool make_attack_spell(struct monster *m_ptr)
 			set_spells(f, ~RST_BOLT);
 
 		/* Check for a possible summon */
-		if (!(summon_possible(m_ptr->fy, m_ptr->fx)))
+		if (test_spells(f, RST_SUMMON) &&
+			!(summon_possible(m_ptr->fy, m_ptr->fx)))
 
 			/* Remove summoning spells */
 			set_spells(f, ~RST_SUMMON);
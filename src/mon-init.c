@@ -298,6 +298,7 @@ static errr run_parse_mon_spell(struct parser *p) {
 
 static errr finish_parse_mon_spell(struct parser *p) {
 	monster_spells = parser_priv(p);
+	mon_spell_masks_init();
 	parser_destroy(p);
 	return 0;
 }
@@ -946,6 +947,10 @@ static errr finish_parse_monster(struct parser *p) {
 	if (arg_power || arg_rebalance)
 		eval_monster_power(r_info);
 
+	/* Work out the spell tables */
+	for (i = 0; i < z_info->r_max; i++)
+		mon_spell_race_init(&r_info[i]);
+
 	parser_destroy(p);
 	return 0;
 }
@@ -961,6 +966,7 @@ static void cleanup_monster(void)
 		struct monster_friends_base *fb;
 		struct monster_mimic *m;
 
+		mon_spell_race_free(r);
 		d = r->drops;
 		while (d) {
 			struct monster_drop *dn = d->next;
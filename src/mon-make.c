@@ -19,6 +19,7 @@
 #include "angband.h"
 #include "alloc.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "mon-desc.h"
 #include "mon-lore.h"
@@ -1253,9 +1254,12 @@ bool pick_and_place_distant_monster(struct chunk *c, struct loc loc, int dis,
 
 	int y = 0, x = 0;
 	int	attempts_left = 10000;
+	bool placed;
 
 	assert(c);
 
+	gen_phase_start(GEN_PHASE_MONSTERS);
+
 	/* Find a legal, distant, unoccupied, space */
 	while (--attempts_left) {
 		/* Pick a location */
@@ -1277,15 +1281,15 @@ bool pick_and_place_distant_monster(struct chunk *c, struct loc loc, int dis,
 		if (OPT(cheat_xtra) || OPT(cheat_hear))
 			msg("Warning! Could not allocate a new monster.");
 
+		gen_phase_stop(GEN_PHASE_MONSTERS);
 		return FALSE;
 	}
 
 	/* Attempt to place the monster, allow groups */
-	if (pick_and_place_monster(c, y, x, depth, sleep, TRUE, ORIGIN_DROP))
-		return (TRUE);
+	placed = pick_and_place_monster(c, y, x, depth, sleep, TRUE, ORIGIN_DROP);
 
-	/* Nope */
-	return (FALSE);
+	gen_phase_stop(GEN_PHASE_MONSTERS);
+	return placed;
 }
 
 
@@ -1548,6 +1548,8 @@ void process_monsters(struct chunk *c, int minimum_energy)
 	if (turn % 100 == 0)
 		regen = TRUE;
 
+	turn_timer_start(TIMER_MONSTERS);
+
 	/* Process the monsters (backwards) */
 	for (i = cave_monster_max(c) - 1; i >= 1; i--)
 	{
@@ -1614,6 +1616,8 @@ void process_monsters(struct chunk *c, int minimum_energy)
 	/* Update monster visibility after this */
 	/* XXX This may not be necessary */
 	player->upkeep->update |= PU_MONSTERS;
+
+	turn_timer_stop(TIMER_MONSTERS);
 }
 
 /**
@@ -30,6 +30,19 @@ static u16b size_mon_msg = 0;
 monster_race_message *mon_msg;
 monster_message_history *mon_message_hist;
 
+/**
+ * Hash indexes into the history and the stacked messages, by (monster, code)
+ * and (race, flags, code) respectively.  Each slot holds an index + 1, or 0
+ * for an empty slot; the tables are kept at most half full, so linear
+ * probing always ends at an empty slot.  The arrays themselves keep their
+ * insertion order, which is the order messages are flushed in.
+ */
+#define MON_HIST_HASH_SIZE	1024
+#define MON_MSG_HASH_SIZE	512
+
+static u16b *mon_hist_hash;
+static u16b *mon_msg_hash;
+
 /**
  * The NULL-terminated array of string actions used to format stacked messages.
  * Singular and plural modifiers are encoded in the same string. Example:
@@ -184,6 +197,59 @@ static char *get_mon_msg_action(byte msg_code, bool do_plural,
 	return (buf);
 }
 
+/**
+ * Mix a pointer and a couple of small values into a hash
+ */
+static u32b mon_msg_hash_key(const void *ptr, int a, int b)
+{
+	u32b h = (u32b) ((size_t) ptr >> 4);
+
+	h = (h ^ (u32b) a ^ ((u32b) b << 8)) * 0x9E3779B1;
+	return h ^ (h >> 15);
+}
+
+/**
+ * Find the history slot for a monster and message code: either the slot
+ * holding them, or the empty slot where they would go.
+ */
+static u16b *mon_hist_slot(const struct monster *m_ptr, int msg_code)
+{
+	u32b i = mon_msg_hash_key(m_ptr, msg_code, 0);
+
+	while (TRUE) {
+		u16b *slot = &mon_hist_hash[i & (MON_HIST_HASH_SIZE - 1)];
+		const monster_message_history *hist;
+
+		if (!*slot) return slot;
+		hist = &mon_message_hist[*slot - 1];
+		if (hist->mon == m_ptr && hist->message_code == msg_code)
+			return slot;
+		i++;
+	}
+}
+
+/**
+ * Find the stacked message slot for a race, flags and message code: either
+ * the slot holding them, or the empty slot where they would go.
+ */
+static u16b *mon_msg_slot(const struct monster_race *race, byte mon_flags,
+						  int msg_code)
+{
+	u32b i = mon_msg_hash_key(race, msg_code, mon_flags);
+
+	while (TRUE) {
+		u16b *slot = &mon_msg_hash[i & (MON_MSG_HASH_SIZE - 1)];
+		const monster_race_message *msg;
+
+		if (!*slot) return slot;
+		msg = &mon_msg[*slot - 1];
+		if (msg->race == race && msg->mon_flags == mon_flags &&
+			msg->msg_code == msg_code)
+			return slot;
+		i++;
+	}
+}
+
 /**
  * Tracks which monster has had which pain message stored, so redundant
  * messages don't happen due to monster attacks hitting other monsters.
@@ -191,26 +257,41 @@ static char *get_mon_msg_action(byte msg_code, bool do_plural,
  */
 static bool redundant_monster_message(struct monster *m_ptr, int msg_code)
 {
-	int i;
-
 	assert(m_ptr);
 	assert(msg_code >= 0 && msg_code < MON_MSG_MAX);
 
 	/* No messages yet */
 	if (!size_mon_hist) return FALSE;
 
-	for (i = 0; i < size_mon_hist; i++) {
-		/* Not the same monster */
-		if (m_ptr != mon_message_hist[i].mon) continue;
+	return *mon_hist_slot(m_ptr, msg_code) ? TRUE : FALSE;
+}
 
-		/* Not the same code */
-		if (msg_code != mon_message_hist[i].message_code) continue;
+/**
+ * Work out the message flags from a monster description, looking at each
+ * parenthesised mark in one pass over the name.
+ */
+static byte monster_message_flags(const char *mon_name)
+{
+	byte mon_flags = 0;
+	const char *mark = mon_name;
 
-		/* We have a match. */
-		return (TRUE);
+	while ((mark = strchr(mark, '(')) != NULL) {
+		/* Save the "hidden" mark, if present */
+		if (prefix(mark, "(hidden)"))
+			mon_flags |= MON_MSG_FLAG_HIDDEN;
+
+		/* Save the "offscreen" mark, if present */
+		else if (prefix(mark, "(offscreen)"))
+			mon_flags |= MON_MSG_FLAG_OFFSCREEN;
+
+		mark++;
 	}
 
-	return (FALSE);
+	/* Monster is invisible or out of LOS */
+	if (streq(mon_name, "it") || streq(mon_name, "something"))
+		mon_flags |= MON_MSG_FLAG_INVISIBLE;
+
+	return mon_flags;
 }
 
 
@@ -224,7 +305,8 @@ bool add_monster_message(const char *mon_name, struct monster *m_ptr,
 		int msg_code, bool delay)
 {
 	int i;
-	byte mon_flags = 0;
+	byte mon_flags;
+	u16b *slot;
 
 	assert(msg_code >= 0 && msg_code < MON_MSG_MAX);
 
@@ -233,37 +315,29 @@ bool add_monster_message(const char *mon_name, struct monster *m_ptr,
 	/* Paranoia */
 	if (!mon_name || !mon_name[0]) mon_name = "it";
 
-	/* Save the "hidden" mark, if present */
-	if (strstr(mon_name, "(hidden)")) mon_flags |= MON_MSG_FLAG_HIDDEN;
-
-	/* Save the "offscreen" mark, if present */
-	if (strstr(mon_name, "(offscreen)")) mon_flags |= MON_MSG_FLAG_OFFSCREEN;
-
-	/* Monster is invisible or out of LOS */
-	if (streq(mon_name, "it") || streq(mon_name, "something"))
-		mon_flags |= MON_MSG_FLAG_INVISIBLE;
+	mon_flags = monster_message_flags(mon_name);
 
 	/* Query if the message is already stored */
-	for (i = 0; i < size_mon_msg; i++) {
-		/* We found the race and the message code */
-		if ((mon_msg[i].race == m_ptr->race) &&
-			(mon_msg[i].mon_flags == mon_flags) &&
-			(mon_msg[i].msg_code == msg_code)) {
-			/* Can we increment the counter? */
-			if (mon_msg[i].mon_count < MAX_UCHAR) {
-				/* Stack the message */
-				++(mon_msg[i].mon_count);
-			}
-   
-			/* Success */
-			return (TRUE);
+	slot = mon_msg_slot(m_ptr->race, mon_flags, msg_code);
+	if (*slot) {
+		i = *slot - 1;
+
+		/* Can we increment the counter? */
+		if (mon_msg[i].mon_count < MAX_UCHAR) {
+			/* Stack the message */
+			++(mon_msg[i].mon_count);
 		}
+
+		/* Success */
+		return (TRUE);
 	}
-   
+
 	/* The message isn't stored. Check free space */
 	if (size_mon_msg >= MAX_STORED_MON_MSG) return (FALSE);
 
 	/* Assign the message data to the free slot */
+	i = size_mon_msg;
+	*slot = i + 1;
 	mon_msg[i].race = m_ptr->race;
 	mon_msg[i].mon_flags = mon_flags;
 	mon_msg[i].msg_code = msg_code;
@@ -286,6 +360,7 @@ bool add_monster_message(const char *mon_name, struct monster *m_ptr,
 
 	/* record which monster had this message stored */
 	if (size_mon_hist >= MAX_STORED_MON_CODES) return (TRUE);
+	*mon_hist_slot(m_ptr, msg_code) = size_mon_hist + 1;
 	mon_message_hist[size_mon_hist].mon = m_ptr;
 	mon_message_hist[size_mon_hist].message_code = msg_code;
 	size_mon_hist++;
@@ -436,6 +511,10 @@ void flush_all_monster_messages(void)
 	flush_monster_messages(TRUE, MON_DELAY_TAG_DEATH);
 
 	/* Delete all the stacked messages and history */
+	if (size_mon_msg)
+		memset(mon_msg_hash, 0, MON_MSG_HASH_SIZE * sizeof(u16b));
+	if (size_mon_hist)
+		memset(mon_hist_hash, 0, MON_HIST_HASH_SIZE * sizeof(u16b));
 	size_mon_msg = 0;
 	size_mon_hist = 0;
 }
@@ -445,12 +524,18 @@ static void monmsg_init(void) {
 	mon_msg = mem_zalloc(MAX_STORED_MON_MSG * sizeof(monster_race_message));
 	mon_message_hist = mem_zalloc(MAX_STORED_MON_CODES *
 								  sizeof(monster_message_history));
+
+	/* Indexes into them */
+	mon_msg_hash = mem_zalloc(MON_MSG_HASH_SIZE * sizeof(u16b));
+	mon_hist_hash = mem_zalloc(MON_HIST_HASH_SIZE * sizeof(u16b));
 }
 
 static void monmsg_cleanup(void) {
 	/* Free the stacked monster messages */
 	mem_free(mon_msg);
 	mem_free(mon_message_hist);
+	mem_free(mon_msg_hash);
+	mem_free(mon_hist_hash);
 }
 
 struct init_module monmsg_module = {
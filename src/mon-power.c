@@ -17,6 +17,7 @@
  */
 
 #include "angband.h"
+#include "buildid.h"
 #include "game-world.h"
 #include "init.h"
 #include "mon-init.h"
@@ -35,6 +36,18 @@ long *power, *scaled_power, *final_hp, *final_melee_dam, *final_spell_dam;
 int *highest_threat;
 s32b tot_mon_power;
 
+/**
+ * Results of evaluating a single race.  These depend only on the race itself
+ * and on static tables, so each race can be evaluated independently.
+ */
+struct race_power {
+	long dam;			/* Maximum damage in 10 game turns */
+	long hp;			/* Hit points adjusted for resistances */
+	long threat;		/* Highest threat to the player */
+	long melee_dam;		/* Melee damage in 10 game turns */
+	long spell_dam;		/* Spell damage in 10 game turns */
+};
+
 static long eval_blow_effect(int effect, random_value atk_dam, int rlev)
 {
 	int adjustment = monster_blow_effect_eval(effect);
@@ -51,7 +64,7 @@ static long eval_blow_effect(int effect, random_value atk_dam, int rlev)
 	return power;
 }
 
-static byte adj_energy(monster_race *r_ptr)
+static byte adj_energy(const monster_race *r_ptr)
 {
 	unsigned i = r_ptr->speed + (rsf_has(r_ptr->spell_flags,RSF_HASTE) ? 5 : 0);
 
@@ -59,7 +72,7 @@ static byte adj_energy(monster_race *r_ptr)
 	return turn_energy(MIN(i, N_ELEMENTS(extract_energy) - 1));
 }
 
-static long eval_max_dam(monster_race *r_ptr, int ridx)
+static long eval_max_dam(const monster_race *r_ptr, struct race_power *rp)
 {
 	int rlev, i;
 	int melee_dam = 0, atk_dam = 0, spell_dam = 0;
@@ -194,9 +207,9 @@ static long eval_max_dam(monster_race *r_ptr, int ridx)
 	/* Combine spell and melee damage */
 	dam = (spell_dam + melee_dam);
 
-	highest_threat[ridx] = dam;
-	final_spell_dam[ridx] = spell_dam;
-	final_melee_dam[ridx] = melee_dam;
+	rp->threat = dam;
+	rp->spell_dam = spell_dam;
+	rp->melee_dam = melee_dam;
 
 	/* Adjust for speed - monster at speed 120 will do double damage, monster
 	 * at speed 100 will do half, etc.  Bonus for monsters who can haste self */
@@ -204,15 +217,15 @@ static long eval_max_dam(monster_race *r_ptr, int ridx)
 
 	/* Adjust threat for speed -- multipliers are more threatening. */
 	if (rf_has(r_ptr->flags, RF_MULTIPLY))
-		highest_threat[ridx] = (highest_threat[ridx] * adj_energy(r_ptr)) / 5;
+		rp->threat = (rp->threat * adj_energy(r_ptr)) / 5;
 
 	/* Adjust threat for friends, this can be improved, but is probably good
 	 * enough for now. */
 	if (r_ptr->friends)
-		highest_threat[ridx] *= 2;
+		rp->threat *= 2;
 	else if (r_ptr->friends_base)
 		/* Friends base is weaker, because they are <= monster level */
-		highest_threat[ridx] = highest_threat[ridx] * 3 / 2;
+		rp->threat = rp->threat * 3 / 2;
 		
 	/* But keep at a minimum */
 	if (dam < 1) dam  = 1;
@@ -221,7 +234,7 @@ static long eval_max_dam(monster_race *r_ptr, int ridx)
 	return (dam);
 }
 
-static long eval_hp_adjust(monster_race *r_ptr)
+static long eval_hp_adjust(const monster_race *r_ptr)
 {
 	long hp;
 	int resists = 1;
@@ -335,6 +348,299 @@ static long eval_hp_adjust(monster_race *r_ptr)
 	return (hp);
 }
 
+/**
+ * Evaluate a single race.  This reads nothing but the race and constant
+ * tables and writes nothing but *rp, so any partition of the race list can
+ * be handed to a separate worker.
+ */
+static void eval_race_power(const monster_race *race, struct race_power *rp)
+{
+	/* Maximum damage this monster can do in 10 game turns */
+	rp->dam = eval_max_dam(race, rp);
+
+	/* Adjust hit points based on resistances */
+	rp->hp = eval_hp_adjust(race);
+}
+
+/**
+ * Evaluate the races in [start, end) of the list.
+ */
+static void eval_race_range(const struct monster_race *racelist,
+							struct race_power *results, int start, int end)
+{
+	int i;
+
+	for (i = start; i < end; i++)
+		eval_race_power(&racelist[i], &results[i]);
+}
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Power cache
+ *
+ * Evaluation results are written to the user directory, keyed by the
+ * contents of the data files they were derived from, so an unchanged
+ * monster list can skip evaluation entirely.  The evaluation itself only
+ * runs when asked for with -p or -r.
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Cache file layout:
+ * - 4-byte magic
+ * - 4-byte cache version
+ * - checksum of the game version string, as the evaluation may change
+ *   between versions even with the same data files
+ * - checksums of monster.txt, monster_spell.txt and monster_base.txt
+ * - sizes of the same files
+ * - checksum of the built-in blow effect and method tables
+ * - rebalance flag, r_max and max_depth
+ * - 8-byte tot_mon_power
+ * - per race: 8-byte level, rarity, mexp, power, scaled_power, then the
+ *   eight bytes each of the evaluation tables
+ */
+static const byte power_cache_magic[4] = { 'M', 'P', 'W', 'R' };
+#define POWER_CACHE_VERSION	3
+#define POWER_CACHE_FIELDS	11
+
+/**
+ * The edit files the evaluation depends on
+ */
+static const char *power_cache_files[] = {
+	"monster.txt",
+	"monster_spell.txt",
+	"monster_base.txt",
+};
+
+#define POWER_CACHE_NFILES	N_ELEMENTS(power_cache_files)
+
+struct power_cache_key {
+	u32b version;
+	u32b sum[POWER_CACHE_NFILES];
+	u32b size[POWER_CACHE_NFILES];
+	u32b blows;
+};
+
+/**
+ * FNV-1a checksum and size of an edit file; FALSE if it can't be read
+ */
+static bool power_cache_sum_file(const char *name, u32b *sum, u32b *size)
+{
+	char path[1024];
+
+	path_build(path, sizeof(path), ANGBAND_DIR_EDIT, name);
+	return file_checksum(path, sum, size);
+}
+
+/**
+ * FNV-1a checksum of the blow effect evaluations and the size of the blow
+ * tables, which are built in rather than read from an edit file
+ */
+static u32b power_cache_sum_blows(void)
+{
+	u32b sum = 2166136261UL;
+	int i;
+
+	for (i = 0; i < RBE_MAX; i++) {
+		sum ^= (byte)monster_blow_effect_eval(i);
+		sum *= 16777619UL;
+	}
+	sum ^= RBE_MAX;
+	sum *= 16777619UL;
+	sum ^= RBM_MAX;
+	sum *= 16777619UL;
+
+	return sum;
+}
+
+static bool power_cache_make_key(struct power_cache_key *key)
+{
+	const char *s;
+	size_t i;
+
+	key->version = 2166136261UL;
+	for (s = VERSION_STRING; *s; s++)
+		key->version = (key->version ^ (byte)*s) * 16777619UL;
+
+	for (i = 0; i < POWER_CACHE_NFILES; i++)
+		if (!power_cache_sum_file(power_cache_files[i], &key->sum[i],
+								  &key->size[i]))
+			return FALSE;
+	key->blows = power_cache_sum_blows();
+
+	return TRUE;
+}
+
+static void power_cache_path(char *buf, size_t len)
+{
+	path_build(buf, len, ANGBAND_DIR_USER, "mon_power.dat");
+}
+
+static void power_cache_put(byte **p, s64b v)
+{
+	u64b u = (u64b)v;
+	int i;
+
+	for (i = 0; i < 8; i++, u >>= 8)
+		*(*p)++ = (byte)(u & 0xFF);
+}
+
+static s64b power_cache_get(const byte **p)
+{
+	u64b u = 0;
+	int i;
+
+	for (i = 7; i >= 0; i--)
+		u = (u << 8) | (*p)[i];
+	*p += 8;
+
+	return (s64b)u;
+}
+
+/**
+ * Header values in the order they appear in the file, after the magic
+ */
+static void power_cache_header(const struct power_cache_key *key,
+							   s64b *header)
+{
+	size_t i;
+
+	*header++ = POWER_CACHE_VERSION;
+	*header++ = key->version;
+	for (i = 0; i < POWER_CACHE_NFILES; i++)
+		*header++ = key->sum[i];
+	for (i = 0; i < POWER_CACHE_NFILES; i++)
+		*header++ = key->size[i];
+	*header++ = key->blows;
+	*header++ = arg_rebalance ? 1 : 0;
+	*header++ = z_info->r_max;
+	*header = z_info->max_depth;
+}
+
+#define POWER_CACHE_HEADER	((int)(2 * POWER_CACHE_NFILES + 6))
+
+static size_t power_cache_size(void)
+{
+	return sizeof(power_cache_magic) + 8 * (POWER_CACHE_HEADER + 1) +
+		8 * POWER_CACHE_FIELDS * z_info->r_max;
+}
+
+/**
+ * Load cached results matching the key into the power tables and the race
+ * list.  Returns FALSE, touching nothing, if there is no matching cache.
+ */
+static bool power_cache_load(const struct power_cache_key *key,
+							 struct monster_race *racelist)
+{
+	char path[1024];
+	size_t size = power_cache_size();
+	byte *data;
+	const byte *p;
+	s64b header[POWER_CACHE_HEADER];
+	ang_file *f;
+	bool ok;
+	int i;
+
+	power_cache_path(path, sizeof(path));
+	if (!file_exists(path)) return FALSE;
+
+	f = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!f) return FALSE;
+
+	/* Read one byte past the expected size to catch trailing junk */
+	data = mem_alloc(size + 1);
+	ok = (file_read(f, (char *)data, size + 1) == (int)size);
+	file_close(f);
+
+	/* Check the magic and the header */
+	p = data;
+	if (ok && memcmp(p, power_cache_magic, sizeof(power_cache_magic)))
+		ok = FALSE;
+	p += sizeof(power_cache_magic);
+
+	power_cache_header(key, header);
+	for (i = 0; ok && i < POWER_CACHE_HEADER; i++)
+		if (power_cache_get(&p) != header[i])
+			ok = FALSE;
+
+	if (!ok) {
+		mem_free(data);
+		return FALSE;
+	}
+
+	tot_mon_power = (s32b)power_cache_get(&p);
+	for (i = 0; i < z_info->r_max; i++) {
+		monster_race *race = &racelist[i];
+
+		race->level = (int)power_cache_get(&p);
+		race->rarity = (int)power_cache_get(&p);
+		race->mexp = (int)power_cache_get(&p);
+		race->power = (long)power_cache_get(&p);
+		race->scaled_power = (long)power_cache_get(&p);
+		power[i] = (long)power_cache_get(&p);
+		scaled_power[i] = (long)power_cache_get(&p);
+		final_hp[i] = (long)power_cache_get(&p);
+		final_melee_dam[i] = (long)power_cache_get(&p);
+		final_spell_dam[i] = (long)power_cache_get(&p);
+		highest_threat[i] = (int)power_cache_get(&p);
+	}
+
+	mem_free(data);
+	return TRUE;
+}
+
+/**
+ * Save the current power tables and race values under the key
+ */
+static void power_cache_save(const struct power_cache_key *key,
+							 const struct monster_race *racelist)
+{
+	char path[1024];
+	size_t size = power_cache_size();
+	byte *data = mem_alloc(size);
+	byte *p = data;
+	s64b header[POWER_CACHE_HEADER];
+	ang_file *f;
+	int i;
+
+	memcpy(p, power_cache_magic, sizeof(power_cache_magic));
+	p += sizeof(power_cache_magic);
+
+	power_cache_header(key, header);
+	for (i = 0; i < POWER_CACHE_HEADER; i++)
+		power_cache_put(&p, header[i]);
+
+	power_cache_put(&p, tot_mon_power);
+	for (i = 0; i < z_info->r_max; i++) {
+		const monster_race *race = &racelist[i];
+
+		power_cache_put(&p, race->level);
+		power_cache_put(&p, race->rarity);
+		power_cache_put(&p, race->mexp);
+		power_cache_put(&p, race->power);
+		power_cache_put(&p, race->scaled_power);
+		power_cache_put(&p, power[i]);
+		power_cache_put(&p, scaled_power[i]);
+		power_cache_put(&p, final_hp[i]);
+		power_cache_put(&p, final_melee_dam[i]);
+		power_cache_put(&p, final_spell_dam[i]);
+		power_cache_put(&p, highest_threat[i]);
+	}
+
+	power_cache_path(path, sizeof(path));
+	f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (f) {
+		if (!file_write(f, (const char *)data, size)) {
+			file_close(f);
+			file_delete(path);
+		} else {
+			file_close(f);
+		}
+	}
+
+	mem_free(data);
+}
+
 /**
  * Write an amended monster.txt file
  */
@@ -368,25 +674,17 @@ void write_monster_entries(ang_file *fff)
 }
 
 /**
- * Evaluate the whole monster list and write a new one.  power and scaled_power
- * are always adjusted, level, rarity and mexp only if requested.
+ * Run the power evaluation over the whole race list, filling the power
+ * tables and (if rebalancing) adjusting the races.
  */
-errr eval_monster_power(struct monster_race *racelist)
+static void eval_power_iterations(struct monster_race *racelist)
 {
 	int i, j, iteration;
 	byte lvl;
 	monster_race *r_ptr = NULL;
-	ang_file *mon_fp;
-	char buf[1024];
-	bool dump = FALSE;
+	struct race_power *results;
 
-	/* Allocate arrays */
-	power = mem_zalloc(z_info->r_max * sizeof(long));
-	scaled_power = mem_zalloc(z_info->r_max * sizeof(long));
-	final_hp = mem_zalloc(z_info->r_max * sizeof(long));
-	final_melee_dam = mem_zalloc(z_info->r_max * sizeof(long));
-	final_spell_dam = mem_zalloc(z_info->r_max * sizeof(long));
-	highest_threat = mem_zalloc(z_info->r_max * sizeof(int));
+	results = mem_zalloc(z_info->r_max * sizeof(*results));
 
 	for (iteration = 0; iteration < 3; iteration ++) {
 		long hp, av_hp, dam, av_dam;
@@ -397,6 +695,10 @@ errr eval_monster_power(struct monster_race *racelist)
 		/* Reset the sum of all monster power values */
 		tot_mon_power = 0;
 
+		/* Races only change between iterations if we're rebalancing */
+		if (iteration == 0 || arg_rebalance)
+			eval_race_range(racelist, results, 0, z_info->r_max);
+
 		/* Go through r_info and evaluate power ratings & flows. */
 		for (i = 0; i < z_info->r_max; i++)	{
 
@@ -406,11 +708,12 @@ errr eval_monster_power(struct monster_race *racelist)
 			/* Set the current level */
 			lvl = r_ptr->level;
 
-			/* Maximum damage this monster can do in 10 game turns */
-			dam = eval_max_dam(r_ptr, i);
-
-			/* Adjust hit points based on resistances */
-			hp = eval_hp_adjust(r_ptr);
+			/* Take the evaluated damage and hit points */
+			dam = results[i].dam;
+			hp = results[i].hp;
+			highest_threat[i] = results[i].threat;
+			final_melee_dam[i] = results[i].melee_dam;
+			final_spell_dam[i] = results[i].spell_dam;
 
 			/* Hack -- set exp */
 			if (lvl == 0)
@@ -638,6 +941,39 @@ errr eval_monster_power(struct monster_race *racelist)
 	for (i = 0; i < z_info->r_max; i++)
 		tot_mon_power += r_info[i].scaled_power;
 
+	mem_free(results);
+}
+
+/**
+ * Evaluate the whole monster list and write a new one.  power and scaled_power
+ * are always adjusted, level, rarity and mexp only if requested.
+ */
+errr eval_monster_power(struct monster_race *racelist)
+{
+	int i;
+	monster_race *r_ptr = NULL;
+	ang_file *mon_fp;
+	char buf[1024];
+	bool dump = FALSE;
+	struct power_cache_key key;
+	bool have_key;
+
+	/* Allocate arrays */
+	power = mem_zalloc(z_info->r_max * sizeof(long));
+	scaled_power = mem_zalloc(z_info->r_max * sizeof(long));
+	final_hp = mem_zalloc(z_info->r_max * sizeof(long));
+	final_melee_dam = mem_zalloc(z_info->r_max * sizeof(long));
+	final_spell_dam = mem_zalloc(z_info->r_max * sizeof(long));
+	highest_threat = mem_zalloc(z_info->r_max * sizeof(int));
+
+	/* Reuse the results from an unchanged monster list if we can */
+	have_key = power_cache_make_key(&key);
+	if (!have_key || !power_cache_load(&key, racelist)) {
+		eval_power_iterations(racelist);
+		if (have_key)
+			power_cache_save(&key, racelist);
+	}
+
 	if (dump) {
 		/* Dump the power details */
 		path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "mon_power.txt");
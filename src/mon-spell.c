@@ -56,15 +56,90 @@ static const struct breath_damage {
     #undef ELEM
 };
 
+/**
+ * Spells worked out once the spell list has been read: each spell by index,
+ * and masks of the spells of each type, of those projecting each element,
+ * of those whose timed effect each object flag protects against, and of
+ * those which drain mana.  The masks let the checks on a spell set be done
+ * a word at a time rather than spell by spell.
+ */
+static const struct monster_spell *spells_by_index[RSF_MAX];
+static bitflag spells_of_type[16][RSF_SIZE];
+static bitflag spells_of_element[ELEM_MAX][RSF_SIZE];
+static bitflag spells_protected[OF_MAX][RSF_SIZE];
+static bitflag spells_drain_mana[RSF_SIZE];
+
 static const struct monster_spell *monster_spell_by_index(int index)
 {
-	const struct monster_spell *spell = monster_spells;
-	while (spell) {
-		if (spell->index == index)
-			break;
-		spell = spell->next;
+	if (index <= RSF_NONE || index >= RSF_MAX)
+		return NULL;
+
+	return spells_by_index[index];
+}
+
+/**
+ * Work out the spell masks; called when the spell list has been read
+ */
+void mon_spell_masks_init(void)
+{
+	const struct mon_spell_info *info;
+	const struct monster_spell *spell;
+	int i;
+
+	memset(spells_by_index, 0, sizeof(spells_by_index));
+	memset(spells_of_type, 0, sizeof(spells_of_type));
+	memset(spells_of_element, 0, sizeof(spells_of_element));
+	memset(spells_protected, 0, sizeof(spells_protected));
+	rsf_wipe(spells_drain_mana);
+
+	/* Index the spells, keeping the first of each like the list did */
+	for (spell = monster_spells; spell; spell = spell->next)
+		if (spell->index > RSF_NONE && spell->index < RSF_MAX &&
+			!spells_by_index[spell->index])
+			spells_by_index[spell->index] = spell;
+
+	for (info = mon_spell_info_table; info->index < RSF_MAX; info++) {
+		const struct effect *effect;
+
+		for (i = 0; i < 16; i++)
+			if (info->type & (1 << i))
+				rsf_on(spells_of_type[i], info->index);
+
+		spell = monster_spell_by_index(info->index);
+		if (!spell || !spell->effect) continue;
+
+		/* Projectable spells are resisted by element */
+		if (info->type & (RST_BOLT | RST_BALL | RST_BREATH)) {
+			int element = spell->effect->params[0];
+			if (element >= 0 && element < ELEM_MAX)
+				rsf_on(spells_of_element[element], info->index);
+			continue;
+		}
+
+		/* Others by their effects */
+		for (effect = spell->effect; effect; effect = effect->next) {
+			if (effect->index == EF_TIMED_INC) {
+				int flag = timed_protect_flag(effect->params[0]);
+				if (flag > 0 && flag < OF_MAX)
+					rsf_on(spells_protected[flag], info->index);
+			} else if (effect->index == EF_DRAIN_MANA) {
+				rsf_on(spells_drain_mana, info->index);
+			}
+		}
 	}
-	return spell;
+}
+
+/**
+ * Make the mask of all spells having any of the given types
+ */
+static void spells_of_types(bitflag *mask, int types)
+{
+	int i;
+
+	rsf_wipe(mask);
+	for (i = 0; i < 16; i++)
+		if (types & (1 << i))
+			rsf_union(mask, spells_of_type[i]);
 }
 
 /**
@@ -130,13 +205,10 @@ void do_mon_spell(int index, struct monster *mon, bool seen)
  */
 bool test_spells(bitflag *f, int types)
 {
-	const struct mon_spell_info *info;
-
-	for (info = mon_spell_info_table; info->index < RSF_MAX; info++)
-		if (rsf_has(f, info->index) && (info->type & types))
-			return TRUE;
+	bitflag mask[RSF_SIZE];
 
-	return FALSE;
+	spells_of_types(mask, types);
+	return rsf_is_inter(f, mask);
 }
 
 /**
@@ -147,19 +219,19 @@ bool test_spells(bitflag *f, int types)
  */
 void set_spells(bitflag *f, int types)
 {
-	const struct mon_spell_info *info;
-
-	for (info = mon_spell_info_table; info->index < RSF_MAX; info++)
-		if (rsf_has(f, info->index) && !(info->type & types))
-			rsf_off(f, info->index);
+	bitflag mask[RSF_SIZE];
 
-	return;
+	spells_of_types(mask, types);
+	rsf_inter(f, mask);
 }
 
 /**
  * Turn off spells with a side effect or a gf_type that is resisted by
  * something in flags, subject to intelligence and chance.
  *
+ * Only the spells which something known could make useless are looked at
+ * one by one; the masks find them without going through the rest.
+ *
  * \param spells is the set of spells we're pruning
  * \param flags is the set of object flags we're testing
  * \param pflags is the set of player flags we're testing
@@ -169,17 +241,30 @@ void set_spells(bitflag *f, int types)
 void unset_spells(bitflag *spells, bitflag *flags, bitflag *pflags,
 				  struct element_info *el, const monster_race *r_ptr)
 {
-	const struct mon_spell_info *info;
 	const struct monster_spell *spell;
 	const struct effect *effect;
 	bool smart = rf_has(r_ptr->flags, RF_SMART);
-
-	for (info = mon_spell_info_table; info->index < RSF_MAX; info++) {
-		/* Ignore missing spells */
-		if (!rsf_has(spells, info->index)) continue;
+	bitflag suspect[RSF_SIZE];
+	int i;
+
+	/* Find the spells something known might spoil */
+	rsf_wipe(suspect);
+	for (i = 0; i < ELEM_MAX; i++)
+		if (el[i].res_level > 0)
+			rsf_union(suspect, spells_of_element[i]);
+	for (i = of_next(flags, FLAG_START); i != FLAG_END;
+		 i = of_next(flags, i + 1))
+		rsf_union(suspect, spells_protected[i]);
+	if (pf_has(pflags, PF_NO_MANA))
+		rsf_union(suspect, spells_drain_mana);
+	rsf_inter(suspect, spells);
+
+	for (i = rsf_next(suspect, FLAG_START); i != FLAG_END;
+		 i = rsf_next(suspect, i + 1)) {
+		const struct mon_spell_info *info = &mon_spell_info_table[i];
 
 		/* Get the effect */
-		spell = monster_spell_by_index(info->index);
+		spell = monster_spell_by_index(i);
 		if (!spell) continue;
 		effect = spell->effect;
 
@@ -188,24 +273,25 @@ void unset_spells(bitflag *spells, bitflag *flags, bitflag *pflags,
 			int element = effect->params[0];
 			int learn_chance = el[element].res_level * (smart ? 50 : 25);
 			if (randint0(100) < learn_chance)
-				rsf_off(spells, info->index);
+				rsf_off(spells, i);
 		} else {
 			/* Now others with resisted effects */
 			while (effect) {
 				/* Timed effects */
-				if ((smart || !one_in_(3)) && (effect->index == EF_TIMED_INC) &&
-					of_has(flags, timed_protect_flag(effect->params[0])))
+				if ((effect->index == EF_TIMED_INC) &&
+					of_has(flags, timed_protect_flag(effect->params[0])) &&
+					(smart || !one_in_(3)))
 					break;
 
 				/* Mana drain */
-				if ((smart || one_in_(2)) && (effect->index == EF_DRAIN_MANA) &&
-					pf_has(pflags, PF_NO_MANA))
+				if ((effect->index == EF_DRAIN_MANA) &&
+					pf_has(pflags, PF_NO_MANA) && (smart || one_in_(2)))
 					break;
 
 				effect = effect->next;
 			}
 			if (effect)
-				rsf_off(spells, info->index);
+				rsf_off(spells, i);
 		}
 	}
 }
@@ -242,7 +328,7 @@ static int nonhp_dam(const struct monster_spell *spell, const monster_race *race
 	while (effect) {
 		random_value rand;
 		if (effect->dice) {
-			dice_roll(effect->dice, &rand);
+			dice_random_value(effect->dice, &rand);
 			dam += randcalc(rand, 0, dam_aspect);
 		}
 		effect = effect->next;
@@ -284,11 +370,59 @@ int breath_dam(int element, int hp)
 static int mon_spell_dam(int index, int hp, const monster_race *race, aspect dam_aspect)
 {
 	const struct monster_spell *spell = monster_spell_by_index(index);
+	int i;
 
 	if (monster_spell_is_breath(index))
 		return breath_dam(spell->effect->params[0], hp);
-	else
-		return nonhp_dam(spell, race, dam_aspect);
+
+	/* Maximum damage is kept with the race */
+	if (dam_aspect == MAXIMISE && race->spell_dam)
+		for (i = 0; i < race->num_spells; i++)
+			if (race->spells[i] == index)
+				return race->spell_dam[i];
+
+	return nonhp_dam(spell, race, dam_aspect);
+}
+
+/**
+ * Work out a race's spell table: its spells in index order, and the maximum
+ * damage of each one which doesn't depend on the monster's hp.
+ * Called when the races have been read.
+ *
+ * \param race is the race
+ */
+void mon_spell_race_init(struct monster_race *race)
+{
+	int i, n = 0;
+
+	for (i = rsf_next(race->spell_flags, FLAG_START); i != FLAG_END;
+		 i = rsf_next(race->spell_flags, i + 1))
+		n++;
+
+	race->num_spells = n;
+	race->spells = mem_zalloc(MAX(n, 1) * sizeof(u16b));
+	race->spell_dam = mem_zalloc(MAX(n, 1) * sizeof(int));
+
+	for (n = 0, i = rsf_next(race->spell_flags, FLAG_START); i != FLAG_END;
+		 i = rsf_next(race->spell_flags, i + 1), n++) {
+		const struct monster_spell *spell = monster_spell_by_index(i);
+
+		race->spells[n] = i;
+		if (spell && !monster_spell_is_breath(i))
+			race->spell_dam[n] = nonhp_dam(spell, race, MAXIMISE);
+	}
+}
+
+/**
+ * Free a race's spell table
+ */
+void mon_spell_race_free(struct monster_race *race)
+{
+	mem_free(race->spells);
+	mem_free(race->spell_dam);
+	race->spells = NULL;
+	race->spell_dam = NULL;
+	race->num_spells = 0;
 }
 
 
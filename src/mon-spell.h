@@ -74,6 +74,9 @@ enum mon_spell_type {
 
 
 /** Functions **/
+void mon_spell_masks_init(void);
+void mon_spell_race_init(struct monster_race *race);
+void mon_spell_race_free(struct monster_race *race);
 int breath_dam(int element, int hp);
 void do_mon_spell(int index, struct monster *m_ptr, bool seen);
 bool test_spells(bitflag *f, int types);
@@ -295,6 +295,10 @@ typedef struct monster_race
     struct monster_friends_base *friends_base;
     
 	struct monster_mimic *mimic_kinds;
+
+	int num_spells;			/* Number of spells */
+	u16b *spells;			/* Spell indexes, in order */
+	int *spell_dam;			/* Maximum damage of each spell, bar breaths */
 } monster_race;
 
 
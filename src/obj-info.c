@@ -1440,7 +1440,7 @@ static bool describe_effect(textblock *tb, const struct object *obj,
 		random_value value = { 0, 0, 0, 0 };
 		char dice_string[20];
 		if (effect->dice != NULL)
-			(void) dice_roll(effect->dice, &value);
+			dice_random_value(effect->dice, &value);
 
 		/* Get the possible dice strings */
 		if (value.dice && value.base)
@@ -1794,6 +1794,75 @@ static textblock *object_info_out(const struct object *obj, int mode)
 }
 
 
+/**
+ * Number of object descriptions to keep
+ */
+#define OBJECT_INFO_CACHE_SIZE	16
+
+/**
+ * Recently built object descriptions
+ */
+static textblock_cache *info_cache;
+
+/**
+ * What a cached object description depends on: the object (compared byte
+ * for byte, since callers often describe objects made on the stack), what
+ * is known of its kind, the mode, and the game turn and player state.
+ */
+struct object_info_key {
+	struct object obj;
+	struct object_kind kind;
+	const struct ego_item *ego;
+	oinfo_detail_t mode;
+	s32b turn;
+	u32b version;
+};
+
+/**
+ * Fill in the key for a cached description
+ */
+static void object_info_key(struct object_info_key *key,
+							const struct object *obj,
+							const struct ego_item *ego, oinfo_detail_t mode)
+{
+	memset(key, 0, sizeof(*key));
+	if (obj) {
+		memcpy(&key->obj, obj, sizeof(*obj));
+		memcpy(&key->kind, obj->kind, sizeof(*obj->kind));
+	}
+	key->ego = ego;
+	key->mode = mode;
+	key->turn = turn;
+	key->version = player->upkeep->version;
+}
+
+/**
+ * Return a copy of the cached description stored against a key, or NULL
+ */
+static textblock *object_info_cached(struct object_info_key *key)
+{
+	const textblock *cached;
+	textblock *tb;
+
+	if (!info_cache)
+		info_cache = textblock_cache_new(OBJECT_INFO_CACHE_SIZE);
+	cached = textblock_cache_find(info_cache, key, sizeof(*key));
+	if (!cached) return NULL;
+
+	tb = textblock_new();
+	textblock_append_textblock(tb, cached);
+	return tb;
+}
+
+/**
+ * Free the recently built object descriptions
+ */
+void object_info_cache_free(void)
+{
+	textblock_cache_free(info_cache);
+	info_cache = NULL;
+}
+
 /**
  * Provide information on an item, including how it would affect the current
  * player's state.
@@ -1802,8 +1871,19 @@ static textblock *object_info_out(const struct object *obj, int mode)
  */
 textblock *object_info(const struct object *obj, oinfo_detail_t mode)
 {
+	struct object_info_key key;
+	textblock *tb;
+
 	mode |= OINFO_SUBJ;
-	return object_info_out(obj, mode);
+
+	/* Reuse the last description if nothing it depends on has changed */
+	object_info_key(&key, obj, NULL, mode);
+	tb = object_info_cached(&key);
+	if (tb) return tb;
+
+	tb = object_info_out(obj, mode);
+	textblock_cache_add(info_cache, &key, sizeof(key), tb);
+	return tb;
 }
 
 /**
@@ -1813,8 +1893,15 @@ textblock *object_info_ego(struct ego_item *ego)
 {
 	object_kind *kind = NULL;
 	struct object obj = { 0 };
+	struct object_info_key key;
+	textblock *tb;
 	size_t i;
 
+	/* Reuse the last description if nothing it depends on has changed */
+	object_info_key(&key, NULL, ego, OINFO_NONE | OINFO_EGO);
+	tb = object_info_cached(&key);
+	if (tb) return tb;
+
 	for (i = 0; i < z_info->k_max; i++) {
 		kind = &k_info[i];
 		if (!kind->name)
@@ -1831,7 +1918,9 @@ textblock *object_info_ego(struct ego_item *ego)
 
 	object_know_all_but_flavor(&obj);
 
-	return object_info_out(&obj, OINFO_NONE | OINFO_EGO);
+	tb = object_info_out(&obj, OINFO_NONE | OINFO_EGO);
+	textblock_cache_add(info_cache, &key, sizeof(key), tb);
+	return tb;
 }
 
 
@@ -1853,10 +1942,19 @@ void object_info_chardump(ang_file *f, const struct object *obj, int indent, int
  *
  * Practically, this means that we should not print anything which relies upon
  * the player's current state, since that is not suitable for spoiler material.
+ * The caller frees the textblock.
+ */
+textblock *object_info_spoil_text(const struct object *obj)
+{
+	return object_info_out(obj, OINFO_NONE);
+}
+
+/**
+ * Write spoiler information on an item to a file.
  */
 void object_info_spoil(ang_file *f, const struct object *obj, int wrap)
 {
-	textblock *tb = object_info_out(obj, OINFO_NONE);
+	textblock *tb = object_info_spoil_text(obj);
 	textblock_to_file(tb, f, 0, wrap);
 	textblock_free(tb);
 }
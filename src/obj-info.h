@@ -56,6 +56,8 @@ enum {
 
 textblock *object_info(const struct object *obj, oinfo_detail_t mode);
 textblock *object_info_ego(struct ego_item *ego);
+void object_info_cache_free(void);
+textblock *object_info_spoil_text(const struct object *obj);
 void object_info_spoil(ang_file *f, const struct object *obj, int wrap);
 void object_info_chardump(ang_file *f, const struct object *obj, int indent, int wrap);
 
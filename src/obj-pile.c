@@ -197,7 +197,7 @@ bool pile_contains(const struct object *top, const struct object *obj)
  */
 struct object *object_new(void)
 {
-	return mem_zalloc(sizeof(struct object));
+	return mem_zalloc_tag(sizeof(struct object), MEM_TAG_OBJECT);
 }
 
 /**
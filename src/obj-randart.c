@@ -223,6 +223,61 @@ static int verbose = 1;
 /* Fake pvals array for maintaining current behaviour NRM */
 int fake_pval[3] = {0, 0, 0};
 
+/*
+ * Seed the set was requested with; each artifact gets its own RNG stream
+ * derived from this, so its result doesn't depend on the ones before it
+ */
+static u32b randart_seed_base;
+
+/**
+ * Whether the current set was made from a single RNG stream, as savefiles
+ * from before per-artifact streams need; saved along with the seed
+ */
+bool randart_single_stream;
+
+/**
+ * Slot types an acceptable artifact set needs a minimum number of
+ */
+enum {
+	ART_QUOTA_SWORD,
+	ART_QUOTA_POLEARM,
+	ART_QUOTA_BLUNT,
+	ART_QUOTA_BOW,
+	ART_QUOTA_BODY,
+	ART_QUOTA_SHIELD,
+	ART_QUOTA_CLOAK,
+	ART_QUOTA_HAT,
+	ART_QUOTA_GLOVE,
+	ART_QUOTA_BOOT,
+
+	ART_QUOTA_MAX
+};
+
+static const struct {
+	const char *name;
+	int min;
+} art_quota[ART_QUOTA_MAX] = {
+	{ "swords", 5 },
+	{ "polearms", 5 },
+	{ "blunts", 5 },
+	{ "bows", 4 },
+	{ "body-armors", 5 },
+	{ "shields", 4 },
+	{ "cloaks", 4 },
+	{ "hats", 4 },
+	{ "gloves", 4 },
+	{ "boots", 4 }
+};
+
+/*
+ * Quota tracking for the set being generated: how many more of each slot
+ * type are needed, how many artifacts still get a new base item, and
+ * whether base item choice is currently restricted to the types still short
+ */
+static int quota_deficit[ART_QUOTA_MAX];
+static int quota_free;
+static bool quota_retarget;
+
 /**
  * Describes an element-name pair.
  */
@@ -403,6 +458,133 @@ static void store_base_power(void)
 }
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Slot type quota
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Which quota (if any) an artifact of the given tval counts towards
+ */
+static int quota_group(int tval)
+{
+	switch (tval) {
+		case TV_SWORD: return ART_QUOTA_SWORD;
+		case TV_POLEARM: return ART_QUOTA_POLEARM;
+		case TV_HAFTED: return ART_QUOTA_BLUNT;
+		case TV_BOW: return ART_QUOTA_BOW;
+		case TV_SOFT_ARMOR:
+		case TV_HARD_ARMOR:
+		case TV_DRAG_ARMOR: return ART_QUOTA_BODY;
+		case TV_SHIELD: return ART_QUOTA_SHIELD;
+		case TV_CLOAK: return ART_QUOTA_CLOAK;
+		case TV_HELM:
+		case TV_CROWN: return ART_QUOTA_HAT;
+		case TV_GLOVES: return ART_QUOTA_GLOVE;
+		case TV_BOOTS: return ART_QUOTA_BOOT;
+		default: return -1;
+	}
+}
+
+/**
+ * Whether scramble_artifact() will choose a new base item for an artifact;
+ * all other artifacts keep their tval.
+ */
+static bool artifact_is_rerolled(int a_idx)
+{
+	struct artifact *art = &a_info[a_idx];
+	struct object_kind *kind;
+
+	if (art->tval == 0) return FALSE;
+	kind = lookup_kind(art->tval, art->sval);
+
+	if (strstr(art->name, "The One Ring") ||
+		kf_has(kind->kind_flags, KF_QUEST_ART))
+		return FALSE;
+	if (base_power[a_idx] > INHIBIT_POWER)
+		return FALSE;
+	return !kf_has(kind->kind_flags, KF_INSTA_ART);
+}
+
+/**
+ * Start tracking the quota for a new set.  Artifacts which keep their base
+ * item are counted straight away.
+ */
+static void quota_init(void)
+{
+	int i;
+
+	for (i = 0; i < ART_QUOTA_MAX; i++)
+		quota_deficit[i] = art_quota[i].min;
+	quota_free = 0;
+	quota_retarget = FALSE;
+
+	for (i = 0; i < z_info->a_max; i++) {
+		if (i > 0 && artifact_is_rerolled(i)) {
+			quota_free++;
+		} else {
+			int group = quota_group(a_info[i].tval);
+			if (group >= 0) quota_deficit[group]--;
+		}
+	}
+}
+
+/**
+ * Count a newly generated artifact towards the quota
+ */
+static void quota_count(int a_idx)
+{
+	int group = quota_group(a_info[a_idx].tval);
+
+	if (group >= 0) quota_deficit[group]--;
+	quota_free--;
+}
+
+/**
+ * Number of artifacts still needed to fill the quota
+ */
+static int quota_need(void)
+{
+	int i, need = 0;
+
+	for (i = 0; i < ART_QUOTA_MAX; i++)
+		if (quota_deficit[i] > 0)
+			need += quota_deficit[i];
+
+	return need;
+}
+
+/**
+ * Whether choose_item() may currently pick a base item of this tval
+ */
+static bool quota_tval_allowed(int tval)
+{
+	int group;
+
+	if (!quota_retarget) return TRUE;
+
+	group = quota_group(tval);
+	return group >= 0 && quota_deficit[group] > 0;
+}
+
+/**
+ * Seed for an artifact's own RNG stream in a given set attempt
+ */
+static u32b randart_stream_seed(int set, int a_idx)
+{
+	u32b x = randart_seed_base ^ (0x9E3779B9UL * (u32b)a_idx) ^
+		(0x85EBCA6BUL * (u32b)set);
+
+	/* Mix the bits so nearby artifacts get unrelated streams */
+	x ^= x >> 16;
+	x *= 0x7FEB352DUL;
+	x ^= x >> 15;
+	x *= 0x846CA68BUL;
+	x ^= x >> 16;
+
+	return x;
+}
+
 /**
  * Randomly select a base item type (tval,sval).  Assign the various fields
  * corresponding to that choice.
@@ -436,7 +618,8 @@ static struct object_kind *choose_item(int a_idx)
 		   tval == TV_PRAYER_BOOK || tval == TV_GOLD || tval == TV_LIGHT ||
 		   tval == TV_AMULET || tval == TV_RING || tval == TV_CHEST ||
 		   (tval == TV_HAFTED && sval == lookup_sval(tval, "Mighty Hammer")) ||
-		   (tval == TV_CROWN && sval == lookup_sval(tval, "Massive Iron Crown"))) {
+		   (tval == TV_CROWN && sval == lookup_sval(tval, "Massive Iron Crown")) ||
+		   !quota_tval_allowed(tval)) {
 		r = randint1(base_freq[z_info->k_max - 1]);
 		i = 0;
 		while (r > base_freq[i])
@@ -2711,95 +2894,114 @@ static void scramble_artifact(int a_idx)
 }
 
 /**
- * Return TRUE if the whole set of random artifacts meets certain
- * criteria.  Return FALSE if we fail to meet those criteria (which will
- * restart the whole process).
+ * Return TRUE if the set of random artifacts generated so far can still meet
+ * the slot type quota.  Return FALSE if it can't (which will restart the
+ * whole process).
  */
 static bool artifacts_acceptable(void)
 {
-	int swords = 5, polearms = 5, blunts = 5, bows = 4;
-	int bodies = 5, shields = 4, cloaks = 4, hats = 4;
-	int gloves = 4, boots = 4;
+	char types[256] = "";
 	int i;
 
-	for (i = 0; i < z_info->a_max; i++)
-	{
-		switch (a_info[i].tval)
-		{
-			case TV_SWORD:
-				swords--; break;
-			case TV_POLEARM:
-				polearms--; break;
-			case TV_HAFTED:
-				blunts--; break;
-			case TV_BOW:
-				bows--; break;
-			case TV_SOFT_ARMOR:
-			case TV_HARD_ARMOR:
-			case TV_DRAG_ARMOR:
-				bodies--; break;
-			case TV_SHIELD:
-				shields--; break;
-			case TV_CLOAK:
-				cloaks--; break;
-			case TV_HELM:
-			case TV_CROWN:
-				hats--; break;
-			case TV_GLOVES:
-				gloves--; break;
-			case TV_BOOTS:
-				boots--; break;
-		}
+	if (quota_need() <= quota_free)
+		return TRUE;
+
+	for (i = 0; i < ART_QUOTA_MAX; i++) {
+		if (quota_deficit[i] <= 0) continue;
+		file_putf(log_file, "Deficit amount for %s is %d\n", art_quota[i].name,
+				  quota_deficit[i]);
+		my_strcat(types, " ", sizeof(types));
+		my_strcat(types, art_quota[i].name, sizeof(types));
 	}
 
-	file_putf(log_file, "Deficit amount for swords is %d\n", swords);
-	file_putf(log_file, "Deficit amount for polearms is %d\n", polearms);
-	file_putf(log_file, "Deficit amount for blunts is %d\n", blunts);
-	file_putf(log_file, "Deficit amount for bows is %d\n", bows);
-	file_putf(log_file, "Deficit amount for bodies is %d\n", bodies);
-	file_putf(log_file, "Deficit amount for shields is %d\n", shields);
-	file_putf(log_file, "Deficit amount for cloaks is %d\n", cloaks);
-	file_putf(log_file, "Deficit amount for hats is %d\n", hats);
-	file_putf(log_file, "Deficit amount for gloves is %d\n", gloves);
-	file_putf(log_file, "Deficit amount for boots is %d\n", boots);
-
-	if (swords > 0 || polearms > 0 || blunts > 0 || bows > 0 ||
-	    bodies > 0 || shields > 0 || cloaks > 0 || hats > 0 ||
-	    gloves > 0 || boots > 0) {
-		if (verbose) {
-			char types[256];
-			strnfmt(types, sizeof(types), "%s%s%s%s%s%s%s%s%s%s",
-					swords > 0 ? " swords" : "",
-					polearms > 0 ? " polearms" : "",
-					blunts > 0 ? " blunts" : "",
-					bows > 0 ? " bows" : "",
-					bodies > 0 ? " body-armors" : "",
-					shields > 0 ? " shields" : "",
-					cloaks > 0 ? " cloaks" : "",
-					hats > 0 ? " hats" : "",
-					gloves > 0 ? " gloves" : "",
-					boots > 0 ? " boots" : "");
-
-			file_putf(log_file, "Restarting generation process: not enough%s",
-					  types);
-		}
-		return FALSE;
-	} else
-		return TRUE;
+	if (verbose)
+		file_putf(log_file, "Restarting generation process: not enough%s\n",
+				  types);
+
+	return FALSE;
 }
 
 /**
  * Scramble each artifact
+ *
+ * The slot type quota is tracked as the set is built.  Once the artifacts
+ * left to generate are only just enough to fill it, their base items are
+ * restricted to the types still short; if the set can't be completed it is
+ * abandoned immediately rather than after generating the rest.
  */
 static errr scramble(void)
 {
+	clock_t start = clock();
+	int sets = 0, generated = 0, retargeted = 0;
+	bool done = FALSE;
+
 	/* If our artifact set fails to meet certain criteria, we start over. */
-	do {
+	while (!done) {
 		int a_idx;
 
+		sets++;
+		quota_init();
+
+		/* Artifacts which keep their base item never change, so if the
+		 * rest can't fill the quota no set ever will */
+		if (!artifacts_acceptable()) {
+			file_putf(log_file, "Quota can't be filled - ignoring it\n");
+			memset(quota_deficit, 0, sizeof(quota_deficit));
+		}
+		done = TRUE;
+
+		/* Generate all the artifacts. */
+		for (a_idx = 1; done && a_idx < z_info->a_max; a_idx++) {
+			bool rerolled = artifact_is_rerolled(a_idx);
+
+			/* Restrict the base item if every free artifact is needed */
+			quota_retarget = rerolled && quota_need() >= quota_free;
+			if (quota_retarget) retargeted++;
+
+			Rand_value = randart_stream_seed(sets, a_idx);
+			scramble_artifact(a_idx);
+			generated++;
+
+			if (rerolled) {
+				quota_count(a_idx);
+				done = artifacts_acceptable();
+			}
+		}
+	}
+	quota_retarget = FALSE;
+
+	file_putf(log_file, "Generated %d artifacts (%d retargeted) in %d set%s, "
+			  "taking %ld ms\n", generated, retargeted, sets,
+			  PLURAL(sets),
+			  (long)((clock() - start) * 1000 / CLOCKS_PER_SEC));
+
+	/* Success */
+	return (0);
+}
+
+/**
+ * Scramble each artifact the way sets were made before the quota was tracked
+ * during generation: from one RNG stream, checking the whole set at the end.
+ * Savefiles from then keep only the seed, so they need this to get their
+ * artifacts back.
+ */
+static errr scramble_single_stream(void)
+{
+	do {
+		int a_idx, i;
+
 		/* Generate all the artifacts. */
 		for (a_idx = 1; a_idx < z_info->a_max; a_idx++)
 			scramble_artifact(a_idx);
+
+		/* Count the whole set towards the quota */
+		for (i = 0; i < ART_QUOTA_MAX; i++)
+			quota_deficit[i] = art_quota[i].min;
+		quota_free = 0;
+		for (i = 0; i < z_info->a_max; i++) {
+			int group = quota_group(a_info[i].tval);
+			if (group >= 0) quota_deficit[group]--;
+		}
 	} while (!artifacts_acceptable());
 
 	/* Success */
@@ -2860,7 +3062,7 @@ static errr init_names(void)
 /**
  * Call the name allocation and artifact scrambling routines
  */
-static errr do_randart_aux(bool full)
+static errr do_randart_aux(bool full, bool single_stream)
 {
 	errr result;
 
@@ -2868,7 +3070,9 @@ static errr do_randart_aux(bool full)
 	if ((result = init_names()) != 0) return (result);
 
 	/* Randomize the artifacts */
-	if (full)
+	if (full && single_stream)
+		if ((result = scramble_single_stream()) != 0) return (result);
+	if (full && !single_stream)
 		if ((result = scramble()) != 0) return (result);
 
 	/* Success */
@@ -2880,15 +3084,18 @@ static errr do_randart_aux(bool full)
  * Randomize the artifacts
  *
  * The full flag toggles between just randomizing the names and
- * complete randomization of the artifacts.
+ * complete randomization of the artifacts; single_stream makes the set
+ * the way older versions did.
  */
-errr do_randart(u32b randart_seed, bool full)
+static errr do_randart_full(u32b randart_seed, bool full, bool single_stream)
 {
 	errr err;
 
 	/* Prepare to use the Angband "simple" RNG. */
 	Rand_value = randart_seed;
 	Rand_quick = TRUE;
+	randart_seed_base = randart_seed;
+	randart_single_stream = single_stream;
 
 	/* Only do all the following if full randomization requested */
 	if (full) {
@@ -2919,7 +3126,7 @@ errr do_randart(u32b randart_seed, bool full)
 	}
 
 	/* Generate the random artifact (names) */
-	err = do_randart_aux(full);
+	err = do_randart_aux(full, single_stream);
 
 	/* Only do all the following if full randomization requested */
 	if (full) {
@@ -2951,3 +3158,20 @@ errr do_randart(u32b randart_seed, bool full)
 
 	return (err);
 }
+
+/**
+ * Randomize the artifacts, with each artifact drawn from its own stream
+ */
+errr do_randart(u32b randart_seed, bool full)
+{
+	return do_randart_full(randart_seed, full, FALSE);
+}
+
+/**
+ * Randomize the artifacts as versions before per-artifact streams did, for
+ * savefiles made by them
+ */
+errr do_randart_single_stream(u32b randart_seed, bool full)
+{
+	return do_randart_full(randart_seed, full, TRUE);
+}
@@ -160,7 +160,10 @@ enum {
 	ART_IDX_TOTAL
 };
 
+extern bool randart_single_stream;
+
 char *artifact_gen_name(struct artifact *a, const char ***wordlist);
 errr do_randart(u32b randart_seed, bool full);
+errr do_randart_single_stream(u32b randart_seed, bool full);
 
 #endif /* OBJECT_RANDART_H */
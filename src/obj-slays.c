@@ -383,7 +383,10 @@ struct slay *slay_collect(const object_type *obj1, const object_type *obj2,
 
 /**
  * React to slays which hurt a monster
- * 
+ *
+ * Slays are either of a race flag or, with no race flag, of a monster base
+ * by name; only the latter need a string comparison.
+ *
  * \param slay is the slay we're testing for effectiveness
  * \param mon is the monster we're testing for being slain
  */
@@ -393,8 +396,8 @@ bool react_to_specific_slay(struct slay *slay, const struct monster *mon)
 	if (!mon->race->base) return FALSE;
 
 	/* Check the race flag */
-	if (rf_has(mon->race->flags, slay->race_flag))
-		return TRUE;
+	if (slay->race_flag)
+		return rf_has(mon->race->flags, slay->race_flag) ? TRUE : FALSE;
 
 	/* Check for monster base */
 	if (streq(slay->name, mon->race->base->name))
@@ -467,6 +470,11 @@ void object_notice_slays(object_type *o_ptr, const monster_type *m_ptr)
 /**
  * Extract the multiplier from a given object hitting a given monster.
  *
+ * Each list is walked once, choosing the best modifier by multiplier alone;
+ * the verb is only made for the final choice, and noticing runes and
+ * teaching the monster's lore are done once per list rather than once per
+ * brand or slay that applies.
+ *
  * \param o_ptr is the object being used to attack
  * \param m_ptr is the monster being attacked
  * \param brand_used is the brand that gave the best multiplier, or NULL
@@ -483,38 +491,38 @@ void improve_attack_modifier(object_type *o_ptr, const monster_type *m_ptr,
 							 char *verb, bool range, bool real, bool known_only)
 {
 	monster_lore *l_ptr = get_lore(m_ptr->race);
+	bool visible = mflag_has(m_ptr->mflag, MFLAG_VISIBLE) ? TRUE : FALSE;
+	bitflag learn[RF_SIZE];
+	const struct brand *best_brand = NULL;
+	const struct slay *best_slay = NULL;
+	bool notice_brands = FALSE, notice_slays = FALSE;
 	struct brand *b;
 	struct slay *s;
 	int best_mult = 1;
 
+	rf_wipe(learn);
+
 	/* Brands */
 	for (b = o_ptr->brands; b; b = b->next) {
+		int resist_flag = brand_names[b->element].resist_flag;
+
 		if (known_only && !b->known) continue;
 
 		/* If the monster is vulnerable, record and learn from real attacks */
-		if (!rf_has(m_ptr->race->flags,
-					brand_names[b->element].resist_flag)) {
+		if (!rf_has(m_ptr->race->flags, resist_flag)) {
 			if (best_mult < b->multiplier) {
 				best_mult = b->multiplier;
-				*brand_used = b;
-				if (b->multiplier < 3)
-					my_strcpy(verb, brand_names[b->element].melee_verb_weak, 
-							  20);
-				else
-					my_strcpy(verb, brand_names[b->element].melee_verb, 20);
-				if (range)
-					my_strcat(verb, "s", 20);
+				best_brand = b;
 			}
 			if (real) {
-				object_notice_brands(o_ptr, m_ptr);
-				if (mflag_has(m_ptr->mflag, MFLAG_VISIBLE))
-					rf_on(l_ptr->flags, brand_names[b->element].resist_flag);
+				notice_brands = TRUE;
+				rf_on(learn, resist_flag);
 			}
 		}
 
 		/* Brand is known, attack is real, learn about the monster */
-		if (b->known && mflag_has(m_ptr->mflag, MFLAG_VISIBLE) && real)
-			rf_on(l_ptr->flags, brand_names[b->element].resist_flag);
+		if (b->known && real)
+			rf_on(learn, resist_flag);
 	}
 
 	/* Slays */
@@ -525,30 +533,52 @@ void improve_attack_modifier(object_type *o_ptr, const monster_type *m_ptr,
 		if (react_to_specific_slay(s, m_ptr)) {
 			if (best_mult < s->multiplier) {
 				best_mult = s->multiplier;
-				*brand_used = NULL;
-				*slay_used = s;
-				if (range) {
-					if (s->multiplier <= 3)
-						my_strcpy(verb, "pierces", 20);
-					else
-						my_strcpy(verb, "deeply pierces", 20);
-				} else {
-					if (s->multiplier <= 3)
-						my_strcpy(verb, "smite", 20);
-					else
-						my_strcpy(verb, "fiercely smite", 20);
-				}
+				best_brand = NULL;
+				best_slay = s;
 			}
 			if (real) {
-				object_notice_slays(o_ptr, m_ptr);
-				if (mflag_has(m_ptr->mflag, MFLAG_VISIBLE))
-					rf_on(l_ptr->flags, s->race_flag);
+				notice_slays = TRUE;
+				if (s->race_flag) rf_on(learn, s->race_flag);
 			}
 		}
 
 		/* Slay is known, attack is real, learn about the monster */
-		if (s->known && mflag_has(m_ptr->mflag, MFLAG_VISIBLE) && real)
-			rf_on(l_ptr->flags, s->race_flag);
+		if (s->known && real && s->race_flag)
+			rf_on(learn, s->race_flag);
+	}
+
+	/* Learn about the object and the monster */
+	if (notice_brands)
+		object_notice_brands(o_ptr, m_ptr);
+	if (notice_slays)
+		object_notice_slays(o_ptr, m_ptr);
+	if (visible)
+		rf_union(l_ptr->flags, learn);
+
+	/* Describe the attack */
+	if (best_slay) {
+		*brand_used = NULL;
+		*slay_used = best_slay;
+		if (range) {
+			if (best_slay->multiplier <= 3)
+				my_strcpy(verb, "pierces", 20);
+			else
+				my_strcpy(verb, "deeply pierces", 20);
+		} else {
+			if (best_slay->multiplier <= 3)
+				my_strcpy(verb, "smite", 20);
+			else
+				my_strcpy(verb, "fiercely smite", 20);
+		}
+	} else if (best_brand) {
+		*brand_used = best_brand;
+		if (best_brand->multiplier < 3)
+			my_strcpy(verb, brand_names[best_brand->element].melee_verb_weak,
+					  20);
+		else
+			my_strcpy(verb, brand_names[best_brand->element].melee_verb, 20);
+		if (range)
+			my_strcat(verb, "s", 20);
 	}
 }
 
@@ -621,19 +621,23 @@ static void print_error(struct file_parser *fp, struct parser *p) {
 }
 
 errr run_parser(struct file_parser *fp) {
+	int old_tag = mem_tag_set(MEM_TAG_PARSER);
 	struct parser *p = fp->init();
 	errr r;
 	if (!p) {
+		mem_tag_set(old_tag);
 		return PARSE_ERROR_GENERIC;
 	}
 	r = fp->run(p);
 	if (r) {
 		print_error(fp, p);
+		mem_tag_set(old_tag);
 		return r;
 	}
 	r = fp->finish(p);
 	if (r)
 		print_error(fp, p);
+	mem_tag_set(old_tag);
 	return r;
 }
 
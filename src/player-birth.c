@@ -462,17 +462,13 @@ void wield_all(struct player *p)
 
 
 /**
- * Init players with some belongings
- *
- * Having an item identifies it and makes the player "aware" of its purpose.
+ * Give the player the body of their race, with empty equipment slots
  */
-static void player_outfit(struct player *p)
+void player_embody(struct player *p)
 {
 	char buf[80];
 	int i;
-	const struct start_item *si;
 
-	/* Player needs a body */
 	memcpy(&p->body, &bodies[p->race->body], sizeof(p->body));
 	my_strcpy(buf, bodies[p->race->body].name, sizeof(buf));
 	p->body.name = string_make(buf);
@@ -482,6 +478,19 @@ static void player_outfit(struct player *p)
 		my_strcpy(buf, bodies[p->race->body].slots[i].name, sizeof(buf));
 		p->body.slots[i].name = string_make(buf);
 	}
+}
+
+/**
+ * Init players with some belongings
+ *
+ * Having an item identifies it and makes the player "aware" of its purpose.
+ */
+static void player_outfit(struct player *p)
+{
+	const struct start_item *si;
+
+	/* Player needs a body */
+	player_embody(p);
 
 	/* Currently carrying nothing */
 	p->upkeep->total_weight = 0;
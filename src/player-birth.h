@@ -25,6 +25,7 @@ extern void player_init(struct player *p);
 extern void player_generate(struct player *p, const struct player_race *r,
                             const struct player_class *c);
 extern char *get_history(struct history_chart *h);
+extern void player_embody(struct player *p);
 extern void wield_all(struct player *p);
 
 void do_cmd_birth_init(struct command *cmd);
@@ -2366,11 +2366,13 @@ void update_stuff(struct player *p)
 	if (p->upkeep->update & (PU_INVEN)) {
 		p->upkeep->update &= ~(PU_INVEN);
 		update_inventory(p);
+		p->upkeep->version++;
 	}
 
 	if (p->upkeep->update & (PU_BONUS)) {
 		p->upkeep->update &= ~(PU_BONUS);
 		update_bonuses(p);
+		p->upkeep->version++;
 	}
 
 	if (p->upkeep->update & (PU_TORCH)) {
@@ -2406,7 +2408,9 @@ void update_stuff(struct player *p)
 
 	if (p->upkeep->update & (PU_UPDATE_VIEW)) {
 		p->upkeep->update &= ~(PU_UPDATE_VIEW);
+		turn_timer_start(TIMER_VIEW);
 		update_view(cave, p);
+		turn_timer_stop(TIMER_VIEW);
 	}
 
 
@@ -2417,7 +2421,9 @@ void update_stuff(struct player *p)
 
 	if (p->upkeep->update & (PU_UPDATE_FLOW)) {
 		p->upkeep->update &= ~(PU_UPDATE_FLOW);
+		turn_timer_start(TIMER_FLOW);
 		cave_update_flow(cave);
+		turn_timer_stop(TIMER_FLOW);
 	}
 
 
@@ -2496,6 +2502,8 @@ void redraw_stuff(struct player *p)
 	/* Map is not shown, no screen updates */
 	if (!map_is_visible()) return;
 
+	turn_timer_start(TIMER_REDRAW);
+
 	/* For each listed flag, send the appropriate signal to the UI */
 	for (i = 0; i < N_ELEMENTS(redraw_events); i++) {
 		const struct flag_event_trigger *hnd = &redraw_events[i];
@@ -2517,6 +2525,8 @@ void redraw_stuff(struct player *p)
 	 * is over.
 	 */
 	event_signal(EVENT_END);
+
+	turn_timer_stop(TIMER_REDRAW);
 }
 
 
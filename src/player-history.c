@@ -44,6 +44,32 @@ static size_t history_ctr;
 /* Current size of history list */
 static size_t history_size;
 
+/**
+ * What the history says about each artifact, by artifact index, so that
+ * artifact queries don't have to search the list
+ */
+struct history_artifact {
+	u16b last;		/* The latest entry for the artifact, + 1; 0 for none */
+	u16b known;		/* Number of its entries marked as known */
+	u16b logged;	/* Number of its entries not marked as lost */
+};
+
+static struct history_artifact *history_artifacts;
+
+/**
+ * Count an entry in, or out of, the artifact index.
+ */
+static void history_index_entry(size_t i, bool add)
+{
+	struct history_artifact *art = &history_artifacts[history_list[i].a_idx];
+	int d = add ? 1 : -1;
+
+	if (hist_has(history_list[i].type, HIST_ARTIFACT_KNOWN))
+		art->known += d;
+	if (!hist_has(history_list[i].type, HIST_ARTIFACT_LOST))
+		art->logged += d;
+}
+
 /**
  * Initialise an empty history list.
  */
@@ -52,6 +78,7 @@ static void history_init(size_t entries)
 	history_ctr = 0;
 	history_size = entries;
 	history_list = mem_zalloc(history_size * sizeof(struct history_info));
+	history_artifacts = mem_zalloc(256 * sizeof(struct history_artifact));
 }
 
 
@@ -63,7 +90,9 @@ void history_clear(void)
 	if (!history_list) return;
 
 	mem_free(history_list);
+	mem_free(history_artifacts);
 	history_list = NULL;
+	history_artifacts = NULL;
 	history_ctr = 0;
 	history_size = 0;
 }
@@ -102,18 +131,19 @@ size_t history_get_num(void)
  */
 static bool history_know_artifact(struct artifact *artifact)
 {
-	size_t i = history_ctr;
+	size_t i;
 	assert(artifact);
 
-	while (i--) {
-		if (history_list[i].a_idx == artifact->aidx) {
-			hist_wipe(history_list[i].type);
-			hist_on(history_list[i].type, HIST_ARTIFACT_KNOWN);
-			return TRUE;
-		}
-	}
+	if (!history_list || !history_artifacts[(byte) artifact->aidx].last)
+		return FALSE;
 
-	return FALSE;
+	i = history_artifacts[(byte) artifact->aidx].last - 1;
+	history_index_entry(i, FALSE);
+	hist_wipe(history_list[i].type);
+	hist_on(history_list[i].type, HIST_ARTIFACT_KNOWN);
+	history_index_entry(i, TRUE);
+
+	return TRUE;
 }
 
 
@@ -123,14 +153,14 @@ static bool history_know_artifact(struct artifact *artifact)
  */
 bool history_lose_artifact(struct artifact *artifact)
 {
-	size_t i = history_ctr;
 	assert(artifact);
 
-	while (i--) {
-		if (history_list[i].a_idx == artifact->aidx) {
-			hist_on(history_list[i].type, HIST_ARTIFACT_LOST);
-			return TRUE;
-		}
+	if (history_list && history_artifacts[(byte) artifact->aidx].last) {
+		size_t i = history_artifacts[(byte) artifact->aidx].last - 1;
+		history_index_entry(i, FALSE);
+		hist_on(history_list[i].type, HIST_ARTIFACT_LOST);
+		history_index_entry(i, TRUE);
+		return TRUE;
 	}
 
 	/* If we lost an artifact that didn't previously have a history, then we
@@ -168,6 +198,10 @@ bool history_add_full(bitflag *type, struct artifact *artifact, s16b dlev,
 	my_strcpy(history_list[history_ctr].event,
 	          text, sizeof(history_list[history_ctr].event));
 
+	/* Index it by artifact */
+	history_index_entry(history_ctr, TRUE);
+	history_artifacts[history_list[history_ctr].a_idx].last = history_ctr + 1;
+
 	history_ctr++;
 
 	return TRUE;
@@ -196,16 +230,10 @@ bool history_add(const char *event, int type, struct artifact *artifact)
  */
 bool history_is_artifact_known(struct artifact *artifact)
 {
-	size_t i = history_ctr;
 	assert(artifact);
 
-	while (i--) {
-		if (hist_has(history_list[i].type, HIST_ARTIFACT_KNOWN) &&
-				history_list[i].a_idx == artifact->aidx)
-			return TRUE;
-	}
-
-	return FALSE;
+	if (!history_list) return FALSE;
+	return history_artifacts[(byte) artifact->aidx].known > 0;
 }
 
 
@@ -217,20 +245,12 @@ bool history_is_artifact_known(struct artifact *artifact)
  */
 static bool history_is_artifact_logged(struct artifact *artifact)
 {
-	size_t i = history_ctr;
 	assert(artifact);
 
-	while (i--) {
-		/* Don't count ARTIFACT_LOST entries; then we can handle
-		 * re-finding previously lost artifacts in preserve mode  */
-		if (hist_has(history_list[i].type, HIST_ARTIFACT_LOST))
-			continue;
-
-		if (history_list[i].a_idx == artifact->aidx)
-			return TRUE;
-	}
-
-	return FALSE;
+	/* Don't count ARTIFACT_LOST entries; then we can handle
+	 * re-finding previously lost artifacts in preserve mode  */
+	if (!history_list) return FALSE;
+	return history_artifacts[(byte) artifact->aidx].logged > 0;
 }
 
 
@@ -294,8 +314,10 @@ void history_unmask_unknown(void)
 
 	while (i--) {
 		if (hist_has(history_list[i].type, HIST_ARTIFACT_UNKNOWN)) {
+			history_index_entry(i, FALSE);
 			hist_off(history_list[i].type, HIST_ARTIFACT_UNKNOWN);
 			hist_on(history_list[i].type, HIST_ARTIFACT_KNOWN);
+			history_index_entry(i, TRUE);
 		}
 	}
 }
@@ -528,7 +528,7 @@ static void spell_append_value_info(int spell, char *p, size_t len)
 	type = effect_info(sp->effect);
 
 	if (sp->effect->dice != NULL)
-		dice_roll(sp->effect->dice, &rv);
+		dice_random_value(sp->effect->dice, &rv);
 
 	/* Handle some special cases where we want to append some additional info */
 	switch (sp->effect->index) {
@@ -473,6 +473,10 @@ typedef struct player_upkeep {
 	int inven_cnt;				/* Number of items in inventory */
 	int equip_cnt;				/* Number of items in equipment */
 	int quiver_cnt;				/* Number of items in the quiver */
+
+	u32b version;				/* Bumped whenever a command runs or the
+								 * player's state is recalculated, so
+								 * cached descriptions know to rebuild */
 } player_upkeep;
 
 
@@ -20,6 +20,7 @@
 #include "cave.h"
 #include "game-event.h"
 #include "game-input.h"
+#include "game-world.h"
 #include "generate.h"
 #include "init.h"
 #include "mon-util.h"
@@ -621,6 +622,8 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 	/* Flush any pending output */
 	handle_stuff(player);
 
+	turn_timer_start(TIMER_PROJECT);
+
 	/* No projection path - jump to target */
 	if (flg & (PROJECT_JUMP)) {
 		source = loc(x, y);
@@ -1039,6 +1042,8 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 		sqinfo_off(cave->squares[y][x].info, SQUARE_PROJECT);
 	}
 
+	turn_timer_stop(TIMER_PROJECT);
+
 	/* Update stuff if needed */
 	if (player->upkeep->update)
 		update_stuff(player);
@@ -19,6 +19,7 @@
 #include "angband.h"
 #include "cave.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "mon-lore.h"
 #include "mon-make.h"
@@ -27,6 +28,7 @@
 #include "obj-pile.h"
 #include "obj-gear.h"
 #include "obj-ignore.h"
+#include "obj-randart.h"
 #include "option.h"
 #include "player.h"
 #include "savefile.h"
@@ -527,8 +529,9 @@ void wr_ignore(void)
 
 void wr_misc(void)
 {
-	/* Random artifact seed */
+	/* Random artifact seed, and how the artifacts were made from it */
 	wr_u32b(seed_randart);
+	wr_byte(randart_single_stream ? 1 : 0);
 
 	/* Write the "object seeds" */
 	wr_u32b(seed_flavor);
@@ -706,7 +709,7 @@ static void wr_dungeon_aux(struct chunk *c)
 }
 
 /**
- * Write the dungeon floor objects
+ * Write the dungeon floor objects; no chunk writes an empty list
  */
 static void wr_objects_aux(struct chunk *c)
 {
@@ -717,7 +720,7 @@ static void wr_objects_aux(struct chunk *c)
 		return;
 	
 	/* Write the objects */
-	for (y = 0; y < c->height; y++) {
+	for (y = 0; c && y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
 			struct object *obj = c->squares[y][x].obj;
 			while (obj) {
@@ -734,7 +737,7 @@ static void wr_objects_aux(struct chunk *c)
 }
 
 /**
- * Write the monster list
+ * Write the monster list; no chunk writes an empty list
  */
 static void wr_monsters_aux(struct chunk *c)
 {
@@ -744,16 +747,19 @@ static void wr_monsters_aux(struct chunk *c)
 		return;
 
 	/* Total monsters */
-	wr_u16b(cave_monster_max(c));
+	wr_u16b(c ? cave_monster_max(c) : 1);
 
 	/* Dump the monsters */
-	for (i = 1; i < cave_monster_max(c); i++) {
+	for (i = 1; c && i < cave_monster_max(c); i++) {
 		const monster_type *mon = cave_monster(c, i);
 
 		wr_monster(mon);
 	}
 }
 
+/**
+ * Write the traps; no chunk writes an empty list
+ */
 static void wr_traps_aux(struct chunk *c)
 {
     int x, y;
@@ -764,7 +770,7 @@ static void wr_traps_aux(struct chunk *c)
 
     wr_byte(TRF_SIZE);
 
-	for (y = 0; y < c->height; y++) {
+	for (y = 0; c && y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
 			struct trap *trap = c->squares[y][x].trap;
 			while (trap) {
@@ -780,8 +786,27 @@ static void wr_traps_aux(struct chunk *c)
 	mem_free(dummy);
 }
 
+/**
+ * Make a chunk holding the player's map memory, which is how the savefile
+ * keeps it; the map memory has no objects, monsters or traps, so only the
+ * terrain needs it
+ */
+static struct chunk *known_map_chunk(void)
+{
+	struct chunk *c = cave_new(known_map->height, known_map->width);
+	int y, x;
+
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			c->squares[y][x].feat = known_map_feat(known_map, y, x);
+
+	return c;
+}
+
 void wr_dungeon(void)
 {
+	struct chunk *known;
+
 	if (player->is_dead)
 		return;
 
@@ -794,7 +819,9 @@ void wr_dungeon(void)
 
 	/* Write caves */
 	wr_dungeon_aux(cave);
-	wr_dungeon_aux(cave_k);
+	known = known_map_chunk();
+	wr_dungeon_aux(known);
+	cave_free(known);
 
 	/* Compact the monsters */
 	compact_monsters(0);
@@ -804,19 +831,37 @@ void wr_dungeon(void)
 void wr_objects(void)
 {
 	wr_objects_aux(cave);
-	wr_objects_aux(cave_k);
+	wr_objects_aux(NULL);
 }
 
 void wr_monsters(void)
 {
 	wr_monsters_aux(cave);
-	wr_monsters_aux(cave_k);
+	wr_monsters_aux(NULL);
 }
 
 void wr_traps(void)
 {
 	wr_traps_aux(cave);
-	wr_traps_aux(cave_k);
+	wr_traps_aux(NULL);
+}
+
+/**
+ * Write a single chunk, as stored in the chunk list
+ */
+void wr_chunk(struct chunk *c)
+{
+	/* Write the terrain and info */
+	wr_dungeon_aux(c);
+
+	/* Write the objects */
+	wr_objects_aux(c);
+
+	/* Write the monsters */
+	wr_monsters_aux(c);
+
+	/* Write the traps */
+	wr_traps_aux(c);
 }
 
 /*
@@ -825,27 +870,21 @@ void wr_traps(void)
 void wr_chunks(void)
 {
 	int j;
+	u16b num = chunk_list_count();
 
 	if (player->is_dead)
 		return;
 
-	wr_u16b(chunk_list_max);
-
-	/* Now write each chunk */
-	for (j = 0; j < chunk_list_max; j++) {
-		struct chunk *c = chunk_list[j];
-
-		/* Write the terrain and info */
-		wr_dungeon_aux(c);
-
-		/* Write the objects */
-		wr_objects_aux(c);
+	wr_u16b(num);
 
-		/* Write the monsters */
-		wr_monsters_aux(c);
+	/* Now write each chunk; snapshots are already in the right form */
+	for (j = 0; j < num; j++) {
+		u32b i, size;
+		byte *block = chunk_list_snapshot(j, &size);
 
-		/* Write the traps */
-		wr_traps_aux(c);
+		for (i = 0; i < size; i++)
+			wr_byte(block[i]);
+		mem_free(block);
 	}
 }
 
@@ -108,7 +108,7 @@ static const struct {
 	{ "artifacts", wr_artifacts, 1 },
 	{ "player", wr_player, 1 },
 	{ "ignore", wr_ignore, 1 },
-	{ "misc", wr_misc, 1 },
+	{ "misc", wr_misc, 2 },
 	{ "player hp", wr_player_hp, 1 },
 	{ "player spells", wr_player_spells, 1 },
 	{ "gear", wr_gear, 1 },
@@ -135,7 +135,8 @@ static const struct blockinfo loaders[] = {
 	{ "artifacts", rd_artifacts, 1 },
 	{ "player", rd_player, 1 },
 	{ "ignore", rd_ignore, 1 },
-	{ "misc", rd_misc, 1 },
+	{ "misc", rd_misc_1, 1 },
+	{ "misc", rd_misc, 2 },
 	{ "player hp", rd_player_hp, 1 },
 	{ "player spells", rd_player_spells, 1 },
 	{ "gear", rd_gear, 1 },	
@@ -642,3 +643,72 @@ bool savefile_load(const char *path, bool cheat_death)
 
 	return ok;
 }
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Chunk snapshots
+ * ------------------------------------------------------------------------ */
+
+
+/**
+ * Write a chunk into a block of memory, in the form it takes in a savefile.
+ * The savefile buffer is put back afterwards, so this may be called in the
+ * middle of a save.
+ * \param c is the chunk
+ * \param size is set to the length of the block
+ * \return the block, to be freed with mem_free()
+ */
+byte *savefile_write_chunk(struct chunk *c, u32b *size)
+{
+	byte *old_buffer = buffer;
+	u32b old_size = buffer_size, old_pos = buffer_pos, old_check = buffer_check;
+	byte *block;
+
+	buffer = mem_alloc(BUFFER_INITIAL_SIZE);
+	buffer_size = BUFFER_INITIAL_SIZE;
+	buffer_pos = 0;
+	buffer_check = 0;
+
+	wr_chunk(c);
+
+	*size = buffer_pos;
+	block = mem_realloc(buffer, MAX(buffer_pos, 1));
+
+	buffer = old_buffer;
+	buffer_size = old_size;
+	buffer_pos = old_pos;
+	buffer_check = old_check;
+
+	return block;
+}
+
+/**
+ * Rebuild a chunk from a block made by savefile_write_chunk().
+ * \param block is the block
+ * \param size is the length of the block
+ * \return the chunk, or NULL if the block could not be read
+ */
+struct chunk *savefile_read_chunk(byte *block, u32b size)
+{
+	byte *old_buffer = buffer;
+	u32b old_size = buffer_size, old_pos = buffer_pos, old_check = buffer_check;
+	struct chunk *c = NULL;
+
+	buffer = block;
+	buffer_size = size;
+	buffer_pos = 0;
+	buffer_check = 0;
+
+	if (!size || rd_chunk_snapshot(&c) || buffer_pos != size) {
+		if (c) cave_free(c);
+		c = NULL;
+	}
+
+	buffer = old_buffer;
+	buffer_size = old_size;
+	buffer_pos = old_pos;
+	buffer_check = old_check;
+
+	return c;
+}
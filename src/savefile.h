@@ -44,6 +44,12 @@ bool savefile_load(const char *path, bool cheat_death);
  */
 const char *savefile_get_description(const char *path);
 
+/**
+ * Write a chunk to, or read it back from, a block of memory in savefile form.
+ */
+byte *savefile_write_chunk(struct chunk *c, u32b *size);
+struct chunk *savefile_read_chunk(byte *block, u32b size);
+
 
 /**
  * ------------------------------------------------------------------------
@@ -85,11 +91,14 @@ int rd_artifacts(void);
 int rd_player(void);
 int rd_ignore(void);
 int rd_misc(void);
+int rd_misc_1(void);
 int rd_player_hp(void);
 int rd_player_spells(void);
 int rd_gear(void);
 int rd_stores(void);
 int rd_dungeon(void);
+int rd_chunk(struct chunk **c);
+int rd_chunk_snapshot(struct chunk **c);
 int rd_chunks(void);
 int rd_objects(void);
 int rd_monsters(void);
@@ -115,6 +124,7 @@ void wr_randarts(void);
 void wr_gear(void);
 void wr_stores(void);
 void wr_dungeon(void);
+void wr_chunk(struct chunk *c);
 void wr_chunks(void);
 void wr_objects(void);
 void wr_monsters(void);
@@ -31,33 +31,284 @@ static long total_points(void)
 }
 
 
+/* ------------------ Score store ---------------- */
+
+/**
+ * The scores are kept in two files.  "scores.raw" holds the entries, in the
+ * order they were made, and "scores.idx" holds a key (points and entry
+ * number) for each of them sorted best first, the newest first among equal
+ * scores.  Places are found by binary search of the index, and the top
+ * scores are read through it without loading the rest, so the files can
+ * grow as large as they like.
+ *
+ * The index is remade whenever it is missing or doesn't hold one key for
+ * each entry - for a "scores.raw" from before the index, or one written by
+ * an older version, or after a failed update.
+ */
+#define SCORE_INDEX_MAGIC	"SIDX"
+#define SCORE_INDEX_HEADER	8
+#define SCORE_KEY_SIZE		8
+
+/**
+ * Number of keys copied at a time when rewriting the index
+ */
+#define SCORE_KEY_BLOCK		256
+
+struct score_key {
+	u32b pts;
+	u32b record;
+};
+
+static u32b score_get_u32b(const byte *b)
+{
+	return ((u32b) b[0] << 24) | ((u32b) b[1] << 16) | ((u32b) b[2] << 8) |
+		(u32b) b[3];
+}
+
+static void score_put_u32b(byte *b, u32b v)
+{
+	b[0] = (byte) (v >> 24);
+	b[1] = (byte) (v >> 16);
+	b[2] = (byte) (v >> 8);
+	b[3] = (byte) v;
+}
+
+static void score_put_key(byte *b, const struct score_key *key)
+{
+	score_put_u32b(b, key->pts);
+	score_put_u32b(b + 4, key->record);
+}
+
+/**
+ * Points of a score entry, for sorting
+ */
+static u32b score_points(const high_score *entry)
+{
+	return strtoul(entry->pts, NULL, 0);
+}
+
+/**
+ * Best scores first; among equal scores, the newest first
+ */
+static int score_key_cmp(const void *a, const void *b)
+{
+	const struct score_key *ka = a;
+	const struct score_key *kb = b;
+
+	if (ka->pts != kb->pts) return (ka->pts > kb->pts) ? -1 : 1;
+	if (ka->record != kb->record) return (ka->record > kb->record) ? -1 : 1;
+	return 0;
+}
+
+/**
+ * Number of entries in the scores file, or 0 if there is none
+ */
+static u32b score_raw_count(const char *raw_name)
+{
+	u32b size, mtime;
+
+	if (!file_stat(raw_name, &size, &mtime)) return 0;
+	return size / sizeof(high_score);
+}
+
+/**
+ * Write an index header
+ */
+static bool score_index_write_header(ang_file *f, u32b count)
+{
+	byte header[SCORE_INDEX_HEADER];
+
+	memcpy(header, SCORE_INDEX_MAGIC, 4);
+	score_put_u32b(header + 4, count);
+	return file_write(f, (const char *) header, sizeof(header));
+}
+
+/**
+ * Make the index for a scores file.
+ */
+static bool score_index_build(const char *raw_name, const char *idx_name)
+{
+	ang_file *raw, *idx;
+	struct score_key *keys = NULL;
+	size_t count = 0, alloc = 0, i;
+	high_score entry;
+	bool ok;
+
+	raw = file_open(raw_name, MODE_READ, FTYPE_RAW);
+	if (!raw) return FALSE;
+
+	while (file_read(raw, (char *) &entry, sizeof(entry)) ==
+		   (int) sizeof(entry)) {
+		if (count == alloc) {
+			alloc = alloc ? alloc * 2 : MAX_HISCORES;
+			keys = mem_realloc(keys, alloc * sizeof(*keys));
+		}
+		keys[count].pts = score_points(&entry);
+		keys[count].record = count;
+		count++;
+	}
+	file_close(raw);
+
+	if (count)
+		sort(keys, count, sizeof(*keys), score_key_cmp);
+
+	safe_setuid_grab();
+	idx = file_open(idx_name, MODE_WRITE, FTYPE_RAW);
+	safe_setuid_drop();
+	if (!idx) {
+		mem_free(keys);
+		return FALSE;
+	}
+
+	ok = score_index_write_header(idx, count);
+	for (i = 0; ok && i < count; i++) {
+		byte b[SCORE_KEY_SIZE];
+		score_put_key(b, &keys[i]);
+		ok = file_write(idx, (const char *) b, sizeof(b));
+	}
+	file_close(idx);
+	mem_free(keys);
+
+	return ok;
+}
+
+/**
+ * Open an index, if it is one.
+ * \param count is set to the number of keys
+ */
+static ang_file *score_index_read(const char *idx_name, u32b *count)
+{
+	byte header[SCORE_INDEX_HEADER];
+	ang_file *idx = file_open(idx_name, MODE_READ, FTYPE_RAW);
+
+	if (!idx) return NULL;
+
+	if (file_read(idx, (char *) header, sizeof(header)) !=
+		(int) sizeof(header) || memcmp(header, SCORE_INDEX_MAGIC, 4)) {
+		file_close(idx);
+		return NULL;
+	}
+
+	*count = score_get_u32b(header + 4);
+	return idx;
+}
+
+/**
+ * Open the score index for reading, remaking it first if need be.
+ * \param count is set to the number of scores
+ * \return the open index, or NULL if there are no scores
+ */
+static ang_file *score_index_open(u32b *count)
+{
+	char raw_name[1024];
+	char idx_name[1024];
+	ang_file *idx;
+	u32b records;
+
+	*count = 0;
+	path_build(raw_name, sizeof(raw_name), ANGBAND_DIR_APEX, "scores.raw");
+	path_build(idx_name, sizeof(idx_name), ANGBAND_DIR_APEX, "scores.idx");
+
+	records = score_raw_count(raw_name);
+	if (!records) return NULL;
+
+	/* Use the index if it matches the scores */
+	idx = score_index_read(idx_name, count);
+	if (idx && *count == records) return idx;
+	if (idx) file_close(idx);
+
+	/* Otherwise remake it */
+	*count = 0;
+	if (!score_index_build(raw_name, idx_name)) return NULL;
+	idx = score_index_read(idx_name, count);
+	if (idx && *count != records) {
+		file_close(idx);
+		idx = NULL;
+		*count = 0;
+	}
+
+	return idx;
+}
+
+/**
+ * Read the key at a place in the index
+ */
+static bool score_index_key(ang_file *idx, u32b place, struct score_key *key)
+{
+	byte b[SCORE_KEY_SIZE];
+
+	if (!file_seek(idx, SCORE_INDEX_HEADER + place * SCORE_KEY_SIZE))
+		return FALSE;
+	if (file_read(idx, (char *) b, sizeof(b)) != (int) sizeof(b))
+		return FALSE;
+
+	key->pts = score_get_u32b(b);
+	key->record = score_get_u32b(b + 4);
+	return TRUE;
+}
+
 /**
- * Read in a highscore file.
+ * Find the place a new score with the given points would take in the index:
+ * before every score it equals or beats.
+ */
+static u32b score_index_find(ang_file *idx, u32b count, u32b pts)
+{
+	u32b lo = 0, hi = count;
+
+	while (lo < hi) {
+		u32b mid = lo + (hi - lo) / 2;
+		struct score_key key;
+
+		if (!score_index_key(idx, mid, &key)) return mid;
+		if (key.pts <= pts)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return lo;
+}
+
+/**
+ * Read in the best scores, best first.
+ * \return the number read
  */
 size_t highscore_read(high_score scores[], size_t sz)
 {
 	char fname[1024];
-	ang_file *scorefile;
+	ang_file *idx, *raw;
+	u32b count;
 	size_t i;
 
 	/* Wipe current scores */
 	memset(scores, 0, sz * sizeof(high_score));
 
+	idx = score_index_open(&count);
+	if (!idx) return 0;
+
 	path_build(fname, sizeof(fname), ANGBAND_DIR_APEX, "scores.raw");
-	scorefile = file_open(fname, MODE_READ, FTYPE_TEXT);
+	raw = file_open(fname, MODE_READ, FTYPE_RAW);
+	if (!raw) {
+		file_close(idx);
+		return 0;
+	}
 
-	if (!scorefile) return TRUE;
+	for (i = 0; i < sz && i < count; i++) {
+		struct score_key key;
 
-	for (i = 0; i < sz; i++)
-		if (file_read(scorefile, (char *)&scores[i], sizeof(high_score)) <= 0)
+		if (!score_index_key(idx, i, &key)) break;
+		if (!file_seek(raw, key.record * sizeof(high_score))) break;
+		if (file_read(raw, (char *) &scores[i], sizeof(high_score)) !=
+			(int) sizeof(high_score))
 			break;
+	}
 
-	file_close(scorefile);
+	file_close(raw);
+	file_close(idx);
 
 	return i;
 }
 
-
 /**
  * Just determine where a new score *would* be placed
  * Return the location (0 is best) or -1 on failure
@@ -65,22 +316,22 @@ size_t highscore_read(high_score scores[], size_t sz)
 size_t highscore_where(const high_score *entry, const high_score scores[],
 					   size_t sz)
 {
-	size_t i;
-
-	/* Read until we get to a higher score */
-	for (i = 0; i < sz; i++) {
-		long entry_pts = strtoul(entry->pts, NULL, 0);
-		long score_pts = strtoul(scores[i].pts, NULL, 0);
-
-		if (entry_pts >= score_pts)
-			return i;
-
-		if (scores[i].what[0] == '\0')
-			return i;
+	long entry_pts = strtoul(entry->pts, NULL, 0);
+	size_t lo = 0, hi = sz;
+
+	/* Find the first empty slot or score no higher than this one */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		long score_pts = strtoul(scores[mid].pts, NULL, 0);
+
+		if (scores[mid].what[0] == '\0' || entry_pts >= score_pts)
+			hi = mid;
+		else
+			lo = mid + 1;
 	}
 
 	/* The last entry is always usable */
-	return sz - 1;
+	return (lo < sz) ? lo : sz - 1;
 }
 
 size_t highscore_add(const high_score *entry, high_score scores[], size_t sz)
@@ -94,47 +345,60 @@ size_t highscore_add(const high_score *entry, high_score scores[], size_t sz)
 	return slot;
 }
 
-static size_t highscore_count(const high_score scores[], size_t sz)
+/**
+ * Copy keys from one index to another
+ */
+static bool score_index_copy(ang_file *from, ang_file *to, u32b start,
+							 u32b num)
 {
-	size_t i;
-	for (i = 0; i < sz; i++)
-		if (scores[i].what[0] == '\0')
-			break;
+	byte block[SCORE_KEY_BLOCK * SCORE_KEY_SIZE];
 
-	return i;
-}
+	if (num && !file_seek(from, SCORE_INDEX_HEADER + start * SCORE_KEY_SIZE))
+		return FALSE;
 
+	while (num) {
+		u32b n = MIN(num, SCORE_KEY_BLOCK);
+		int len = n * SCORE_KEY_SIZE;
+
+		if (file_read(from, (char *) block, len) != len) return FALSE;
+		if (!file_write(to, (const char *) block, len)) return FALSE;
+		num -= n;
+	}
+
+	return TRUE;
+}
 
 /**
- * Actually place an entry into the high score file
- * Return the location (0 is best) or -1 on "failure"
+ * Add an entry to the high score files.  The entry goes on the end of the
+ * scores, and the index is copied with its key put in place.
+ * \return TRUE if the score was saved
  */
-static void highscore_write(const high_score scores[], size_t sz)
+bool highscore_write(const high_score *entry)
 {
-	size_t n;
-
 	ang_file *lok;
-	ang_file *scorefile;
-
-	char old_name[1024];
-	char cur_name[1024];
+	ang_file *raw;
+	ang_file *idx;
+	ang_file *new_idx;
+	u32b count, place;
+	struct score_key key;
+	byte b[SCORE_KEY_SIZE];
+	bool ok;
+
+	char raw_name[1024];
+	char idx_name[1024];
 	char new_name[1024];
 	char lok_name[1024];
 
-	path_build(old_name, sizeof(old_name), ANGBAND_DIR_APEX, "scores.old");
-	path_build(cur_name, sizeof(cur_name), ANGBAND_DIR_APEX, "scores.raw");
+	path_build(raw_name, sizeof(raw_name), ANGBAND_DIR_APEX, "scores.raw");
+	path_build(idx_name, sizeof(idx_name), ANGBAND_DIR_APEX, "scores.idx");
 	path_build(new_name, sizeof(new_name), ANGBAND_DIR_APEX, "scores.new");
 	path_build(lok_name, sizeof(lok_name), ANGBAND_DIR_APEX, "scores.lok");
 
 
-	/* Read in and add new score */
-	n = highscore_count(scores, sz);
-
-
 	/* Lock scores */
 	if (file_exists(lok_name)) {
 		msg("Lock file in place for scorefile; not writing.");
-		return;
+		return FALSE;
 	}
 
 	safe_setuid_grab();
@@ -144,43 +408,66 @@ static void highscore_write(const high_score scores[], size_t sz)
 
 	if (!lok) {
 		msg("Failed to create lock for scorefile; not writing.");
-		return;
+		return FALSE;
 	}
 
 
-	/* Open the new file for writing */
+	/* Find the place of the new score, making the index if need be; the
+	 * score's number is where it goes in the scores file */
+	idx = score_index_open(&count);
+	key.pts = score_points(entry);
+	key.record = score_raw_count(raw_name);
+	place = idx ? score_index_find(idx, count, key.pts) : 0;
+
+	/* Open the files for writing */
 	safe_setuid_grab();
-	scorefile = file_open(new_name, MODE_WRITE, FTYPE_RAW);
+	raw = file_open(raw_name, MODE_APPEND, FTYPE_RAW);
+	new_idx = file_open(new_name, MODE_WRITE, FTYPE_RAW);
 	safe_setuid_drop();
 
-	if (!scorefile) {
-		msg("Failed to open new scorefile for writing.");
+	if (!raw || !new_idx) {
+		msg("Failed to open scorefile for writing.");
 
+		if (raw) file_close(raw);
+		if (new_idx) file_close(new_idx);
+		if (idx) file_close(idx);
 		file_close(lok);
 		file_delete(lok_name);
-		return;
+		return FALSE;
 	}
 
-	file_write(scorefile, (const char *)scores, sizeof(high_score)*n);
-	file_close(scorefile);
+	/* Write the new index, then add the entry */
+	score_put_key(b, &key);
+	ok = score_index_write_header(new_idx, count + 1);
+	ok = ok && (!idx || score_index_copy(idx, new_idx, 0, place));
+	ok = ok && file_write(new_idx, (const char *) b, sizeof(b));
+	ok = ok && (!idx || score_index_copy(idx, new_idx, place, count - place));
+	ok = ok && file_write(raw, (const char *) entry, sizeof(high_score));
+	file_close(raw);
+	file_close(new_idx);
+	if (idx) file_close(idx);
 
 	/* Now move things around */
 	safe_setuid_grab();
 
-	if (file_exists(old_name) && !file_delete(old_name))
-		msg("Couldn't delete old scorefile");
-
-	if (file_exists(cur_name) && !file_move(cur_name, old_name))
-		msg("Couldn't move old scores.raw out of the way");
-
-	if (!file_move(new_name, cur_name))
-		msg("Couldn't rename new scorefile to scores.raw");
+	if (!ok) {
+		msg("Failed to write the new score.");
+		file_delete(new_name);
+	}
+	else if (file_exists(idx_name) && !file_delete(idx_name))
+		msg("Couldn't delete old score index");
+	else if (!file_move(new_name, idx_name))
+		msg("Couldn't rename new score index to scores.idx");
 
 	/* Remove the lock */
 	file_close(lok);
 	file_delete(lok_name);
 
 	safe_setuid_drop();
+
+	/* A score that didn't get into the index is picked up when it is next
+	 * remade */
+	return ok;
 }
 
 
@@ -262,13 +549,9 @@ void enter_score(time_t *death_time)
 		event_signal(EVENT_MESSAGE_FLUSH);
 	} else {
 		high_score entry;
-		high_score scores[MAX_HISCORES];
 
 		build_score(&entry, player->died_from, death_time);
-
-		highscore_read(scores, N_ELEMENTS(scores));
-		highscore_add(&entry, scores, N_ELEMENTS(scores));
-		highscore_write(scores, N_ELEMENTS(scores));
+		highscore_write(&entry);
 	}
 
 	/* Success */
@@ -20,7 +20,7 @@
 #define INCLUDED_SCORE_H
 
 /**
- * Maximum number of high scores in the high score file
+ * Maximum number of high scores shown at once
  */
 #define MAX_HISCORES    100
 
@@ -59,6 +59,7 @@ size_t highscore_read(high_score scores[], size_t sz);
 size_t highscore_where(const high_score *entry, const high_score scores[],
 					   size_t sz);
 size_t highscore_add(const high_score *entry, high_score scores[], size_t sz);
+bool highscore_write(const high_score *entry);
 void build_score(high_score *entry, const char *died_from, time_t *death_time);
 void enter_score(time_t *death_time);
 
@@ -0,0 +1,122 @@
+/* cave/chunks */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-quest.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+
+	/* Snapshots are written out as if for a player */
+	player_quests_reset(player);
+	player_generate(player, races, classes);
+	player_embody(player);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	chunk_list_free();
+	cleanup_angband();
+	return 0;
+}
+
+/* A small chunk with a recognisable pattern of walls */
+static struct chunk *pattern_chunk(const char *name, int depth, int seed)
+{
+	struct chunk *c = cave_new(6, 9);
+	int y, x;
+
+	c->name = string_make(name);
+	c->depth = depth;
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++) {
+			int feat = ((x * y + seed) % 3) ? FEAT_FLOOR : FEAT_GRANITE;
+			square_set_feat(c, y, x, feat);
+		}
+
+	return c;
+}
+
+static bool pattern_matches(struct chunk *c, int seed)
+{
+	int y, x;
+
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++) {
+			int feat = ((x * y + seed) % 3) ? FEAT_FLOOR : FEAT_GRANITE;
+			if (c->squares[y][x].feat != feat) return FALSE;
+		}
+
+	return TRUE;
+}
+
+/* Chunks are found by name and depth while they fit the budget */
+int test_find(void *state) {
+	struct chunk *c = pattern_chunk("Alpha", 3, 0);
+
+	chunk_list_add(c);
+	ptreq(chunk_find_name("Alpha"), c);
+	ptreq(chunk_find_depth(3), c);
+	ptreq(chunk_find_depth(4), NULL);
+	ptreq(chunk_find_name("Beta"), NULL);
+	require(chunk_find(c));
+	ok;
+}
+
+/* Over budget, old chunks are evicted and come back intact */
+int test_evict(void *state) {
+	struct chunk *beta, *alpha;
+	byte *block, *awake;
+	u32b size, awake_size;
+
+	chunk_list_budget = 0;
+	beta = pattern_chunk("Beta", 5, 1);
+	chunk_list_add(beta);
+
+	/* Alpha has gone to disk, leaving only the newest chunk live */
+	require(chunk_find(beta));
+	eq(chunk_list_count(), 2);
+
+	/* The saved form is the same whether or not the chunk is awake */
+	block = chunk_list_snapshot(0, &size);
+	require(block != NULL);
+	require(size > 0);
+
+	alpha = chunk_find_name("Alpha");
+	require(alpha != NULL);
+	require(!chunk_find(beta));
+	require(streq(alpha->name, "Alpha"));
+	eq(alpha->depth, 3);
+	eq(alpha->height, 6);
+	eq(alpha->width, 9);
+	require(pattern_matches(alpha, 0));
+	require(square_isfloor(alpha, 1, 1));
+	awake = chunk_list_snapshot(0, &awake_size);
+	eq(awake_size, size);
+	require(!memcmp(block, awake, size));
+	mem_free(awake);
+	mem_free(block);
+
+	beta = chunk_find_depth(5);
+	require(beta != NULL);
+	require(pattern_matches(beta, 1));
+
+	require(chunk_list_remove("Alpha"));
+	require(!chunk_list_remove("Alpha"));
+	eq(chunk_list_count(), 1);
+	chunk_list_budget = CHUNK_LIST_BUDGET;
+	ok;
+}
+
+const char *suite_name = "cave/chunks";
+struct test tests[] = {
+	{ "find", test_find },
+	{ "evict", test_evict },
+	{ NULL, NULL }
+};
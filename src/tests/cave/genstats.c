@@ -0,0 +1,136 @@
+/* cave/genstats */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "cmd-core.h"
+#include "generate.h"
+#include "init.h"
+#include "player.h"
+
+static char path[1024];
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+
+	/* Levels are made for a real player */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, "genstats-test.log");
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	gen_stats_on = FALSE;
+	file_delete(path);
+	cleanup_angband();
+	return 0;
+}
+
+/* Generate some levels at a depth */
+static void generate(int depth, int count) {
+	player->depth = depth;
+	while (count--)
+		cave_generate(&cave, player);
+}
+
+/* Dump the stats, and read back the levels count, the profile attempts and
+ * the room tries */
+static bool read_stats(unsigned long *levels, unsigned long *attempts,
+					   unsigned long *tries) {
+	char buf[1024];
+	ang_file *f = file_open(path, MODE_WRITE, FTYPE_TEXT);
+	int section = 0;
+
+	if (!f) return FALSE;
+	gen_stats_dump(f);
+	file_close(f);
+
+	*levels = *attempts = *tries = 0;
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
+	if (!f) return FALSE;
+	while (file_getl(f, buf, sizeof(buf))) {
+		unsigned long n;
+
+		if (sscanf(buf, "Levels generated: %lu", &n) == 1) *levels = n;
+		else if (prefix(buf, "Profile")) section = 1;
+		else if (prefix(buf, "Phase")) section = 2;
+		else if (prefix(buf, "Room")) section = 3;
+		else if (prefix(buf, "Rejected")) section = 4;
+
+		/* Names take up the first twenty columns */
+		else if (strlen(buf) > 20 && sscanf(buf + 20, "%lu", &n) == 1) {
+			if (section == 1) *attempts += n;
+			else if (section == 3) *tries += n;
+		}
+	}
+	file_close(f);
+
+	return TRUE;
+}
+
+int test_off(void *state) {
+	unsigned long levels, attempts, tries;
+
+	gen_stats_on = FALSE;
+	gen_stats_reset();
+	generate(5, 2);
+	require(read_stats(&levels, &attempts, &tries));
+	eq(levels, 0);
+	eq(attempts, 0);
+	eq(tries, 0);
+	ok;
+}
+
+int test_count(void *state) {
+	unsigned long levels, attempts, tries;
+
+	gen_stats_on = TRUE;
+	gen_stats_reset();
+	generate(5, 3);
+	generate(20, 3);
+	require(read_stats(&levels, &attempts, &tries));
+	eq(levels, 6);
+
+	/* Every level took at least one attempt, and had rooms tried */
+	require(attempts >= levels);
+	require(tries > 0);
+	ok;
+}
+
+int test_reset(void *state) {
+	unsigned long levels, attempts, tries;
+
+	gen_stats_on = TRUE;
+	gen_stats_reset();
+	require(read_stats(&levels, &attempts, &tries));
+	eq(levels, 0);
+	eq(attempts, 0);
+	eq(tries, 0);
+
+	generate(10, 1);
+	gen_stats_on = FALSE;
+	generate(10, 1);
+	require(read_stats(&levels, &attempts, &tries));
+	eq(levels, 1);
+	ok;
+}
+
+const char *suite_name = "cave/genstats";
+struct test tests[] = {
+	{ "off", test_off },
+	{ "count", test_count },
+	{ "reset", test_reset },
+	{ NULL, NULL }
+};
@@ -0,0 +1,71 @@
+/* cave/known */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	*state = known_map_new(6, 70);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	known_map_free(state);
+	return 0;
+}
+
+/* Grids are remembered one at a time, across word boundaries */
+int test_note(void *state) {
+	struct known_map *k = state;
+
+	require(!known_map_isknown(k, 2, 63));
+	eq(known_map_feat(k, 2, 63), FEAT_NONE);
+
+	known_map_note_feat(k, 2, 63, FEAT_GRANITE);
+	known_map_note_feat(k, 2, 64, FEAT_FLOOR);
+	require(known_map_isknown(k, 2, 63));
+	require(known_map_isknown(k, 2, 64));
+	require(!known_map_isknown(k, 2, 65));
+	require(!known_map_isknown(k, 3, 63));
+	eq(known_map_feat(k, 2, 63), FEAT_GRANITE);
+	eq(known_map_feat(k, 2, 64), FEAT_FLOOR);
+	ok;
+}
+
+/* Forgetting a grid leaves its neighbours alone */
+int test_forget(void *state) {
+	struct known_map *k = state;
+
+	known_map_forget(k, 2, 63);
+	require(!known_map_isknown(k, 2, 63));
+	eq(known_map_feat(k, 2, 63), FEAT_NONE);
+	require(known_map_isknown(k, 2, 64));
+	eq(known_map_feat(k, 2, 64), FEAT_FLOOR);
+	ok;
+}
+
+/* A whole chunk can be learnt at once, as for the town */
+int test_all(void *state) {
+	struct known_map *k = state;
+	struct chunk *c = cave_new(6, 70);
+
+	square_set_feat(c, 5, 69, FEAT_PERM);
+	known_map_note_all(k, c);
+	require(known_map_isknown(k, 0, 0));
+	require(known_map_isknown(k, 5, 69));
+	eq(known_map_feat(k, 5, 69), FEAT_PERM);
+	eq(known_map_feat(k, 2, 64), FEAT_NONE);
+	cave_free(c);
+	ok;
+}
+
+const char *suite_name = "cave/known";
+struct test tests[] = {
+	{ "note", test_note },
+	{ "forget", test_forget },
+	{ "all", test_all },
+	{ NULL, NULL }
+};
@@ -0,0 +1,77 @@
+/* cave/planes */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+
+int setup_tests(void **state) {
+	read_edit_files();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	return 0;
+}
+
+/* The feature that goes on a square for a given pass over the chunk */
+static int pattern_feat(int y, int x, int pass)
+{
+	return 1 + (y * 7 + x * 3 + pass) % (z_info->f_max - 1);
+}
+
+/* Check every square's plane bits against its feature's flags */
+static int check_planes(struct chunk *c, int pass)
+{
+	int y, x;
+
+	for (y = 0; y < c->height; y++) {
+		const u64b *floor = square_plane_row(c, PLANE_FLOOR, y);
+		const u64b *pass_row = square_plane_row(c, PLANE_PASSABLE, y);
+
+		for (x = 0; x < c->width; x++) {
+			int feat = pattern_feat(y, x, pass);
+			bool is_floor = tf_has(f_info[feat].flags, TF_FLOOR);
+			u64b bit = (u64b)1 << (x % PLANE_WORD_BITS);
+
+			eq(c->squares[y][x].feat, feat);
+			eq(square_isfloor(c, y, x), is_floor);
+			eq(square_ispassable(c, y, x), feat_is_passable(feat));
+			eq(square_isprojectable(c, y, x), feat_is_projectable(feat));
+			eq(square_isbright(c, y, x), feat_is_bright(feat));
+
+			/* And the rows agree with the squares */
+			eq((floor[x / PLANE_WORD_BITS] & bit) != 0, is_floor);
+			eq((pass_row[x / PLANE_WORD_BITS] & bit) != 0,
+			   feat_is_passable(feat));
+		}
+	}
+
+	return 0;
+}
+
+/* Planes follow the terrain as it is set and then changed, across more
+ * than one word per row */
+int test_set_feat(void *state) {
+	struct chunk *c = cave_new(7, 2 * PLANE_WORD_BITS + 5);
+	int pass, y, x;
+
+	for (pass = 0; pass < 3; pass++) {
+		for (y = 0; y < c->height; y++)
+			for (x = 0; x < c->width; x++)
+				square_set_feat(c, y, x, pattern_feat(y, x, pass));
+		if (check_planes(c, pass)) {
+			cave_free(c);
+			return 1;
+		}
+	}
+
+	cave_free(c);
+	ok;
+}
+
+const char *suite_name = "cave/planes";
+struct test tests[] = {
+	{ "set_feat", test_set_feat },
+	{ NULL, NULL }
+};
@@ -0,0 +1,93 @@
+/* cave/region */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+
+/* Three regions when diagonals count, four when they don't */
+static const char *map[] = {
+	"#########",
+	"#..#....#",
+	"#..#.####",
+	"####.#..#",
+	"#..##...#",
+	"#########",
+};
+
+static bool map_isopen(struct chunk *c, int y, int x)
+{
+	return map[y][x] == '.';
+}
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	*state = cave_new(N_ELEMENTS(map), strlen(map[0]));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(state);
+	return 0;
+}
+
+/* Regions are numbered in row order of their first grid */
+int test_labels(void *state) {
+	struct cave_regions *r = cave_regions_new(state, map_isopen, FALSE);
+
+	eq(r->num, 4);
+	eq(r->live, 4);
+	eq(cave_region_at(r, 0, 0), 0);
+	eq(cave_region_at(r, 2, 2), 1);
+	eq(cave_region_at(r, 3, 4), 2);
+	eq(cave_region_at(r, 3, 7), 3);
+	eq(cave_region_at(r, 4, 1), 4);
+	eq(cave_region_size(r, 1), 4);
+	eq(cave_region_size(r, 2), 6);
+	eq(cave_region_size(r, 3), 5);
+	eq(r->first[3].y, 3);
+	eq(r->first[3].x, 6);
+
+	cave_regions_free(r);
+	ok;
+}
+
+/* Diagonal steps join the middle and the right of the map */
+int test_diagonal(void *state) {
+	struct cave_regions *r = cave_regions_new(state, map_isopen, TRUE);
+
+	eq(r->num, 3);
+	eq(cave_region_at(r, 1, 4), cave_region_at(r, 4, 7));
+	eq(cave_region_size(r, 2), 11);
+	eq(cave_region_at(r, 4, 2), 3);
+
+	cave_regions_free(r);
+	ok;
+}
+
+/* Joined and dropped regions stop counting as live */
+int test_join(void *state) {
+	struct cave_regions *r = cave_regions_new(state, map_isopen, FALSE);
+
+	eq(cave_region_join(r, 3, 2), 3);
+	eq(cave_region_at(r, 1, 5), 3);
+	eq(cave_region_size(r, 2), 11);
+	eq(r->live, 3);
+	eq(cave_region_first(r), 1);
+
+	cave_region_drop(r, 1);
+	eq(r->live, 2);
+	eq(cave_region_first(r), 3);
+
+	cave_regions_free(r);
+	ok;
+}
+
+const char *suite_name = "cave/region";
+struct test tests[] = {
+	{ "labels", test_labels },
+	{ "diagonal", test_diagonal },
+	{ "join", test_join },
+	{ NULL, NULL }
+};
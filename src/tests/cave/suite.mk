@@ -0,0 +1,6 @@
+TESTPROGS += cave/region
+TESTPROGS += cave/chunks
+TESTPROGS += cave/known
+TESTPROGS += cave/traps
+TESTPROGS += cave/genstats
+TESTPROGS += cave/planes
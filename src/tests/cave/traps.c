@@ -0,0 +1,72 @@
+/* cave/traps */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+#include "trap.h"
+
+int setup_tests(void **state) {
+	struct chunk *c;
+	int y, x;
+
+	set_file_paths();
+	init_angband();
+
+	c = cave_new(5, 7);
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			square_set_feat(c, y, x, FEAT_FLOOR);
+	*state = c;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(state);
+	return 0;
+}
+
+/* The index follows traps as they are placed, found and removed */
+int test_index(void *state) {
+	struct chunk *c = state;
+	struct trap_kind *pit = lookup_trap("pit");
+	struct trap_kind *rune = lookup_trap("glyph of warding");
+	struct trap **traps;
+	int num;
+
+	traps = chunk_traps(c, &num);
+	eq(num, 0);
+	require(!square_isplayertrap(c, 1, 1));
+
+	place_trap(c, 1, 1, pit->tidx, 0);
+	place_trap(c, 2, 3, rune->tidx, 0);
+	place_trap(c, 3, 5, pit->tidx, 0);
+	traps = chunk_traps(c, &num);
+	eq(num, 3);
+	eq(traps[1]->fy, 2);
+	eq(traps[1]->fx, 3);
+
+	require(square_isplayertrap(c, 1, 1));
+	require(square_issecrettrap(c, 1, 1));
+	require(square_isvisibletrap(c, 2, 3));
+	require(!square_isplayertrap(c, 2, 3));
+	require(!square_istrap(c, 2, 2));
+
+	require(square_reveal_trap(c, 1, 1, 100, FALSE));
+	require(square_isknowntrap(c, 1, 1));
+	eq(num_traps(c, 1, 1, 1), 1);
+	eq(num_traps(c, 1, 1, -1), 0);
+
+	require(square_remove_trap(c, 3, 5, FALSE, -1));
+	traps = chunk_traps(c, &num);
+	eq(num, 2);
+	require(!square_isplayertrap(c, 3, 5));
+	require(!square_istrap(c, 3, 5));
+	ok;
+}
+
+const char *suite_name = "cave/traps";
+struct test tests[] = {
+	{ "index", test_index },
+	{ NULL, NULL }
+};
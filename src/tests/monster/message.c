@@ -0,0 +1,78 @@
+/* monster/message */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+
+#include "init.h"
+#include "message.h"
+#include "mon-msg.h"
+#include "monster.h"
+
+extern struct init_module monmsg_module;
+
+static struct monster_pain test_pain = {
+	{ "shrug[s] off the attack.", "grunt[s] with pain.",
+	  "cr[ies|y] out in pain.", "scream[s] in pain.", "scream[s] in agony.",
+	  "writhe[s] in agony.", "cr[ies|y] out feebly." },
+	0, NULL
+};
+
+int setup_tests(void **state) {
+	struct monster *m = mem_zalloc(2 * sizeof *m);
+	test_rb_info.pain = &test_pain;
+	test_r_human.base = &test_rb_info;
+	m[0].race = &test_r_human;
+	m[1].race = &test_r_human;
+	player = &test_player;
+	messages_init();
+	monmsg_module.init();
+	*state = m;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	monmsg_module.cleanup();
+	messages_free();
+	mem_free(state);
+	return 0;
+}
+
+int test_stack(void *state) {
+	struct monster *m = state;
+
+	require(add_monster_message("the Human", &m[0], MON_MSG_95, FALSE));
+
+	/* The same monster doesn't report the same thing twice */
+	require(!add_monster_message("the Human", &m[0], MON_MSG_95, FALSE));
+
+	/* Others of its race stack, unless they are described differently */
+	require(add_monster_message("the Human", &m[1], MON_MSG_95, FALSE));
+	require(add_monster_message("the Human (offscreen)", &m[1], MON_MSG_50,
+								FALSE));
+	require(add_monster_message("the Human", &m[0], MON_MSG_DIE, FALSE));
+	require(add_monster_message("it", &m[1], MON_MSG_DIE, FALSE));
+	eq(mon_msg[0].mon_count, 2);
+	eq(mon_msg[1].mon_flags, MON_MSG_FLAG_OFFSCREEN);
+	eq(mon_msg[2].mon_count, 1);
+	eq(mon_msg[3].mon_flags, MON_MSG_FLAG_INVISIBLE);
+
+	/* Messages come out in the order they were stacked, deaths last */
+	flush_all_monster_messages();
+	eq(messages_num(), 4);
+	require(streq(message_str(3), "2 Humans shrug off the attack."));
+	require(streq(message_str(2), "The Human (offscreen) cries out in pain."));
+	require(streq(message_str(1), "The Human dies."));
+	require(streq(message_str(0), "It dies."));
+
+	/* Flushing forgets the history */
+	require(add_monster_message("the Human", &m[0], MON_MSG_95, FALSE));
+	eq(mon_msg[0].mon_count, 1);
+	flush_all_monster_messages();
+	ok;
+}
+
+const char *suite_name = "monster/message";
+struct test tests[] = {
+	{ "stack", test_stack },
+	{ NULL, NULL }
+};
@@ -0,0 +1,153 @@
+/* monster/power
+ *
+ * Tests for the monster power evaluation cache
+ */
+
+#include <unistd.h>
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "init.h"
+#include "mon-power.h"
+
+extern s32b tot_mon_power;
+
+static char dir[64] = "/tmp/angband-power-XXXXXX";
+static char cache[1024];
+
+static const char *edit_files[] = {
+	"monster.txt", "monster_spell.txt", "monster_base.txt"
+};
+
+/* Copy an edit file into the test's own edit directory */
+static bool copy_edit_file(const char *old_dir, const char *name) {
+	char from[1024], to[1024], buf[4096];
+	ang_file *in, *out;
+	int n;
+	bool written = TRUE;
+
+	path_build(from, sizeof(from), old_dir, name);
+	path_build(to, sizeof(to), dir, name);
+	in = file_open(from, MODE_READ, FTYPE_RAW);
+	if (!in) return FALSE;
+	out = file_open(to, MODE_WRITE, FTYPE_RAW);
+	if (!out) {
+		file_close(in);
+		return FALSE;
+	}
+	while (written && (n = file_read(in, buf, sizeof(buf))) > 0)
+		written = file_write(out, buf, n);
+	file_close(in);
+	return file_close(out) && written;
+}
+
+int setup_tests(void **state) {
+	size_t i;
+
+	read_edit_files();
+
+	/* Read the edit files from, and write the cache to, a directory of
+	 * our own */
+	if (!mkdtemp(dir)) return 1;
+	for (i = 0; i < N_ELEMENTS(edit_files); i++)
+		if (!copy_edit_file(ANGBAND_DIR_EDIT, edit_files[i])) return 1;
+	string_free(ANGBAND_DIR_EDIT);
+	ANGBAND_DIR_EDIT = string_make(dir);
+	string_free(ANGBAND_DIR_USER);
+	ANGBAND_DIR_USER = string_make(dir);
+	path_build(cache, sizeof(cache), dir, "mon_power.dat");
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	char path[1024];
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(edit_files); i++) {
+		path_build(path, sizeof(path), dir, edit_files[i]);
+		file_delete(path);
+	}
+	path_build(path, sizeof(path), dir, "new_monster.txt");
+	file_delete(path);
+	file_delete(cache);
+	rmdir(dir);
+	return 0;
+}
+
+/* Change the total power stored in the cache, so a run that uses the cache
+ * can be told from one that doesn't */
+static bool mark_cache(void) {
+	static char data[1024 * 1024];
+	ang_file *f = file_open(cache, MODE_READ, FTYPE_RAW);
+	int n;
+
+	if (!f) return FALSE;
+	n = file_read(f, data, sizeof(data));
+	file_close(f);
+	if (n <= 4 + 8 * 13) return FALSE;
+
+	/* The total follows the magic and the twelve header values */
+	memset(data + 4 + 8 * 12, 0, 8);
+	data[4 + 8 * 12] = 0x2A;
+
+	f = file_open(cache, MODE_WRITE, FTYPE_RAW);
+	if (!f) return FALSE;
+	if (!file_write(f, data, n)) {
+		file_close(f);
+		return FALSE;
+	}
+	return file_close(f);
+}
+
+int test_cache_miss(void *state) {
+	s32b power;
+
+	file_delete(cache);
+	eq(eval_monster_power(r_info), 0);
+	power = tot_mon_power;
+	require(power != 0x2A);
+	require(file_exists(cache));
+
+	/* The same again, from scratch */
+	file_delete(cache);
+	eq(eval_monster_power(r_info), 0);
+	eq(tot_mon_power, power);
+	ok;
+}
+
+int test_cache_hit(void *state) {
+	require(mark_cache());
+	eq(eval_monster_power(r_info), 0);
+	eq(tot_mon_power, 0x2A);
+	ok;
+}
+
+int test_cache_invalidate(void *state) {
+	char path[1024];
+	ang_file *f;
+
+	/* A comment changes the file but not the monsters */
+	path_build(path, sizeof(path), dir, "monster_base.txt");
+	f = file_open(path, MODE_APPEND, FTYPE_TEXT);
+	require(f);
+	require(file_put(f, "# changed\n"));
+	require(file_close(f));
+
+	eq(eval_monster_power(r_info), 0);
+	require(tot_mon_power != 0x2A);
+
+	/* The new results are cached in turn */
+	require(mark_cache());
+	eq(eval_monster_power(r_info), 0);
+	eq(tot_mon_power, 0x2A);
+	ok;
+}
+
+const char *suite_name = "monster/power";
+struct test tests[] = {
+	{ "miss", test_cache_miss },
+	{ "hit", test_cache_hit },
+	{ "invalidate", test_cache_invalidate },
+	{ NULL, NULL }
+};
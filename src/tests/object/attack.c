@@ -3,8 +3,10 @@
 #include "unit-test.h"
 #include "unit-test-data.h"
 
+#include "mon-lore.h"
 #include "object.h"
 #include "obj-make.h"
+#include "obj-slays.h"
 #include "player-attack.h"
 
 NOSETUP
@@ -27,8 +29,53 @@ int test_breakage_chance(void *state) {
 	ok;
 }
 
+int test_attack_modifier(void *state) {
+	struct object obj = { 0 };
+	struct monster mon = { 0 };
+	struct brand fire = { (char *)"fire", 2, 3, 0, TRUE, NULL };
+	struct slay evil = { (char *)"evil creatures", RF_EVIL, 2, 0, TRUE, NULL };
+	struct slay town = { (char *)"townsfolk", 0, 5, 0, FALSE, NULL };
+	const struct brand *b = NULL;
+	const struct slay *s = NULL;
+	char verb[20];
+
+	l_list = mem_zalloc(sizeof(monster_lore));
+	mon.race = &test_r_human;
+	obj.brands = &fire;
+	obj.slays = &evil;
+
+	/* The brand hurts; the slay doesn't */
+	improve_attack_modifier(&obj, &mon, &b, &s, verb, FALSE, FALSE, FALSE);
+	ptreq(b, &fire);
+	null(s);
+	require(streq(verb, "burn"));
+
+	improve_attack_modifier(&obj, &mon, &b, &s, verb, TRUE, FALSE, FALSE);
+	require(streq(verb, "burns"));
+
+	/* A bigger slay of the monster's base beats it */
+	evil.next = &town;
+	b = NULL;
+	improve_attack_modifier(&obj, &mon, &b, &s, verb, FALSE, FALSE, FALSE);
+	null(b);
+	ptreq(s, &town);
+	require(streq(verb, "fiercely smite"));
+
+	/* Unless only known modifiers count */
+	b = NULL;
+	s = NULL;
+	improve_attack_modifier(&obj, &mon, &b, &s, verb, FALSE, FALSE, TRUE);
+	ptreq(b, &fire);
+	null(s);
+
+	mem_free(l_list);
+	l_list = NULL;
+	ok;
+}
+
 const char *suite_name = "object/attack";
 struct test tests[] = {
 	{ "breakage-chance", test_breakage_chance },
+	{ "attack-modifier", test_attack_modifier },
 	{ NULL, NULL }
 };
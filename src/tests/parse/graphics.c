@@ -1,16 +1,21 @@
 /* parse/graphics */
 
 #include <stdio.h>
+#include <utime.h>
 
 #include "unit-test.h"
 #include "test-utils.h"
 
 #include "game-event.h"
 #include "init.h" /* init_angband */
+#include "mon-util.h" /* lookup_monster */
 #include "message.h" /* msg */
 #include "grafmode.h"
 #include "ui-prefs.h"
 #include "cmd-core.h"
+#include "object.h"
+#include "project.h"
+#include "trap.h"
 
 int setup_tests(void **state) {
 	set_file_paths();
@@ -59,8 +64,126 @@ int test_prefs(void *state) {
 	ok;
 }
 
+/* Checksum of all the glyph tables */
+static u32b glyph_sum(void) {
+	u32b sum = 0;
+	struct flavor *f;
+	int i, j;
+
+#define ADD(a, c) sum = sum * 31 + (a) * 65537 + (u32b) (c)
+	for (i = 0; i < z_info->r_max; i++)
+		ADD(monster_x_attr[i], monster_x_char[i]);
+	for (i = 0; i < z_info->k_max; i++)
+		ADD(kind_x_attr[i], kind_x_char[i]);
+	for (j = 0; j < LIGHTING_MAX; j++) {
+		for (i = 0; i < z_info->f_max; i++)
+			ADD(feat_x_attr[j][i], feat_x_char[j][i]);
+		for (i = 0; i < z_info->trap_max; i++)
+			ADD(trap_x_attr[j][i], trap_x_char[j][i]);
+	}
+	for (f = flavors; f; f = f->next)
+		ADD(flavor_x_attr[f->fidx], flavor_x_char[f->fidx]);
+	for (i = 0; i < GF_MAX; i++)
+		for (j = 0; j < BOLT_MAX; j++)
+			ADD(gf_to_attr[i][j], gf_to_char[i][j]);
+#undef ADD
+
+	return sum;
+}
+
+int test_cache(void *state) {
+	char dir[1024], path[1024], leaf[256];
+	graphics_mode *mode;
+	ang_dir *cache;
+	int found = 0;
+
+	for (mode = graphics_modes; mode; mode = mode->pNext) {
+		u32b parsed;
+
+		use_graphics = mode->grafID;
+
+		/* Parse the files */
+		use_pref_cache = FALSE;
+		reset_visuals(TRUE);
+		parsed = glyph_sum();
+
+		/* Fill the cache if need be, then load from it */
+		use_pref_cache = TRUE;
+		reset_visuals(TRUE);
+		eq(glyph_sum(), parsed);
+		reset_visuals(TRUE);
+		eq(glyph_sum(), parsed);
+	}
+
+	/* Clear up */
+	path_build(dir, sizeof(dir), ANGBAND_DIR_USER, "cache");
+	cache = my_dopen(dir);
+	require(cache);
+	while (my_dread(cache, leaf, sizeof(leaf))) {
+		if (!prefix(leaf, "prefs-")) continue;
+		path_build(path, sizeof(path), dir, leaf);
+		file_delete(path);
+		found++;
+	}
+	my_dclose(cache);
+	require(found > 0);
+
+	ok;
+}
+
+/* Write a user pref file giving a monster a glyph, with a given mtime */
+static bool write_pref(const char *path, const char *race, char ch,
+					   const char *pad, time_t mtime) {
+	struct utimbuf times;
+	ang_file *f = file_open(path, MODE_WRITE, FTYPE_TEXT);
+
+	if (!f) return FALSE;
+	file_putf(f, "monster:%s:0x01:0x%02X\n%s", race, ch, pad);
+	if (!file_close(f)) return FALSE;
+
+	times.actime = mtime;
+	times.modtime = mtime;
+	return utime(path, &times) == 0;
+}
+
+/* A changed pref file is read again, even if it is no newer than the cache */
+int test_cache_changed(void *state) {
+	const char *name = "cache-test.prf";
+	struct monster_race *race = lookup_monster("Scrawny cat");
+	char path[1024];
+	time_t when = time(NULL) - 3600;
+
+	require(race);
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, name);
+	use_pref_cache = TRUE;
+
+	require(write_pref(path, race->name, 'A', "", when));
+	require(process_pref_file(name, FALSE, TRUE));
+	eq(monster_x_char[race->ridx], 'A');
+
+	/* Load it from the cache */
+	monster_x_char[race->ridx] = 0;
+	require(process_pref_file(name, FALSE, TRUE));
+	eq(monster_x_char[race->ridx], 'A');
+
+	/* The same age, but a different size */
+	require(write_pref(path, race->name, 'B', "# changed\n", when));
+	require(process_pref_file(name, FALSE, TRUE));
+	eq(monster_x_char[race->ridx], 'B');
+
+	/* The same size, but a different age */
+	require(write_pref(path, race->name, 'C', "# changed\n", when + 1));
+	require(process_pref_file(name, FALSE, TRUE));
+	eq(monster_x_char[race->ridx], 'C');
+
+	file_delete(path);
+	ok;
+}
+
 const char *suite_name = "parse/graphics";
 struct test tests[] = {
 	{ "prefs", test_prefs },
+	{ "cache_changed", test_cache_changed },
+	{ "cache", test_cache },
 	{ NULL, NULL }
 };
@@ -3,6 +3,8 @@
 #include "unit-test.h"
 #include "unit-test-data.h"
 
+#include "test-utils.h"
+
 #include "init.h"
 
 
@@ -60,6 +62,37 @@ TEST_MON(town_monsters_day, "town-day")
 TEST_MON(town_monsters_night, "town-night")
 TEST_MON(repro_monster_max, "repro-max")
 
+/* The lines of constants.txt, read once so the timing leaves out the file */
+static char constants[256][128];
+static int n_constants;
+
+static bool read_constants(void) {
+	char path[1024];
+	ang_file *f;
+
+	set_file_paths();
+	path_build(path, sizeof(path), ANGBAND_DIR_EDIT, "constants.txt");
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
+	if (!f) return FALSE;
+	while (n_constants < (int) N_ELEMENTS(constants) &&
+		   file_getl(f, constants[n_constants], sizeof(constants[0])))
+		n_constants++;
+	file_close(f);
+
+	return n_constants > 0;
+}
+
+/* Timed: parsing the whole of constants.txt */
+int bench_parse(void *state) {
+	int i;
+
+	if (!n_constants && !read_constants()) return 1;
+	for (i = 0; i < n_constants; i++)
+		if (parser_parse(state, constants[i]) != PARSE_ERROR_NONE) return 1;
+
+	return 0;
+}
+
 const char *suite_name = "parse/z-info";
 struct test tests[] = {
 	{ "negative", test_negative },
@@ -70,5 +103,6 @@ struct test tests[] = {
 	{ "town_day", test_town_monsters_day },
 	{ "town_night", test_town_monsters_night },
 	{ "repro_max", test_repro_monster_max },
+	{ "bench-parse", bench_parse, 100, 10000 },
 	{ NULL, NULL }
 };
@@ -2,6 +2,7 @@
 
 #include "player.h"
 #include "player-birth.h"
+#include "player-history.h"
 #include "unit-test.h"
 
 NOTEARDOWN
@@ -74,8 +75,48 @@ int test_0(void *state) {
 	ok;
 }
 
+int test_artifacts(void *state) {
+	struct artifact a5, a6, a7;
+	bitflag type[HIST_SIZE];
+
+	memset(&a5, 0, sizeof(a5));
+	memset(&a6, 0, sizeof(a6));
+	memset(&a7, 0, sizeof(a7));
+	a5.aidx = 5;
+	a6.aidx = 6;
+	a7.aidx = 7;
+
+	history_clear();
+	require(!history_is_artifact_known(&a5));
+
+	hist_wipe(type);
+	hist_on(type, HIST_ARTIFACT_KNOWN);
+	require(history_add_full(type, &a5, 1, 1, 10, "Found a5"));
+	hist_wipe(type);
+	hist_on(type, HIST_ARTIFACT_UNKNOWN);
+	require(history_add_full(type, &a7, 2, 2, 20, "Found a7"));
+
+	require(history_is_artifact_known(&a5));
+	require(!history_is_artifact_known(&a6));
+	require(!history_is_artifact_known(&a7));
+
+	/* Losing a logged artifact marks its latest entry */
+	require(history_lose_artifact(&a5));
+	require(history_is_artifact_known(&a5));
+	require(hist_has(history_list[0].type, HIST_ARTIFACT_LOST));
+
+	history_unmask_unknown();
+	require(history_is_artifact_known(&a7));
+	eq(history_get_num(), 2);
+
+	history_clear();
+	require(!history_is_artifact_known(&a5));
+	ok;
+}
+
 const char *suite_name = "player/history";
 struct test tests[] = {
 	{ "0", test_0 },
+	{ "artifacts", test_artifacts },
 	{ NULL, NULL },
 };
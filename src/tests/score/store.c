@@ -0,0 +1,154 @@
+/* score/store */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "init.h"
+#include "score.h"
+
+static char dir[64] = "/tmp/angband-scores-XXXXXX";
+
+static void apex_file(char *buf, size_t len, const char *leaf) {
+	path_build(buf, len, ANGBAND_DIR_APEX, leaf);
+}
+
+static void clear_files(void) {
+	char buf[1024];
+
+	apex_file(buf, sizeof(buf), "scores.raw");
+	file_delete(buf);
+	apex_file(buf, sizeof(buf), "scores.idx");
+	file_delete(buf);
+}
+
+int setup_tests(void **state) {
+	set_file_paths();
+
+	/* Keep the scores somewhere of their own */
+	if (!mkdtemp(dir)) return 1;
+	string_free(ANGBAND_DIR_APEX);
+	ANGBAND_DIR_APEX = string_make(dir);
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	clear_files();
+	rmdir(dir);
+	return 0;
+}
+
+static void make_entry(high_score *entry, u32b pts, const char *who) {
+	memset(entry, 0, sizeof(*entry));
+	my_strcpy(entry->what, "test", sizeof(entry->what));
+	strnfmt(entry->pts, sizeof(entry->pts), "%9u", pts);
+	my_strcpy(entry->who, who, sizeof(entry->who));
+}
+
+/* Add an entry to the end of the scores file, behind the index's back */
+static bool append_raw(u32b pts, const char *who) {
+	char buf[1024];
+	high_score entry;
+	ang_file *f;
+	bool written;
+
+	make_entry(&entry, pts, who);
+	apex_file(buf, sizeof(buf), "scores.raw");
+	f = file_open(buf, MODE_APPEND, FTYPE_RAW);
+	if (!f) return FALSE;
+	written = file_write(f, (const char *) &entry, sizeof(entry));
+	file_close(f);
+	return written;
+}
+
+static bool add(u32b pts, const char *who) {
+	high_score entry;
+
+	make_entry(&entry, pts, who);
+	return highscore_write(&entry);
+}
+
+/* Check the best scores are the given names, in order */
+static int expect(const char **who, size_t n) {
+	high_score scores[MAX_HISCORES];
+	size_t i;
+
+	eq(highscore_read(scores, N_ELEMENTS(scores)), n);
+	for (i = 0; i < n; i++)
+		require(streq(scores[i].who, who[i]));
+	return 0;
+}
+
+/* A sorted scores file from before the index gets one */
+int test_migrate(void *state) {
+	const char *order[] = { "a", "c", "b", "d" };
+	char buf[1024];
+
+	clear_files();
+	require(append_raw(500, "a"));
+	require(append_raw(400, "b"));
+	require(append_raw(400, "c"));
+	require(append_raw(100, "d"));
+
+	/* Equal scores come newest first */
+	if (expect(order, 4)) return 1;
+
+	apex_file(buf, sizeof(buf), "scores.idx");
+	require(file_exists(buf));
+	ok;
+}
+
+/* New scores go in their place, ahead of the scores they equal */
+int test_insert(void *state) {
+	const char *order[] = { "a", "e", "f", "c", "b", "d", "g" };
+
+	require(add(450, "e"));
+	require(add(400, "f"));
+	require(add(50, "g"));
+	if (expect(order, 7)) return 1;
+	ok;
+}
+
+/* Only as many scores as are asked for are read */
+int test_top(void *state) {
+	high_score scores[3];
+
+	eq(highscore_read(scores, N_ELEMENTS(scores)), 3);
+	require(streq(scores[0].who, "a"));
+	require(streq(scores[2].who, "f"));
+	ok;
+}
+
+/* An index that has fallen out of step with the scores is remade, and new
+ * scores are numbered by the scores file */
+int test_stale(void *state) {
+	const char *order[] = { "h", "i", "a", "e", "f", "c", "b", "d", "g" };
+
+	require(append_raw(1000, "h"));
+	require(add(700, "i"));
+	if (expect(order, 9)) return 1;
+	ok;
+}
+
+/* A remade index orders the scores just as one built a score at a time */
+int test_rebuild(void *state) {
+	const char *order[] = { "h", "i", "a", "e", "f", "c", "b", "d", "g" };
+	char buf[1024];
+
+	apex_file(buf, sizeof(buf), "scores.idx");
+	require(file_delete(buf));
+	if (expect(order, 9)) return 1;
+	ok;
+}
+
+const char *suite_name = "score/store";
+struct test tests[] = {
+	{ "migrate", test_migrate },
+	{ "insert", test_insert },
+	{ "top", test_top },
+	{ "stale", test_stale },
+	{ "rebuild", test_rebuild },
+	{ NULL, NULL }
+};
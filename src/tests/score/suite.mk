@@ -0,0 +1 @@
+TESTPROGS += score/store
@@ -0,0 +1,121 @@
+/* ui-keymap/keymap */
+
+#include "unit-test.h"
+#include "z-file.h"
+#include "ui-event.h"
+#include "ui-keymap.h"
+
+int setup_tests(void **state) {
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	keymap_free();
+	return 0;
+}
+
+static struct keypress key(keycode_t code, byte mods) {
+	struct keypress k = { EVT_KBRD, 0, 0 };
+
+	k.code = code;
+	k.mods = mods;
+	return k;
+}
+
+int test_find(void *state) {
+	struct keypress act[2] = { { EVT_KBRD, 'x', 0 }, { EVT_NONE, 0, 0 } };
+	const struct keypress *found;
+	keycode_t c;
+
+	/* Triggers 256 apart share a bucket */
+	for (c = 'a'; c < 'a' + 1024; c += 64) {
+		act[0].code = c;
+		keymap_add(KEYMAP_MODE_ORIG, key(c, 0), act, FALSE);
+	}
+	act[0].code = 'M';
+	keymap_add(KEYMAP_MODE_ORIG, key('a', KC_MOD_CONTROL), act, TRUE);
+
+	for (c = 'a'; c < 'a' + 1024; c += 64) {
+		found = keymap_find(KEYMAP_MODE_ORIG, key(c, 0));
+		require(found);
+		eq(found[0].code, c);
+		eq(found[1].type, EVT_NONE);
+		null(keymap_find(KEYMAP_MODE_ROGUE, key(c, 0)));
+	}
+	found = keymap_find(KEYMAP_MODE_ORIG, key('a', KC_MOD_CONTROL));
+	require(found);
+	eq(found[0].code, 'M');
+	null(keymap_find(KEYMAP_MODE_ORIG, key('b', 0)));
+
+	ok;
+}
+
+int test_replace(void *state) {
+	struct keypress act[2] = { { EVT_KBRD, 'y', 0 }, { EVT_NONE, 0, 0 } };
+	const struct keypress *found;
+
+	keymap_add(KEYMAP_MODE_ORIG, key('a' + 256, 0), act, FALSE);
+	found = keymap_find(KEYMAP_MODE_ORIG, key('a' + 256, 0));
+	require(found);
+	eq(found[0].code, 'y');
+
+	/* Its bucket neighbours are untouched */
+	found = keymap_find(KEYMAP_MODE_ORIG, key('a', 0));
+	require(found);
+	eq(found[0].code, 'a');
+	found = keymap_find(KEYMAP_MODE_ORIG, key('a' + 512, 0));
+	require(found);
+	eq(found[0].code, 'a' + 512);
+
+	ok;
+}
+
+int test_remove(void *state) {
+	keycode_t c;
+
+	require(keymap_remove(KEYMAP_MODE_ORIG, key('a' + 256, 0)));
+	require(!keymap_remove(KEYMAP_MODE_ORIG, key('a' + 256, 0)));
+	null(keymap_find(KEYMAP_MODE_ORIG, key('a' + 256, 0)));
+	require(keymap_find(KEYMAP_MODE_ORIG, key('a', 0)));
+	require(keymap_find(KEYMAP_MODE_ORIG, key('a' + 512, 0)));
+
+	for (c = 'a'; c < 'a' + 1024; c += 64)
+		keymap_remove(KEYMAP_MODE_ORIG, key(c, 0));
+	null(keymap_find(KEYMAP_MODE_ORIG, key('a', 0)));
+	require(keymap_find(KEYMAP_MODE_ORIG, key('a', KC_MOD_CONTROL)));
+
+	keymap_free();
+	null(keymap_find(KEYMAP_MODE_ORIG, key('a', KC_MOD_CONTROL)));
+
+	ok;
+}
+
+/* A pref.prf sized set of keymaps, looked up one key at a time */
+int bench_find(void *state) {
+	static int made = 0;
+	static keycode_t next = 0;
+	struct keypress act[2] = { { EVT_KBRD, 'z', 0 }, { EVT_NONE, 0, 0 } };
+	int i;
+
+	if (!made) {
+		for (i = 0; i < 250; i++)
+			keymap_add(KEYMAP_MODE_ORIG, key(' ' + i, 0), act, FALSE);
+		made = 1;
+	}
+
+	for (i = 0; i < 100; i++) {
+		require(keymap_find(KEYMAP_MODE_ORIG, key(' ' + next, 0)));
+		next = (next + 97) % 250;
+	}
+
+	ok;
+}
+
+const char *suite_name = "ui-keymap/keymap";
+struct test tests[] = {
+	{ "find", test_find },
+	{ "replace", test_replace },
+	{ "remove", test_remove },
+	{ "bench_find", bench_find, 10, 10000 },
+	{ NULL, NULL }
+};
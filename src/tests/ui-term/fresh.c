@@ -0,0 +1,149 @@
+/* ui-term/fresh.c */
+
+#include "unit-test.h"
+#include "ui-term.h"
+#include "z-color.h"
+
+/* Everything the term was asked to draw, one run per entry */
+static struct term_span drawn[64];
+static wchar_t drawn_text[64][32];
+static int num_drawn;
+static int num_batches;
+
+static void note_run(int x, int y, int n, int a, const wchar_t *s) {
+	struct term_span *run = &drawn[num_drawn];
+
+	run->x = x;
+	run->y = y;
+	run->n = n;
+	run->a = a;
+	run->s = NULL;
+	if (s) {
+		wmemcpy(drawn_text[num_drawn], s, n);
+		drawn_text[num_drawn][n] = 0;
+		run->s = drawn_text[num_drawn];
+	}
+	num_drawn++;
+}
+
+static errr wipe_hook(int x, int y, int n) {
+	note_run(x, y, n, 0, NULL);
+	return 0;
+}
+
+static errr text_hook(int x, int y, int n, int a, const wchar_t *s) {
+	note_run(x, y, n, a, s);
+	return 0;
+}
+
+static errr batch_hook(const struct term_span *spans, int n) {
+	int i;
+
+	for (i = 0; i < n; i++)
+		note_run(spans[i].x, spans[i].y, spans[i].n, spans[i].a, spans[i].s);
+	num_batches++;
+	return 0;
+}
+
+static term test_term;
+
+int setup_tests(void **state) {
+	term_init(&test_term, 20, 3, 16);
+	test_term.wipe_hook = wipe_hook;
+	test_term.text_hook = text_hook;
+	Term_activate(&test_term);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	term_nuke(&test_term);
+	return 0;
+}
+
+/* Draw a fresh screen and return the number of runs drawn */
+static int redraw(void) {
+	num_drawn = 0;
+	num_batches = 0;
+	Term_fresh();
+	return num_drawn;
+}
+
+int test_runs(void *state) {
+	Term_clear();
+	Term_putstr(2, 1, -1, COLOUR_WHITE, "abc");
+	Term_putstr(5, 1, -1, COLOUR_RED, "de");
+	Term_putstr(9, 2, -1, COLOUR_WHITE, "f");
+	redraw();
+
+	/* The clear has wiped everything else, so only the text is drawn */
+	eq(num_drawn, 3);
+	eq(drawn[0].x, 2);
+	eq(drawn[0].y, 1);
+	eq(drawn[0].a, COLOUR_WHITE);
+	require(!wcscmp(drawn[0].s, L"abc"));
+	eq(drawn[1].x, 5);
+	eq(drawn[1].a, COLOUR_RED);
+	require(!wcscmp(drawn[1].s, L"de"));
+	eq(drawn[2].x, 9);
+	eq(drawn[2].y, 2);
+
+	/* Blanked text is wiped */
+	Term_erase(9, 2, 1);
+	eq(redraw(), 1);
+	eq(drawn[0].x, 9);
+	eq(drawn[0].n, 1);
+	null(drawn[0].s);
+	ok;
+}
+
+int test_unchanged(void *state) {
+	/* Rewriting the same text draws nothing */
+	Term_putstr(2, 1, -1, COLOUR_WHITE, "abc");
+	eq(redraw(), 0);
+
+	/* Changing a grid and changing it back draws nothing */
+	Term_putstr(3, 1, -1, COLOUR_WHITE, "x");
+	Term_putstr(3, 1, -1, COLOUR_WHITE, "b");
+	eq(redraw(), 0);
+
+	/* Only the changed grid is drawn, however widely the row was touched */
+	Term_erase(0, 1, 2);
+	Term_putstr(2, 1, -1, COLOUR_WHITE, "abz");
+	Term_putstr(5, 1, -1, COLOUR_RED, "de");
+	eq(redraw(), 1);
+	eq(drawn[0].x, 4);
+	eq(drawn[0].n, 1);
+	require(!wcscmp(drawn[0].s, L"z"));
+	ok;
+}
+
+int test_batch(void *state) {
+	test_term.batch_hook = batch_hook;
+	Term_putstr(2, 0, -1, COLOUR_WHITE, "gh");
+	Term_erase(5, 1, 2);
+
+	/* The same runs arrive, but in one call */
+	eq(redraw(), 2);
+	eq(num_batches, 1);
+	eq(drawn[0].x, 2);
+	eq(drawn[0].y, 0);
+	require(!wcscmp(drawn[0].s, L"gh"));
+	eq(drawn[1].x, 5);
+	eq(drawn[1].n, 2);
+	null(drawn[1].s);
+
+	/* No changes, no call */
+	eq(redraw(), 0);
+	eq(num_batches, 0);
+
+	test_term.batch_hook = NULL;
+	ok;
+}
+
+const char *suite_name = "ui-term/fresh";
+struct test tests[] = {
+	{ "runs", test_runs },
+	{ "unchanged", test_unchanged },
+	{ "batch", test_batch },
+	{ NULL, NULL }
+};
@@ -7,9 +7,16 @@
 #ifndef UNIT_TEST_TYPES_H
 #define UNIT_TEST_TYPES_H
 
+/**
+ * A test, or with a non-zero number of iterations a timed case: func is then
+ * one operation, run once as a test and many times as a benchmark, and
+ * returns 0 for success without reporting anything itself.
+ */
 struct test {
 	const char *name;
 	int (*func)(void *data);
+	int warmup;
+	int iterations;
 };
 
 #endif /* !UNIT_TEST_TYPES_H */
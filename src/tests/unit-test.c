@@ -6,16 +6,65 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
+#include <time.h>
 #include "unit-test-types.h"
 #include "z-util.h"
 
+/* Number of timed rounds per benchmark, to measure the spread */
+#define BENCH_ROUNDS 5
+
 int verbose = 0;
+int bench = 0;
 
 extern const char *suite_name;
 extern struct test tests[];
 extern int setup_tests(void **data);
 extern int teardown_tests(void **data);
 
+extern int showpass(void);
+extern int showfail(void);
+
+/* Nanoseconds on a monotonic clock */
+static double now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Run a timed case once as a test */
+static int run_once(struct test *t, void *state) {
+	return t->func(state) ? showfail() : showpass();
+}
+
+/* Time a case, and report its mean cost per operation and the spread of
+ * that mean over the rounds */
+static int run_bench(struct test *t, void *state) {
+	double round_ns[BENCH_ROUNDS];
+	double mean = 0.0, var = 0.0;
+	int i, r;
+
+	for (i = 0; i < t->warmup; i++)
+		if (t->func(state)) return 1;
+
+	for (r = 0; r < BENCH_ROUNDS; r++) {
+		double start = now_ns();
+		for (i = 0; i < t->iterations; i++)
+			if (t->func(state)) return 1;
+		round_ns[r] = (now_ns() - start) / t->iterations;
+		mean += round_ns[r];
+	}
+	mean /= BENCH_ROUNDS;
+
+	for (r = 0; r < BENCH_ROUNDS; r++)
+		var += (round_ns[r] - mean) * (round_ns[r] - mean);
+	var /= BENCH_ROUNDS - 1;
+
+	printf("bench %s:%s %.1f ns/op +- %.1f\n", suite_name, t->name, mean,
+		   sqrt(var));
+	return 0;
+}
+
 int main(int argc, char *argv[]) {
 	void *state;
 	int i;
@@ -25,8 +74,26 @@ int main(int argc, char *argv[]) {
 	char *s = getenv("VERBOSE");
 	if (s && s[0]) {
 		verbose = 1;
-	} else if (argc > 1 && !strncmp(argv[1], "-v", 2)) {
-		verbose = 1;
+	}
+	s = getenv("BENCH");
+	if (s && s[0]) {
+		bench = 1;
+	}
+	for (i = 1; i < argc; i++) {
+		if (!strncmp(argv[i], "-v", 2))
+			verbose = 1;
+		else if (!strncmp(argv[i], "-b", 2))
+			bench = 1;
+	}
+
+	/* Don't set up suites with nothing to time */
+	if (bench) {
+		for (i = 0; tests[i].name; i++)
+			if (tests[i].iterations) break;
+		if (!tests[i].name) {
+			printf("%s finished: 0/0 passed\n", suite_name);
+			return 0;
+		}
 	}
 
 	if (verbose) {
@@ -40,9 +107,18 @@ int main(int argc, char *argv[]) {
 	}
 
 	for (i = 0; tests[i].name; i++) {
-		if (verbose) printf("  %-16s  ", tests[i].name);
+		/* Benchmarks only run the timed cases */
+		if (bench && !tests[i].iterations) continue;
+
+		if (verbose && !bench) printf("  %-16s  ", tests[i].name);
 		fflush(stdout);
-		if (tests[i].func(state) == 0) passed++;
+		if (bench) {
+			if (run_bench(&tests[i], state) == 0) passed++;
+		} else if (tests[i].iterations) {
+			if (run_once(&tests[i], state) == 0) passed++;
+		} else {
+			if (tests[i].func(state) == 0) passed++;
+		}
 		total++;
 		fflush(stdout);
 	}
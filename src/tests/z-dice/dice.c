@@ -195,11 +195,73 @@ int test_evaluate(void *state)
 	ok;
 }
 
+int test_roll_batch(void *state)
+{
+	int rolls[50];
+	int i;
+	expression_t *expression = expression_new();
+	dice_t *new = dice_new();
+
+	require(dice_parse_string(new, "2+1d1"));
+	dice_roll_batch(new, rolls, N_ELEMENTS(rolls));
+	for (i = 0; i < (int) N_ELEMENTS(rolls); i++)
+		require(rolls[i] == 3);
+
+	/* Bound expressions are evaluated before rolling */
+	expression_set_base_value(expression, test_evaluate_base);
+	require(expression_add_operations_string(expression, "* 3 - 1") > 0);
+	require(dice_parse_string(new, "$A + 2d3"));
+	require(dice_bind_expression(new, "A", expression) >= 0);
+	dice_roll_batch(new, rolls, N_ELEMENTS(rolls));
+	for (i = 0; i < (int) N_ELEMENTS(rolls); i++)
+		require(rolls[i] >= 10 && rolls[i] <= 14);
+
+	dice_free(new);
+	expression_free(expression);
+	ok;
+}
+
+/* Timed: parsing and evaluating a dice string */
+int bench_evaluate(void *state)
+{
+	dice_t *dice = dice_new();
+	int value;
+
+	if (!dice_parse_string(dice, "5+2d3M4")) return 1;
+	value = dice_evaluate(dice, 10, AVERAGE, NULL);
+	dice_free(dice);
+
+	return value > 0 ? 0 : 1;
+}
+
+/* Timed: evaluating dice with a bound expression */
+int bench_random_value(void *state)
+{
+	static dice_t *dice;
+	random_value v;
+
+	if (!dice) {
+		expression_t *expression = expression_new();
+		dice = dice_new();
+		expression_set_base_value(expression, test_evaluate_base);
+		expression_add_operations_string(expression, "* 3 - 1");
+		dice_parse_string(dice, "$A + 2d3M$B");
+		dice_bind_expression(dice, "A", expression);
+		expression_free(expression);
+	}
+	dice_random_value(dice, &v);
+
+	return v.base == 8 ? 0 : 1;
+}
+
 const char *suite_name = "z-dice/dice";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "parse-success", test_parse_success },
 	{ "parse-failure", test_parse_failure },
 	{ "evaluate", test_evaluate },
+	{ "roll-batch", test_roll_batch },
+	{ "bench-evaluate", bench_evaluate, 1000, 100000 },
+	{ "bench-random-value", bench_random_value, 1000, 1000000 },
 	{ NULL, NULL },
 };
@@ -150,11 +150,49 @@ int test_evaluate(void *state)
 	ok;
 }
 
+/* Compiled expressions give the same results as applying each operation */
+int test_compile(void *state)
+{
+	expression_t *new = expression_new();
+	expression_t *copy;
+
+	expression_add_operations_string(new, "+ 4 5 - 2 * 3 2 n n * 7 / 4");
+	require(expression_evaluate(new) == (((4 + 5 - 2) * 3 * 2 * 7) / 4));
+	expression_add_operations_string(new, "n - 3 + 3 * 1");
+	require(expression_evaluate(new) == -73);
+
+	/* A copy takes the base value with it */
+	expression_set_base_value(new, base_value_2);
+	copy = expression_copy(new);
+	require(expression_evaluate(new) == -((((9 + 7) * 42) / 4)));
+	require(expression_evaluate(copy) == expression_evaluate(new));
+
+	expression_free(copy);
+	expression_free(new);
+	ok;
+}
+
+/* Timed: parsing and evaluating an expression */
+int bench_evaluate(void *state)
+{
+	expression_t *expression = expression_new();
+	int value;
+
+	if (expression_add_operations_string(expression, "* 3 - 1") < 0)
+		return 1;
+	value = expression_evaluate(expression);
+	expression_free(expression);
+
+	return value == -1 ? 0 : 1;
+}
+
 const char *suite_name = "z-expression/expression";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "parse-success", test_parse_success },
 	{ "parse-failure", test_parse_failure },
 	{ "evaluate", test_evaluate },
+	{ "compile", test_compile },
+	{ "bench-evaluate", bench_evaluate, 1000, 100000 },
 	{ NULL, NULL },
 };
@@ -46,9 +46,15 @@ int test_dedup(void *state) {
 	ok;
 }
 
+/* Timed: looking up a string already added */
+int bench_lookup(void *state) {
+	return quark_add("0-foo") ? 0 : 1;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "bench-lookup", bench_lookup, 1000, 200000 },
 	{ NULL, NULL }
 };
@@ -75,11 +75,70 @@ int test_length(void *state) {
 	ok;
 }
 
+int test_lines(void *state) {
+	textblock *tb = textblock_new();
+	const size_t *starts, *lengths, *starts2, *lengths2;
+	size_t *copy_starts = NULL, *copy_lengths = NULL;
+	size_t n;
+
+	textblock_append(tb, "one two three\nfour");
+
+	/* Wrapped at the last word and at the newline; unfinished lines wait */
+	n = textblock_lines(tb, &starts, &lengths, 8);
+	eq(n, 2);
+	eq(starts[0], 0);
+	eq(lengths[0], 7);
+	eq(starts[1], 8);
+	eq(lengths[1], 5);
+
+	/* The same width gives the kept layout */
+	n = textblock_lines(tb, &starts2, &lengths2, 8);
+	eq(n, 2);
+	ptreq(starts2, starts);
+	ptreq(lengths2, lengths);
+
+	/* The copying interface agrees */
+	n = textblock_calculate_lines(tb, &copy_starts, &copy_lengths, 8);
+	eq(n, 2);
+	require(!memcmp(copy_starts, starts, n * sizeof(size_t)));
+	require(!memcmp(copy_lengths, lengths, n * sizeof(size_t)));
+	mem_free(copy_starts);
+	mem_free(copy_lengths);
+
+	/* Appending lays the text out again */
+	textblock_append(tb, " five\n");
+	n = textblock_lines(tb, &starts, &lengths, 8);
+	eq(n, 4);
+	eq(starts[3], 19);
+	eq(lengths[3], 4);
+
+	textblock_free(tb);
+	ok;
+}
+
+/* Timed: building a block and splitting it into lines */
+int bench_append(void *state) {
+	textblock *tb = textblock_new();
+	const size_t *starts, *lengths;
+	size_t n;
+	int i;
+
+	for (i = 0; i < 20; i++)
+		textblock_append(tb, "It can breathe %s for up to %d damage. ",
+						 "fire", 100 + i);
+	n = textblock_lines(tb, &starts, &lengths, 80);
+	textblock_free(tb);
+
+	return n > 0 ? 0 : 1;
+}
+
 const char *suite_name = "z-textblock/textblock";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "append", test_append },
 	{ "colour", test_colour },
 	{ "length", test_length },
+	{ "lines", test_lines },
+	{ "bench-append", bench_append, 100, 10000 },
 	{ NULL, NULL }
 };
@@ -25,9 +25,67 @@ int test_realloc(void *state) {
 	return 0;
 }
 
+int test_account(void *state) {
+	const struct mem_stats *total = mem_tag_stats(MEM_TAG_MAX);
+	const struct mem_stats *cave = mem_tag_stats(MEM_TAG_CAVE);
+	const struct mem_stats *str = mem_tag_stats(MEM_TAG_STRING);
+	void *p0 = mem_alloc_tag(100, MEM_TAG_CAVE);
+	void *p1, *p2;
+	char *s;
+	int old;
+
+	/* Blocks allocated before accounting started are never counted */
+	mem_flags |= MEM_ACCOUNT;
+	eq(cave->live, 0);
+
+	p1 = mem_alloc_tag(100, MEM_TAG_CAVE);
+	eq(cave->live, 100);
+	eq(cave->blocks, 1);
+	eq(cave->sizes[3], 1);
+
+	/* Untagged allocations take the current tag, and keep it on resize */
+	old = mem_tag_set(MEM_TAG_CAVE);
+	p2 = mem_alloc(20);
+	mem_tag_set(old);
+	p2 = mem_realloc(p2, 50);
+	eq(cave->live, 150);
+	eq(cave->peak, 150);
+	eq(cave->blocks, 2);
+	eq(cave->sizes[1], 1);
+
+	s = string_make("hello");
+	eq(str->live, 6);
+
+	mem_free(p0);
+	mem_free(p1);
+	mem_free(p2);
+	string_free(s);
+	eq(cave->live, 0);
+	eq(cave->peak, 150);
+	eq(cave->blocks, 0);
+	eq(cave->frees, 2);
+	eq(str->live, 0);
+	eq(total->live, 0);
+
+	mem_stats_reset();
+	eq(cave->peak, 0);
+	eq(cave->allocs, 0);
+	mem_flags &= ~MEM_ACCOUNT;
+	ok;
+}
+
+/* Timed: an allocation and its release */
+int bench_alloc(void *state) {
+	void *p = mem_alloc(64);
+	mem_free(p);
+	return 0;
+}
+
 const char *suite_name = "z-virt/mem";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "realloc", test_realloc },
+	{ "account", test_account },
+	{ "bench-alloc", bench_alloc, 1000, 200000 },
 	{ NULL, NULL }
 };
@@ -53,6 +53,112 @@ struct trap_kind *lookup_trap(const char *desc)
 	return closest;
 }
 
+/* ------------------ Trap index ---------------- */
+
+/**
+ * Each chunk keeps every one of its traps in a dense array, so code looking
+ * for traps can visit just those rather than every grid, and for each grid
+ * the union of the flags of the traps on it, so flag queries don't walk the
+ * trap list.  The index is made when the first trap is placed; the traps
+ * themselves still belong to the grid lists.
+ */
+
+/**
+ * The flag summary of a grid, or NULL if the chunk has never had traps
+ */
+static bitflag *square_trap_flags(struct chunk *c, int y, int x)
+{
+	if (!c->trap_flags) return NULL;
+	return &c->trap_flags[(y * c->width + x) * TRF_SIZE];
+}
+
+/**
+ * Work out the flag summary of a grid again from its traps
+ */
+static void square_summarise_traps(struct chunk *c, int y, int x)
+{
+	bitflag *flags = square_trap_flags(c, y, x);
+	struct trap *trap;
+
+	if (!flags) return;
+
+	trf_wipe(flags);
+	for (trap = c->squares[y][x].trap; trap; trap = trap->next)
+		trf_union(flags, trap->flags);
+}
+
+/**
+ * Add a trap to the chunk index
+ */
+static void trap_index_add(struct chunk *c, struct trap *trap)
+{
+	if (!c->trap_flags)
+		c->trap_flags = mem_zalloc(c->height * c->width * TRF_SIZE *
+								   sizeof(bitflag));
+
+	if (c->trap_num == c->trap_alloc) {
+		c->trap_alloc = c->trap_alloc ? c->trap_alloc * 2 : 32;
+		c->traps = mem_realloc(c->traps, c->trap_alloc * sizeof(*c->traps));
+	}
+	c->traps[c->trap_num++] = trap;
+}
+
+/**
+ * Take a trap out of the chunk index
+ */
+static void trap_index_remove(struct chunk *c, struct trap *trap)
+{
+	int i;
+
+	for (i = 0; i < c->trap_num; i++) {
+		if (c->traps[i] != trap) continue;
+		c->traps[i] = c->traps[--c->trap_num];
+		return;
+	}
+}
+
+/**
+ * Add the traps of a grid to the chunk index.  Only needed by code which
+ * moves whole trap lists into a chunk, such as loading and level building;
+ * the traps must not already be in the index.
+ */
+void square_index_traps(struct chunk *c, int y, int x)
+{
+	struct trap *trap;
+
+	for (trap = c->squares[y][x].trap; trap; trap = trap->next)
+		trap_index_add(c, trap);
+	square_summarise_traps(c, y, x);
+}
+
+/**
+ * Take the traps of a grid out of the chunk index, before moving them
+ * elsewhere.
+ */
+void square_unindex_traps(struct chunk *c, int y, int x)
+{
+	struct trap *trap;
+
+	for (trap = c->squares[y][x].trap; trap; trap = trap->next)
+		trap_index_remove(c, trap);
+	if (c->trap_flags)
+		trf_wipe(square_trap_flags(c, y, x));
+}
+
+/**
+ * Get the traps of a chunk.
+ * \param c is the chunk
+ * \param num is set to the number of traps
+ * \return the traps, in no particular order
+ */
+struct trap **chunk_traps(struct chunk *c, int *num)
+{
+	*num = c->trap_num;
+	return c->traps;
+}
+
+/* ------------------ Trap queries ---------------- */
+
 /**
  * Is there a specific kind of trap in this square?
  */
@@ -81,22 +187,13 @@ bool square_trap_specific(struct chunk *c, int y, int x, int t_idx)
  */
 bool square_trap_flag(struct chunk *c, int y, int x, int flag)
 {
-    struct trap *trap = c->squares[y][x].trap;
+	bitflag *flags = square_trap_flags(c, y, x);
 
     /* First, check the trap marker */
-    if (!square_istrap(c, y, x))
+    if (!flags || !square_istrap(c, y, x))
 		return FALSE;
-	
-    /* Scan the square trap list */
-    while (trap) {
-		/* We found a trap with the right flag */
-		if (trf_has(trap->flags, flag))
-			return TRUE;
-		trap = trap->next;
-    }
 
-    /* Report failure */
-    return FALSE;
+	return trf_has(flags, flag);
 }
 
 /**
@@ -110,25 +207,21 @@ bool square_trap_flag(struct chunk *c, int y, int x, int flag)
 static bool square_verify_trap(struct chunk *c, int y, int x, int vis)
 {
     struct trap *trap = c->squares[y][x].trap;
-    bool trap_exists = FALSE;
+    bool trap_exists = trap ? TRUE : FALSE;
 
-    /* Scan the square trap list */
-    while (trap) {
-		/* Accept any trap */
-		if (!vis)
-			return TRUE;
+	/* Accept any trap */
+	if (trap && !vis)
+		return TRUE;
 
-		/* Accept traps that match visibility requirements */
-		if ((vis == 1) && trf_has(trap->flags, TRF_VISIBLE)) 
-			return TRUE;
+	/* Accept visible traps */
+	if ((vis == 1) && square_trap_flag(c, y, x, TRF_VISIBLE))
+		return TRUE;
 
-		if ((vis == -1)  && !trf_has(trap->flags, TRF_VISIBLE)) 
+    /* Scan the square trap list for invisible ones */
+    for (; trap && (vis == -1); trap = trap->next)
+		if (!trf_has(trap->flags, TRF_VISIBLE))
 			return TRUE;
 
-		/* Note that a trap does exist */
-		trap_exists = TRUE;
-    }
-
     /* No traps in this location. */
     if (!trap_exists) {
 		/* No traps */
@@ -255,6 +348,10 @@ void place_trap(struct chunk *c, int y, int x, int t_idx, int trap_level)
 	new_trap->fx = x;
 	trf_copy(new_trap->flags, trap_info[t_idx].flags);
 
+	/* Index it */
+	trap_index_add(c, new_trap);
+	square_summarise_traps(c, y, x);
+
 	/* Toggle on the trap marker */
 	sqinfo_on(c->squares[y][x].info, SQUARE_TRAP);
 
@@ -313,6 +410,8 @@ bool square_reveal_trap(struct chunk *c, int y, int x, int chance, bool domsg)
 
     /* We found at least one trap */
     if (found_trap) {
+		square_summarise_traps(c, y, x);
+
 		/* We want to talk about it */
 		if (domsg) {
 			if (found_trap == 1)
@@ -343,6 +442,10 @@ int num_traps(struct chunk *c, int y, int x, int vis)
     int num = 0;
 	struct trap *trap;
 
+	/* Nothing to count */
+	if (!square_trap_flag(c, y, x, TRF_TRAP))
+		return 0;
+
 	/* Look at the traps in this grid */
 	for (trap = c->squares[y][x].trap; trap; trap = trap->next) {
 		/* Require that trap be capable of affecting the character */
@@ -406,6 +509,7 @@ extern void hit_trap(int y, int x)
 		trf_on(trap->flags, TRF_VISIBLE);
 		sqinfo_on(cave->squares[y][x].info, SQUARE_MARK);
 	}
+	square_summarise_traps(cave, y, x);
 
     /* Verify traps (remove marker if appropriate) */
     (void)square_verify_trap(cave, y, x, 0);
@@ -426,6 +530,7 @@ static void remove_trap_aux(struct chunk *c, struct trap *trap, int y, int x,
 		msgt(MSG_DISARM, "You have disarmed the %s.", trap->kind->name);
 
     /* Wipe the trap */
+	trap_index_remove(c, trap);
 	mem_free(trap);
 }
 
@@ -461,6 +566,7 @@ bool square_remove_trap(struct chunk *c, int y, int x, bool domsg, int t_idx)
 		/* Replace with the next trap */
 		*trap_slot = next_trap;
     }
+	square_summarise_traps(c, y, x);
 
     /* Refresh grids that the character can see */
     if (square_isseen(c, y, x))
@@ -81,9 +81,13 @@ struct trap
 };
 
 struct trap_kind *lookup_trap(const char *desc);
+void square_index_traps(struct chunk *c, int y, int x);
+void square_unindex_traps(struct chunk *c, int y, int x);
+struct trap **chunk_traps(struct chunk *c, int *num);
 bool square_trap_specific(struct chunk *c, int y, int x, int t_idx);
 bool square_trap_flag(struct chunk *c, int y, int x, int flag);
 bool square_reveal_trap(struct chunk *c, int y, int x, int chance, bool domsg);
+int num_traps(struct chunk *c, int y, int x, int vis);
 bool trap_check_hit(int power);
 void hit_trap(int y, int x);
 bool square_player_trap_allowed(struct chunk *c, int y, int x);
@@ -848,7 +848,7 @@ static enum birth_stage get_name_command(void)
 	return next;
 }
 
-void get_screen_loc(size_t cursor, int *x, int *y, size_t n_lines, size_t *line_starts, size_t *line_lengths)
+void get_screen_loc(size_t cursor, int *x, int *y, size_t n_lines, const size_t *line_starts, const size_t *line_lengths)
 {
 	size_t lengths_so_far = 0;
 	size_t i;
@@ -877,7 +877,7 @@ int edit_text(char *buffer, int buflen) {
 		region area = { 1, HIST_INSTRUCT_ROW + 1, 71, 5 };
 		textblock *tb = textblock_new();
 
-		size_t *line_starts = NULL, *line_lengths = NULL;
+		const size_t *line_starts, *line_lengths;
 		size_t n_lines;
 
 		/* Display on screen */
@@ -886,8 +886,7 @@ int edit_text(char *buffer, int buflen) {
 		textblock_append(tb, "\n"); /* XXX This shouldn't be necessary */
 		textui_textblock_place(tb, area, NULL);
 
-		n_lines = textblock_calculate_lines(tb,
-				&line_starts, &line_lengths, area.width);
+		n_lines = textblock_lines(tb, &line_starts, &line_lengths, area.width);
 
 		/* Set cursor to current editing position */
 		get_screen_loc(cursor, &x, &y, n_lines, line_starts, line_lengths);
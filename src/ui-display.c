@@ -2138,7 +2138,9 @@ static void refresh(game_event_type type, game_event_data *data, void *user)
 		move_cursor_relative(row, col);
 	}
 
+	turn_timer_start(TIMER_REDRAW);
 	Term_fresh();
+	turn_timer_stop(TIMER_REDRAW);
 }
 
 static void repeated_command_display(game_event_type type,
@@ -26,10 +26,12 @@
 #include "angband.h"
 #include "game-input.h"
 #include "game-event.h"
+#include "mon-lore.h"
 #include "ui-display.h"
 #include "ui-game.h"
 #include "ui-input.h"
 #include "ui-keymap.h"
+#include "ui-mon-lore.h"
 #include "ui-knowledge.h"
 #include "ui-options.h"
 #include "ui-output.h"
@@ -105,4 +107,5 @@ void textui_cleanup(void)
 
 	keymap_free();
 	textui_prefs_free();
+	lore_cache_free();
 }
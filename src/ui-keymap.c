@@ -29,6 +29,10 @@
  * keypress and the action is stored as a string of keypresses, terminated
  * with a keypress with type == EVT_NONE.
  *
+ * Each mode keeps its keymaps in a list, newest first, which is the order
+ * they are dumped in, and in a hash table by trigger so that finding the
+ * keymap for a keypress doesn't mean walking the list.
+ *
  * XXX We should note when we read in keymaps that are "official game" keymaps
  * and ones which are user-defined.  Then we can avoid writing out official
  * game ones and messing up everyone's pref files with a load of junk.
@@ -45,14 +49,43 @@ struct keymap {
 	bool user;		/* User-defined keymap */
 
 	struct keymap *next;
+	struct keymap *prev;
+	struct keymap *hash_next;	/* Next keymap in the same bucket */
 };
 
 
+/**
+ * Number of hash buckets for each keymap mode
+ */
+#define KEYMAP_HASH_SIZE	256
+
+
 /**
  * List of keymaps.
  */
 static struct keymap *keymaps[KEYMAP_MODE_MAX];
 
+/**
+ * Keymaps by trigger.
+ */
+static struct keymap *keymap_hash[KEYMAP_MODE_MAX][KEYMAP_HASH_SIZE];
+
+
+/**
+ * Find the hash link that holds, or would hold, the keymap for a trigger.
+ */
+static struct keymap **keymap_link(int keymap, struct keypress kc)
+{
+	struct keymap **link;
+
+	link = &keymap_hash[keymap][(kc.code * 31 + kc.mods) % KEYMAP_HASH_SIZE];
+	while (*link && ((*link)->key.code != kc.code ||
+					 (*link)->key.mods != kc.mods))
+		link = &(*link)->hash_next;
+
+	return link;
+}
+
 
 /**
  * Find a keymap, given a keypress.
@@ -61,12 +94,9 @@ const struct keypress *keymap_find(int keymap, struct keypress kc)
 {
 	struct keymap *k;
 	assert(keymap >= 0 && keymap < KEYMAP_MODE_MAX);
-	for (k = keymaps[keymap]; k; k = k->next) {
-		if (k->key.code == kc.code && k->key.mods == kc.mods)
-			return k->actions;
-	}
 
-	return NULL;
+	k = *keymap_link(keymap, kc);
+	return k ? k->actions : NULL;
 }
 
 
@@ -99,6 +129,7 @@ static struct keypress *keymap_make(const struct keypress *actions)
 void keymap_add(int keymap, struct keypress trigger, struct keypress *actions, bool user)
 {
 	struct keymap *k = mem_zalloc(sizeof *k);
+	struct keymap **link;
 	assert(keymap >= 0 && keymap < KEYMAP_MODE_MAX);
 
 	keymap_remove(keymap, trigger);
@@ -108,8 +139,14 @@ void keymap_add(int keymap, struct keypress trigger, struct keypress *actions, b
 	k->user = user;
 
 	k->next = keymaps[keymap];
+	if (k->next)
+		k->next->prev = k;
 	keymaps[keymap] = k;
 
+	/* The removal above leaves the link at the end of its bucket */
+	link = keymap_link(keymap, trigger);
+	*link = k;
+
 	return;
 }
 
@@ -119,25 +156,25 @@ void keymap_add(int keymap, struct keypress trigger, struct keypress *actions, b
  */
 bool keymap_remove(int keymap, struct keypress trigger)
 {
+	struct keymap **link;
 	struct keymap *k;
-	struct keymap *prev = NULL;
 	assert(keymap >= 0 && keymap < KEYMAP_MODE_MAX);
 
-	for (k = keymaps[keymap]; k; k = k->next) {
-		if (k->key.code == trigger.code && k->key.mods == trigger.mods) {
-			mem_free(k->actions);
-			if (prev)
-				prev->next = k->next;
-			else
-				keymaps[keymap] = k->next;
-			mem_free(k);
-			return TRUE;
-		}
+	link = keymap_link(keymap, trigger);
+	k = *link;
+	if (!k) return FALSE;
 
-		prev = k;
-	}
+	*link = k->hash_next;
+	if (k->prev)
+		k->prev->next = k->next;
+	else
+		keymaps[keymap] = k->next;
+	if (k->next)
+		k->next->prev = k->prev;
 
-	return FALSE;
+	mem_free(k->actions);
+	mem_free(k);
+	return TRUE;
 }
 
 
@@ -156,7 +193,10 @@ void keymap_free(void)
 			mem_free(k);
 			k = next;
 		}
+		keymaps[i] = NULL;
 	}
+
+	memset(keymap_hash, 0, sizeof(keymap_hash));
 }
 
 
@@ -17,6 +17,7 @@
  */
 
 #include "angband.h"
+#include "init.h"
 #include "mon-lore.h"
 #include "ui-mon-lore.h"
 #include "ui-output.h"
@@ -75,18 +76,68 @@ void lore_title(textblock *tb, const monster_race *race)
 }
 
 /**
- * Place a full monster recall description (with title) into a textblock, with
- * or without spoilers.
- *
- * \param tb is the textblock we are placing the description into.
- * \param race is the monster race we are describing.
- * \param original_lore is the known information about the monster race.
- * \param spoilers indicates what information is used; `TRUE` will display full
- *        information without subjective information and monster flavor,
- *        while `FALSE` only shows what the player knows.
+ * Number of monster descriptions to keep
  */
-void lore_description(textblock *tb, const monster_race *race,
-					  const monster_lore *original_lore, bool spoilers)
+#define LORE_CACHE_SIZE	8
+
+/**
+ * Recently built monster descriptions
+ */
+static textblock_cache *lore_cache;
+
+/**
+ * Make the key for a cached description: everything it depends on, which is
+ * the race, what is known about it, the options which change it, and the
+ * player's state.
+ * \return the key, to be freed with mem_free()
+ */
+static byte *lore_cache_key(const monster_race *race, const monster_lore *lore,
+							size_t *len)
+{
+	struct {
+		const monster_race *race;
+		u32b version;
+		bool cheat_know;
+		bool purple_uniques;
+		monster_lore lore;
+	} head;
+	size_t blows = z_info->mon_blows_max * sizeof(struct monster_blow);
+	size_t known = z_info->mon_blows_max * sizeof(bool);
+	byte *key;
+
+	memset(&head, 0, sizeof(head));
+	head.race = race;
+	head.version = player->upkeep->version;
+	head.cheat_know = OPT(cheat_know);
+	head.purple_uniques = OPT(purple_uniques);
+	memcpy(&head.lore, lore, sizeof(*lore));
+
+	*len = sizeof(head) + blows + known;
+	key = mem_zalloc(*len);
+	memcpy(key, &head, sizeof(head));
+	if (lore->blows)
+		memcpy(key + sizeof(head), lore->blows, blows);
+	if (lore->blow_known)
+		memcpy(key + sizeof(head) + blows, lore->blow_known, known);
+
+	return key;
+}
+
+/**
+ * Free the recently built monster descriptions
+ */
+void lore_cache_free(void)
+{
+	textblock_cache_free(lore_cache);
+	lore_cache = NULL;
+}
+
+/**
+ * Build the description of a monster; see lore_description().
+ */
+static void lore_description_aux(textblock *tb, const monster_race *race,
+								 const monster_lore *original_lore,
+								 bool spoilers)
 {
 	monster_lore mutable_lore;
 	monster_lore *lore = &mutable_lore;
@@ -152,6 +203,51 @@ void lore_description(textblock *tb, const monster_race *race,
 	textblock_append(tb, "\n");
 }
 
+/**
+ * Place a full monster recall description (with title) into a textblock, with
+ * or without spoilers.
+ *
+ * \param tb is the textblock we are placing the description into.
+ * \param race is the monster race we are describing.
+ * \param original_lore is the known information about the monster race.
+ * \param spoilers indicates what information is used; `TRUE` will display full
+ *        information without subjective information and monster flavor,
+ *        while `FALSE` only shows what the player knows.
+ */
+void lore_description(textblock *tb, const monster_race *race,
+					  const monster_lore *original_lore, bool spoilers)
+{
+	const textblock *cached;
+	textblock *built;
+	byte *key;
+	size_t key_len;
+
+	assert(tb && race && original_lore);
+
+	/* Spoilers are only made once, so aren't worth keeping */
+	if (spoilers) {
+		lore_description_aux(tb, race, original_lore, TRUE);
+		return;
+	}
+
+	/* Reuse the last description if nothing it depends on has changed */
+	if (!lore_cache)
+		lore_cache = textblock_cache_new(LORE_CACHE_SIZE);
+	key = lore_cache_key(race, original_lore, &key_len);
+	cached = textblock_cache_find(lore_cache, key, key_len);
+	if (cached) {
+		textblock_append_textblock(tb, cached);
+	} else {
+		/* Build into a block of its own, so it can be kept */
+		built = textblock_new();
+		lore_description_aux(built, race, original_lore, FALSE);
+		textblock_cache_add(lore_cache, key, key_len, built);
+		textblock_append_textblock(tb, built);
+		textblock_free(built);
+	}
+	mem_free(key);
+}
+
 /**
  * Display monster recall modally and wait for a keypress.
  *
@@ -100,7 +100,7 @@ bool region_inside(const region *loc, const ui_event *key)
  * Utility function
  */
 static void display_area(const wchar_t *text, const byte *attrs,
-		size_t *line_starts, size_t *line_lengths,
+		const size_t *line_starts, const size_t *line_lengths,
 		size_t n_lines,
 		region area, size_t line_from)
 {
@@ -126,11 +126,10 @@ void textui_textblock_place(textblock *tb, region orig_area, const char *header)
 	/* xxx on resize this should be recalculated */
 	region area = region_calculate(orig_area);
 
-	size_t *line_starts = NULL, *line_lengths = NULL;
+	const size_t *line_starts, *line_lengths;
 	size_t n_lines;
 
-	n_lines = textblock_calculate_lines(tb,
-			&line_starts, &line_lengths, area.width);
+	n_lines = textblock_lines(tb, &line_starts, &line_lengths, area.width);
 
 	if (header != NULL) {
 		area.page_rows--;
@@ -143,9 +142,6 @@ void textui_textblock_place(textblock *tb, region orig_area, const char *header)
 
 	display_area(textblock_text(tb), textblock_attrs(tb), line_starts,
 	             line_lengths, n_lines, area, 0);
-
-	mem_free(line_starts);
-	mem_free(line_lengths);
 }
 
 /**
@@ -156,11 +152,10 @@ void textui_textblock_show(textblock *tb, region orig_area, const char *header)
 	/* xxx on resize this should be recalculated */
 	region area = region_calculate(orig_area);
 
-	size_t *line_starts = NULL, *line_lengths = NULL;
+	const size_t *line_starts, *line_lengths;
 	size_t n_lines;
 
-	n_lines = textblock_calculate_lines(tb,
-			&line_starts, &line_lengths, area.width);
+	n_lines = textblock_lines(tb, &line_starts, &line_lengths, area.width);
 
 	screen_save();
 
@@ -212,9 +207,6 @@ void textui_textblock_show(textblock *tb, region orig_area, const char *header)
 		inkey();
 	}
 
-	mem_free(line_starts);
-	mem_free(line_lengths);
-
 	screen_load();
 
 	return;
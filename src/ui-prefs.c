@@ -18,6 +18,7 @@
  *    are included in all such copies.  Other copyrights may also apply.
  */
 #include "angband.h"
+#include "buildid.h"
 #include "cave.h"
 #include "game-input.h"
 #include "grafmode.h"
@@ -38,6 +39,7 @@
 int arg_graphics;			/* Command arg -- Request graphics mode */
 bool arg_graphics_nice;		/* Command arg -- Request nice graphics mode */
 int use_graphics;			/* The "graphics" mode is enabled */
+bool use_pref_cache = TRUE;	/* Keep compiled pref files in the user's cache */
 
 byte *monster_x_attr;
 wchar_t *monster_x_char;
@@ -406,6 +408,276 @@ struct prefs_data
 };
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Compiled pref cache
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Reading a pref file, the files it includes and all the lookups by name
+ * they need is slow, particularly from a home directory on a network.  So
+ * when a top level pref file loads cleanly, what it did is kept in the
+ * user's cache directory as a list of resolved operations - "give monster 12
+ * this glyph", "add this keymap" - along with the files that were looked
+ * for and the pref file variables that were tested.  Next time, if none of
+ * those files has changed and the variables have the same values, the
+ * operations are replayed from the one file instead.
+ *
+ * A file counts as unchanged only if its size and modification time are
+ * exactly as recorded.  The operations refer to monsters, objects and so on
+ * by index, so the cache is also tied to the edit files those come from.
+ */
+#define PREF_CACHE_MAGIC	"PRFC"
+#define PREF_CACHE_VERSION	2
+
+/**
+ * The edit files that give the indexes the operations use
+ */
+static const char *pref_cache_edit_files[] = {
+	"monster.txt",
+	"object.txt",
+	"terrain.txt",
+	"trap.txt",
+	"flavor.txt"
+};
+
+/**
+ * Checksums of the edit files, which the game never changes while it runs
+ */
+static struct {
+	bool done;
+	u32b sum[N_ELEMENTS(pref_cache_edit_files)];
+	u32b size[N_ELEMENTS(pref_cache_edit_files)];
+} pref_cache_edit_sums;
+
+enum pref_op {
+	PREF_OP_END = 0,
+	PREF_OP_OBJECT,
+	PREF_OP_MONSTER,
+	PREF_OP_FEAT,
+	PREF_OP_TRAP,
+	PREF_OP_GF,
+	PREF_OP_FLAVOR,
+	PREF_OP_INSCRIBE,
+	PREF_OP_KEYMAP,
+	PREF_OP_MESSAGE,
+	PREF_OP_COLOR,
+	PREF_OP_WINDOW,
+	PREF_OP_BEGIN,
+	PREF_OP_FINISH
+};
+
+enum pref_dep {
+	PREF_DEP_FILE,
+	PREF_DEP_VAR
+};
+
+/**
+ * A growing buffer of cache data
+ */
+struct pref_buf {
+	byte *data;
+	size_t len;
+	size_t alloc;
+};
+
+/**
+ * What a pref file load has done so far
+ */
+struct pref_record {
+	struct pref_buf deps;
+	u16b num_deps;
+	struct pref_buf ops;
+	bool failed;
+};
+
+/**
+ * The load being recorded, if any
+ */
+static struct pref_record *pref_recording;
+
+/**
+ * Make room for len more bytes in a buffer
+ */
+static void pref_reserve(struct pref_buf *b, size_t len)
+{
+	if (b->len + len <= b->alloc) return;
+
+	while (b->len + len > b->alloc)
+		b->alloc = b->alloc ? b->alloc * 2 : 1024;
+	b->data = mem_realloc(b->data, b->alloc);
+}
+
+static void pref_put(struct pref_buf *b, const void *data, size_t len)
+{
+	if (!len) return;
+
+	pref_reserve(b, len);
+	memcpy(b->data + b->len, data, len);
+	b->len += len;
+}
+
+static void pref_put_byte(struct pref_buf *b, byte v)
+{
+	pref_put(b, &v, 1);
+}
+
+static void pref_put_u16b(struct pref_buf *b, u16b v)
+{
+	pref_put_byte(b, (byte) (v >> 8));
+	pref_put_byte(b, (byte) v);
+}
+
+static void pref_put_u32b(struct pref_buf *b, u32b v)
+{
+	pref_put_u16b(b, (u16b) (v >> 16));
+	pref_put_u16b(b, (u16b) v);
+}
+
+static void pref_put_str(struct pref_buf *b, const char *str)
+{
+	size_t len = strlen(str);
+
+	pref_put_u16b(b, (u16b) len);
+	pref_put(b, str, len);
+}
+
+static void pref_put_key(struct pref_buf *b, struct keypress key)
+{
+	pref_put_byte(b, (byte) key.type);
+	pref_put_u32b(b, key.code);
+	pref_put_byte(b, key.mods);
+}
+
+/**
+ * Note whether a file a load looked for was there, and if so its size and
+ * modification time.
+ */
+static void pref_note_file(const char *path, bool exists)
+{
+	u32b size = 0, mtime = 0;
+
+	if (!pref_recording) return;
+
+	/* A file we can't stat can't be checked later */
+	if (exists && !file_stat(path, &size, &mtime))
+		pref_recording->failed = TRUE;
+
+	pref_put_byte(&pref_recording->deps, PREF_DEP_FILE);
+	pref_put_str(&pref_recording->deps, path);
+	pref_put_byte(&pref_recording->deps, exists ? 1 : 0);
+	if (exists) {
+		pref_put_u32b(&pref_recording->deps, size);
+		pref_put_u32b(&pref_recording->deps, mtime);
+	}
+	pref_recording->num_deps++;
+}
+
+/**
+ * Note the value a load found for a pref file variable.
+ */
+static void pref_note_var(const char *name, const char *value)
+{
+	if (!pref_recording) return;
+
+	pref_put_byte(&pref_recording->deps, PREF_DEP_VAR);
+	pref_put_str(&pref_recording->deps, name);
+	pref_put_str(&pref_recording->deps, value ? value : "");
+	pref_recording->num_deps++;
+}
+
+/**
+ * Note a glyph being set; light is the lighting for features and traps,
+ * and the motion for projections.
+ */
+static void pref_note_glyph(enum pref_op op, int light, int idx, byte attr,
+							wchar_t ch)
+{
+	struct pref_buf *b;
+
+	if (!pref_recording) return;
+
+	b = &pref_recording->ops;
+	pref_put_byte(b, op);
+	pref_put_byte(b, (byte) light);
+	pref_put_u16b(b, (u16b) idx);
+	pref_put_byte(b, attr);
+	pref_put_u32b(b, (u32b) ch);
+}
+
+static void pref_note_inscription(int kidx, const char *text)
+{
+	if (!pref_recording) return;
+
+	pref_put_byte(&pref_recording->ops, PREF_OP_INSCRIBE);
+	pref_put_u16b(&pref_recording->ops, (u16b) kidx);
+	pref_put_str(&pref_recording->ops, text);
+}
+
+static void pref_note_keymap(int mode, struct keypress trigger,
+							 const struct keypress *actions, bool user)
+{
+	struct pref_buf *b;
+	size_t n = 0;
+
+	if (!pref_recording) return;
+
+	while (n < KEYMAP_ACTION_MAX && actions[n].type != EVT_NONE)
+		n++;
+
+	b = &pref_recording->ops;
+	pref_put_byte(b, PREF_OP_KEYMAP);
+	pref_put_byte(b, (byte) mode);
+	pref_put_byte(b, user ? 1 : 0);
+	pref_put_key(b, trigger);
+	pref_put_byte(b, (byte) n);
+	while (n--)
+		pref_put_key(b, *actions++);
+}
+
+static void pref_note_message(int type, byte attr)
+{
+	if (!pref_recording) return;
+
+	pref_put_byte(&pref_recording->ops, PREF_OP_MESSAGE);
+	pref_put_u16b(&pref_recording->ops, (u16b) type);
+	pref_put_byte(&pref_recording->ops, attr);
+}
+
+static void pref_note_color(int idx)
+{
+	if (!pref_recording) return;
+
+	pref_put_byte(&pref_recording->ops, PREF_OP_COLOR);
+	pref_put_byte(&pref_recording->ops, (byte) idx);
+	pref_put(&pref_recording->ops, angband_color_table[idx], 4);
+}
+
+static void pref_note_window(int window, size_t flag, int value)
+{
+	if (!pref_recording) return;
+
+	pref_put_byte(&pref_recording->ops, PREF_OP_WINDOW);
+	pref_put_byte(&pref_recording->ops, (byte) window);
+	pref_put_byte(&pref_recording->ops, (byte) flag);
+	pref_put_byte(&pref_recording->ops, value ? 1 : 0);
+}
+
+static void pref_note_begin(void)
+{
+	if (!pref_recording) return;
+
+	pref_put_byte(&pref_recording->ops, PREF_OP_BEGIN);
+}
+
+static void pref_note_finish(void)
+{
+	if (!pref_recording) return;
+
+	pref_put_byte(&pref_recording->ops, PREF_OP_FINISH);
+}
+
+
 /**
  * Load another file.
  */
@@ -423,6 +695,23 @@ static enum parser_error parse_prefs_load(struct parser *p)
 	return PARSE_ERROR_NONE;
 }
 
+/**
+ * The value of a pref file variable, or NULL if it has none
+ */
+static const char *pref_var_value(const char *name)
+{
+	if (streq(name, "SYS"))
+		return ANGBAND_SYS;
+	else if (streq(name, "RACE"))
+		return player->race ? player->race->name : NULL;
+	else if (streq(name, "CLASS"))
+		return player->class ? player->class->name : NULL;
+	else if (streq(name, "PLAYER"))
+		return player_safe_name(player, TRUE);
+
+	return NULL;
+}
+
 /**
  * Helper function for "process_pref_file()"
  *
@@ -536,14 +825,10 @@ static const char *process_pref_file_expr(char **sp, char *fp)
 
 		/* Variables start with $, otherwise it's a constant */
 		if (*b == '$') {
-			if (streq(b+1, "SYS"))
-				v = ANGBAND_SYS;
-			else if (streq(b+1, "RACE"))
-				v = player->race->name;
-			else if (streq(b+1, "CLASS"))
-				v = player->class->name;
-			else if (streq(b+1, "PLAYER"))
-				v = player_safe_name(player, TRUE);
+			const char *value = pref_var_value(b + 1);
+
+			pref_note_var(b + 1, value);
+			if (value) v = value;
 		} else {
 			v = b;
 		}
@@ -607,6 +892,8 @@ static enum parser_error parse_prefs_object(struct parser *p)
 
 	kind_x_attr[kind->kidx] = (byte)parser_getint(p, "attr");
 	kind_x_char[kind->kidx] = (wchar_t)parser_getint(p, "char");
+	pref_note_glyph(PREF_OP_OBJECT, 0, kind->kidx, kind_x_attr[kind->kidx],
+					kind_x_char[kind->kidx]);
 
 	return PARSE_ERROR_NONE;
 }
@@ -627,6 +914,9 @@ static enum parser_error parse_prefs_monster(struct parser *p)
 
 	monster_x_attr[monster->ridx] = (byte)parser_getint(p, "attr");
 	monster_x_char[monster->ridx] = (wchar_t)parser_getint(p, "char");
+	pref_note_glyph(PREF_OP_MONSTER, 0, monster->ridx,
+					monster_x_attr[monster->ridx],
+					monster_x_char[monster->ridx]);
 
 	return PARSE_ERROR_NONE;
 }
@@ -668,6 +958,8 @@ static enum parser_error parse_prefs_trap(struct parser *p)
 			trap_x_char[light_idx][idx] = (wchar_t)parser_getint(p, "char");
 		}
 	}
+	pref_note_glyph(PREF_OP_TRAP, light_idx, idx, (byte)parser_getint(p, "attr"),
+					(wchar_t)parser_getint(p, "char"));
 
 	return PARSE_ERROR_NONE;
 }
@@ -709,6 +1001,8 @@ static enum parser_error parse_prefs_feat(struct parser *p)
 			feat_x_char[light_idx][idx] = (wchar_t)parser_getint(p, "char");
 		}
 	}
+	pref_note_glyph(PREF_OP_FEAT, light_idx, idx, (byte)parser_getint(p, "attr"),
+					(wchar_t)parser_getint(p, "char"));
 
 	return PARSE_ERROR_NONE;
 }
@@ -765,6 +1059,8 @@ static enum parser_error parse_prefs_gf(struct parser *p)
 
 		gf_to_attr[i][motion] = (byte)parser_getuint(p, "attr");
 		gf_to_char[i][motion] = (wchar_t)parser_getuint(p, "char");
+		pref_note_glyph(PREF_OP_GF, motion, i, gf_to_attr[i][motion],
+						gf_to_char[i][motion]);
 	}
 
 	return PARSE_ERROR_NONE;
@@ -787,6 +1083,8 @@ static enum parser_error parse_prefs_flavor(struct parser *p)
 	if (flavor) {
 		flavor_x_attr[idx] = (byte)parser_getint(p, "attr");
 		flavor_x_char[idx] = (wchar_t)parser_getint(p, "char");
+		pref_note_glyph(PREF_OP_FLAVOR, 0, idx, flavor_x_attr[idx],
+						flavor_x_char[idx]);
 	}
 
 	return PARSE_ERROR_NONE;
@@ -814,6 +1112,7 @@ static enum parser_error parse_prefs_inscribe(struct parser *p)
 		return PARSE_ERROR_UNRECOGNISED_SVAL;
 
 	add_autoinscription(kind->kidx, parser_getstr(p, "text"));
+	pref_note_inscription(kind->kidx, parser_getstr(p, "text"));
 
 	return PARSE_ERROR_NONE;
 }
@@ -852,6 +1151,7 @@ static enum parser_error parse_prefs_keymap_input(struct parser *p)
 		return PARSE_ERROR_FIELD_TOO_LONG;
 
 	keymap_add(mode, tmp[0], d->keymap_buffer, d->user);
+	pref_note_keymap(mode, tmp[0], d->keymap_buffer, d->user);
 
 	return PARSE_ERROR_NONE;
 }
@@ -883,6 +1183,7 @@ static enum parser_error parse_prefs_message(struct parser *p)
 		return PARSE_ERROR_INVALID_COLOR;
 
 	message_color_define(msg_index, (byte)a);
+	pref_note_message(msg_index, (byte)a);
 
 	return PARSE_ERROR_NONE;
 }
@@ -896,17 +1197,35 @@ static enum parser_error parse_prefs_color(struct parser *p)
 	if (d->bypass) return PARSE_ERROR_NONE;
 
 	idx = parser_getuint(p, "idx");
-	if (idx > MAX_COLORS)
+	if (idx >= MAX_COLORS)
 		return PARSE_ERROR_OUT_OF_BOUNDS;
 
 	angband_color_table[idx][0] = parser_getint(p, "k");
 	angband_color_table[idx][1] = parser_getint(p, "r");
 	angband_color_table[idx][2] = parser_getint(p, "g");
 	angband_color_table[idx][3] = parser_getint(p, "b");
+	pref_note_color(idx);
 
 	return PARSE_ERROR_NONE;
 }
 
+/**
+ * Set a subwindow flag, to be applied when the file is finished
+ */
+static void prefs_set_window_flag(struct prefs_data *d, int window,
+								  size_t flag, int value)
+{
+	if (window_flag_desc[flag])
+	{
+		if (value)
+			d->window_flags[window] |= (1L << flag);
+		else
+			d->window_flags[window] &= ~(1L << flag);
+	}
+
+	d->loaded_window_flag[window] = TRUE;
+}
+
 static enum parser_error parse_prefs_window(struct parser *p)
 {
 	int window;
@@ -924,16 +1243,8 @@ static enum parser_error parse_prefs_window(struct parser *p)
 	if (flag >= N_ELEMENTS(window_flag_desc))
 		return PARSE_ERROR_OUT_OF_BOUNDS;
 
-	if (window_flag_desc[flag])
-	{
-		int value = parser_getuint(p, "value");
-		if (value)
-			d->window_flags[window] |= (1L << flag);
-		else
-			d->window_flags[window] &= ~(1L << flag);
-	}
-
-	d->loaded_window_flag[window] = TRUE;
+	prefs_set_window_flag(d, window, flag, parser_getuint(p, "value"));
+	pref_note_window(window, flag, parser_getuint(p, "value"));
 
 	return PARSE_ERROR_NONE;
 }
@@ -968,9 +1279,11 @@ static struct parser *init_parse_prefs(bool user)
 	return p;
 }
 
-static errr finish_parse_prefs(struct parser *p)
+/**
+ * Apply the subwindow flags read from a file
+ */
+static void prefs_finish_windows(struct prefs_data *d)
 {
-	struct prefs_data *d = parser_priv(p);
 	int i;
 
 	/* Update sub-windows based on the newly read-in prefs.
@@ -987,6 +1300,12 @@ static errr finish_parse_prefs(struct parser *p)
 			d->window_flags[i] = window_flag[i];
 	}
 	subwindows_set_flags(d->window_flags, ANGBAND_TERM_MAX);
+}
+
+static errr finish_parse_prefs(struct parser *p)
+{
+	prefs_finish_windows(parser_priv(p));
+	pref_note_finish();
 
 	return PARSE_ERROR_NONE;
 }
@@ -1003,6 +1322,10 @@ errr process_pref_file_command(const char *s)
 
 static void print_error(const char *name, struct parser *p) {
 	struct parser_state s;
+
+	/* Loads with errors aren't cached, so the errors are seen again */
+	if (pref_recording) pref_recording->failed = TRUE;
+
 	parser_getstate(p, &s);
 	msg("Parse error in %s line %d column %d: %s: %s", name,
 	           s.line, s.col, s.msg, parser_error_str[s.error]);
@@ -1045,6 +1368,7 @@ static bool process_pref_file_layered(const char *name, bool quiet, bool user,
 		*used_fallback = FALSE;
 
 	if (!file_exists(buf) && fallback_search_path != NULL) {
+		pref_note_file(buf, FALSE);
 		path_build(buf, sizeof(buf), fallback_search_path, name);
 
 		if (used_fallback != NULL)
@@ -1052,15 +1376,19 @@ static bool process_pref_file_layered(const char *name, bool quiet, bool user,
 	}
 
 	f = file_open(buf, MODE_READ, -1);
+	pref_note_file(buf, f != NULL);
 	if (!f) {
-		if (!quiet)
+		if (!quiet) {
 			msg("Cannot open '%s'.", buf);
+			if (pref_recording) pref_recording->failed = TRUE;
+		}
 
 		e = PARSE_ERROR_INTERNAL; /* signal failure to callers */
 	} else {
 		char line[1024];
 
 		p = init_parse_prefs(user);
+		pref_note_begin();
 		while (file_getl(f, line, sizeof line)) {
 			line_no++;
 
@@ -1081,6 +1409,431 @@ static bool process_pref_file_layered(const char *name, bool quiet, bool user,
 	return e == PARSE_ERROR_NONE;
 }
 
+/**
+ * Reading back a cache file
+ */
+struct pref_reader {
+	const byte *data;
+	size_t len;
+	size_t pos;
+	bool bad;
+};
+
+static byte pref_get_byte(struct pref_reader *r)
+{
+	if (r->pos >= r->len) {
+		r->bad = TRUE;
+		return 0;
+	}
+
+	return r->data[r->pos++];
+}
+
+static u16b pref_get_u16b(struct pref_reader *r)
+{
+	u16b v = pref_get_byte(r) << 8;
+	return v | pref_get_byte(r);
+}
+
+static u32b pref_get_u32b(struct pref_reader *r)
+{
+	u32b v = (u32b) pref_get_u16b(r) << 16;
+	return v | pref_get_u16b(r);
+}
+
+static void pref_get_str(struct pref_reader *r, char *buf, size_t n)
+{
+	size_t len = pref_get_u16b(r);
+
+	buf[0] = '\0';
+	if (r->bad || len >= n || r->pos + len > r->len) {
+		r->bad = TRUE;
+		return;
+	}
+
+	memcpy(buf, r->data + r->pos, len);
+	buf[len] = '\0';
+	r->pos += len;
+}
+
+static struct keypress pref_get_key(struct pref_reader *r)
+{
+	struct keypress key;
+
+	key.type = pref_get_byte(r);
+	key.code = pref_get_u32b(r);
+	key.mods = pref_get_byte(r);
+	return key;
+}
+
+/**
+ * Describe what a top level load depends on besides the files it reads
+ */
+static void pref_cache_key(char *buf, size_t len, const char *name, bool user)
+{
+	strnfmt(buf, len, "%s|%d|%s|%s|%s", name, user ? 1 : 0, ANGBAND_SYS,
+			(player && player->race) ? player->race->name : "",
+			(player && player->class) ? player->class->name : "");
+}
+
+/**
+ * Find the cache file for a key
+ */
+static void pref_cache_path(char *buf, size_t len, const char *key)
+{
+	char dir[1024];
+	char leaf[32];
+	u32b hash = 2166136261UL;
+
+	/* FNV-1a */
+	for (; *key; key++)
+		hash = (hash ^ (byte) *key) * 16777619UL;
+
+	path_build(dir, sizeof(dir), ANGBAND_DIR_USER, "cache");
+	strnfmt(leaf, sizeof(leaf), "prefs-%08lx.cache", (unsigned long) hash);
+	path_build(buf, len, dir, leaf);
+}
+
+/**
+ * The start of a cache file, which must match exactly for it to be used
+ */
+static void pref_cache_header(struct pref_buf *b, const char *key)
+{
+	size_t i;
+
+	pref_put(b, PREF_CACHE_MAGIC, 4);
+	pref_put_u16b(b, PREF_CACHE_VERSION);
+	pref_put_str(b, VERSION_STRING);
+	pref_put_str(b, key);
+	pref_put_u16b(b, z_info->r_max);
+	pref_put_u16b(b, z_info->k_max);
+	pref_put_u16b(b, z_info->f_max);
+	pref_put_u16b(b, z_info->trap_max);
+	pref_put_u16b(b, (u16b) flavor_max);
+
+	/* A missing edit file makes a header no cache file matches */
+	for (i = 0; i < N_ELEMENTS(pref_cache_edit_files); i++) {
+		if (!pref_cache_edit_sums.done) {
+			char path[1024];
+			u32b *sum = &pref_cache_edit_sums.sum[i];
+			u32b *size = &pref_cache_edit_sums.size[i];
+
+			path_build(path, sizeof(path), ANGBAND_DIR_EDIT,
+					   pref_cache_edit_files[i]);
+			if (!file_checksum(path, sum, size)) *size = (u32b) -1;
+		}
+		pref_put_u32b(b, pref_cache_edit_sums.sum[i]);
+		pref_put_u32b(b, pref_cache_edit_sums.size[i]);
+	}
+	pref_cache_edit_sums.done = TRUE;
+}
+
+/**
+ * Check that none of the files a cached load read have changed, and that the
+ * variables it tested have the same values.
+ */
+static bool pref_cache_check_deps(struct pref_reader *r)
+{
+	char name[1024];
+	char value[1024];
+	u16b num = pref_get_u16b(r);
+
+	while (num-- && !r->bad) {
+		byte dep = pref_get_byte(r);
+
+		pref_get_str(r, name, sizeof(name));
+		if (dep == PREF_DEP_FILE) {
+			bool exists = pref_get_byte(r) ? TRUE : FALSE;
+			u32b size, mtime, now_size, now_mtime;
+
+			if (r->bad || file_exists(name) != exists) return FALSE;
+			if (!exists) continue;
+
+			/* The file must be just as it was */
+			size = pref_get_u32b(r);
+			mtime = pref_get_u32b(r);
+			if (r->bad || !file_stat(name, &now_size, &now_mtime))
+				return FALSE;
+			if (now_size != size || now_mtime != mtime) return FALSE;
+		} else if (dep == PREF_DEP_VAR) {
+			const char *now = pref_var_value(name);
+
+			pref_get_str(r, value, sizeof(value));
+			if (r->bad || !streq(value, now ? now : "")) return FALSE;
+		} else {
+			return FALSE;
+		}
+	}
+
+	return !r->bad;
+}
+
+/**
+ * Set a cached glyph, if it is in range
+ */
+static bool pref_replay_glyph(int op, int light, int idx, byte attr,
+							  wchar_t ch, bool apply)
+{
+	int i;
+
+	switch (op) {
+		case PREF_OP_OBJECT:
+			if (idx >= z_info->k_max) return FALSE;
+			if (apply) {
+				kind_x_attr[idx] = attr;
+				kind_x_char[idx] = ch;
+			}
+			break;
+		case PREF_OP_MONSTER:
+			if (idx >= z_info->r_max) return FALSE;
+			if (apply) {
+				monster_x_attr[idx] = attr;
+				monster_x_char[idx] = ch;
+			}
+			break;
+		case PREF_OP_FEAT:
+			if (idx >= z_info->f_max || light > LIGHTING_MAX) return FALSE;
+			for (i = 0; apply && i < LIGHTING_MAX; i++) {
+				if (light < LIGHTING_MAX && i != light) continue;
+				feat_x_attr[i][idx] = attr;
+				feat_x_char[i][idx] = ch;
+			}
+			break;
+		case PREF_OP_TRAP:
+			if (idx >= z_info->trap_max || light > LIGHTING_MAX) return FALSE;
+			for (i = 0; apply && i < LIGHTING_MAX; i++) {
+				if (light < LIGHTING_MAX && i != light) continue;
+				trap_x_attr[i][idx] = attr;
+				trap_x_char[i][idx] = ch;
+			}
+			break;
+		case PREF_OP_GF:
+			if (idx >= GF_MAX || light >= BOLT_MAX) return FALSE;
+			if (apply) {
+				gf_to_attr[idx][light] = attr;
+				gf_to_char[idx][light] = ch;
+			}
+			break;
+		case PREF_OP_FLAVOR:
+			if ((size_t) idx > flavor_max) return FALSE;
+			if (apply) {
+				flavor_x_attr[idx] = attr;
+				flavor_x_char[idx] = ch;
+			}
+			break;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Go through the operations of a cache file, checking them and, if apply is
+ * set, carrying them out.
+ */
+static bool pref_cache_replay(struct pref_reader *r, bool apply)
+{
+	struct prefs_data *files = NULL;
+	size_t depth = 0, alloc = 0;
+	char text[1024];
+	byte op;
+
+	while (!r->bad && (op = pref_get_byte(r)) != PREF_OP_END) {
+		switch (op) {
+			case PREF_OP_OBJECT:
+			case PREF_OP_MONSTER:
+			case PREF_OP_FEAT:
+			case PREF_OP_TRAP:
+			case PREF_OP_GF:
+			case PREF_OP_FLAVOR: {
+				int light = pref_get_byte(r);
+				int idx = pref_get_u16b(r);
+				byte attr = pref_get_byte(r);
+				wchar_t ch = (wchar_t) pref_get_u32b(r);
+
+				if (!pref_replay_glyph(op, light, idx, attr, ch, apply))
+					r->bad = TRUE;
+				break;
+			}
+
+			case PREF_OP_INSCRIBE: {
+				int kidx = pref_get_u16b(r);
+
+				pref_get_str(r, text, sizeof(text));
+				if (kidx >= z_info->k_max)
+					r->bad = TRUE;
+				else if (apply && !r->bad)
+					add_autoinscription(kidx, text);
+				break;
+			}
+
+			case PREF_OP_KEYMAP: {
+				struct keypress actions[KEYMAP_ACTION_MAX + 1];
+				int mode = pref_get_byte(r);
+				bool user = pref_get_byte(r) ? TRUE : FALSE;
+				struct keypress trigger = pref_get_key(r);
+				size_t i, n = pref_get_byte(r);
+
+				memset(actions, 0, sizeof(actions));
+				if (mode >= KEYMAP_MODE_MAX || n > KEYMAP_ACTION_MAX) {
+					r->bad = TRUE;
+					break;
+				}
+				for (i = 0; i < n; i++)
+					actions[i] = pref_get_key(r);
+				if (apply && !r->bad)
+					keymap_add(mode, trigger, actions, user);
+				break;
+			}
+
+			case PREF_OP_MESSAGE: {
+				int type = pref_get_u16b(r);
+				byte attr = pref_get_byte(r);
+
+				if (type >= MSG_MAX)
+					r->bad = TRUE;
+				else if (apply && !r->bad)
+					message_color_define(type, attr);
+				break;
+			}
+
+			case PREF_OP_COLOR: {
+				int i, idx = pref_get_byte(r);
+				byte color[4];
+
+				for (i = 0; i < 4; i++)
+					color[i] = pref_get_byte(r);
+				if (idx >= MAX_COLORS)
+					r->bad = TRUE;
+				else if (apply && !r->bad)
+					memcpy(angband_color_table[idx], color, sizeof(color));
+				break;
+			}
+
+			case PREF_OP_WINDOW: {
+				int window = pref_get_byte(r);
+				size_t flag = pref_get_byte(r);
+				int value = pref_get_byte(r);
+
+				if (!depth || window <= 0 || window >= ANGBAND_TERM_MAX ||
+					flag >= N_ELEMENTS(window_flag_desc))
+					r->bad = TRUE;
+				else if (apply)
+					prefs_set_window_flag(&files[depth - 1], window, flag,
+										  value);
+				break;
+			}
+
+			case PREF_OP_BEGIN: {
+				if (depth == alloc) {
+					alloc = alloc ? alloc * 2 : 4;
+					files = mem_realloc(files, alloc * sizeof(*files));
+				}
+				memset(&files[depth++], 0, sizeof(*files));
+				break;
+			}
+
+			case PREF_OP_FINISH: {
+				if (!depth)
+					r->bad = TRUE;
+				else if (apply)
+					prefs_finish_windows(&files[--depth]);
+				else
+					depth--;
+				break;
+			}
+
+			default:
+				r->bad = TRUE;
+				break;
+		}
+	}
+
+	mem_free(files);
+
+	return !r->bad && !depth;
+}
+
+/**
+ * Carry out a top level load from its cache file, if that is up to date.
+ */
+static bool pref_cache_load(const char *key)
+{
+	char path[1024];
+	struct pref_buf header = { NULL, 0, 0 };
+	struct pref_buf file = { NULL, 0, 0 };
+	struct pref_reader r;
+	size_t start;
+	ang_file *f;
+	bool ok = FALSE;
+
+	pref_cache_path(path, sizeof(path), key);
+	f = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!f) return FALSE;
+
+	/* Read the whole file, normally in one go */
+	while (TRUE) {
+		int n;
+
+		pref_reserve(&file, 65536);
+		n = file_read(f, (char *) file.data + file.len, file.alloc - file.len);
+		if (n <= 0) break;
+		file.len += n;
+	}
+	file_close(f);
+
+	pref_cache_header(&header, key);
+	r.data = file.data;
+	r.len = file.len;
+	r.pos = header.len;
+	r.bad = FALSE;
+
+	/* Check it's still good, and all makes sense, before using it */
+	if (file.len >= header.len && !memcmp(file.data, header.data, header.len)
+		&& pref_cache_check_deps(&r)) {
+		start = r.pos;
+		if (pref_cache_replay(&r, FALSE)) {
+			r.pos = start;
+			ok = pref_cache_replay(&r, TRUE);
+		}
+	}
+
+	mem_free(header.data);
+	mem_free(file.data);
+
+	return ok;
+}
+
+/**
+ * Write the cache file for a top level load.
+ */
+static void pref_cache_save(const char *key, struct pref_record *record)
+{
+	char dir[1024];
+	char path[1024];
+	struct pref_buf b = { NULL, 0, 0 };
+	ang_file *f;
+
+	pref_cache_header(&b, key);
+	pref_put_u16b(&b, record->num_deps);
+	pref_put(&b, record->deps.data, record->deps.len);
+	pref_put(&b, record->ops.data, record->ops.len);
+	pref_put_byte(&b, PREF_OP_END);
+
+	path_build(dir, sizeof(dir), ANGBAND_DIR_USER, "cache");
+	pref_cache_path(path, sizeof(path), key);
+	if (dir_create(dir)) {
+		f = file_open(path, MODE_WRITE, FTYPE_RAW);
+		if (f) {
+			bool ok = file_write(f, (const char *) b.data, b.len);
+
+			file_close(f);
+			if (!ok) file_delete(path);
+		}
+	}
+
+	mem_free(b.data);
+}
+
 /**
  * Look for a pref file at its base location (falling back to another path if
  * needed) and then in the user location. This effectively will layer a user
@@ -1098,7 +1851,7 @@ static bool process_pref_file_layered(const char *name, bool quiet, bool user,
  * default.
  * \returns TRUE if everything worked OK, FALSE otherwise.
  */
-bool process_pref_file(const char *name, bool quiet, bool user)
+static bool process_pref_file_aux(const char *name, bool quiet, bool user)
 {
 	bool root_success = FALSE;
 	bool user_success = FALSE;
@@ -1126,6 +1879,45 @@ bool process_pref_file(const char *name, bool quiet, bool user)
 	return root_success || user_success;
 }
 
+/**
+ * Process a pref file, as above, from the cache if it hasn't changed since it
+ * was last loaded.  Files loaded by other pref files are part of their
+ * loader's cache.
+ *
+ * \param name is the name of the pref file.
+ * \param quiet means "don't complain about not finding the file".
+ * \param user should be TRUE if the pref file is user-specific and not a game
+ * default.
+ * \returns TRUE if everything worked OK, FALSE otherwise.
+ */
+bool process_pref_file(const char *name, bool quiet, bool user)
+{
+	struct pref_record record;
+	char key[1024];
+	bool success;
+
+	if (pref_recording || !use_pref_cache)
+		return process_pref_file_aux(name, quiet, user);
+
+	pref_cache_key(key, sizeof(key), name, user);
+	if (pref_cache_load(key))
+		return TRUE;
+
+	/* Load it the long way, and keep what was done */
+	memset(&record, 0, sizeof(record));
+	pref_recording = &record;
+	success = process_pref_file_aux(name, quiet, user);
+	pref_recording = NULL;
+
+	if (success && !record.failed)
+		pref_cache_save(key, &record);
+
+	mem_free(record.deps.data);
+	mem_free(record.ops.data);
+
+	return success;
+}
+
 /**
  * Reset the "visual" lists
  *
@@ -27,6 +27,7 @@
 extern int use_graphics;
 extern int arg_graphics;
 extern bool arg_graphics_nice;
+extern bool use_pref_cache;
 
 byte *monster_x_attr;
 wchar_t *monster_x_char;
@@ -344,20 +344,20 @@ static errr term_win_init(term_win *s, int w, int h)
 	int y;
 
 	/* Make the window access arrays */
-	s->a = mem_zalloc(h * sizeof(int*));
-	s->c = mem_zalloc(h * sizeof(wchar_t*));
+	s->a = mem_zalloc_tag(h * sizeof(int*), MEM_TAG_UI);
+	s->c = mem_zalloc_tag(h * sizeof(wchar_t*), MEM_TAG_UI);
 
 	/* Make the window content arrays */
-	s->va = mem_zalloc(h * w * sizeof(int));
-	s->vc = mem_zalloc(h * w * sizeof(wchar_t));
+	s->va = mem_zalloc_tag(h * w * sizeof(int), MEM_TAG_UI);
+	s->vc = mem_zalloc_tag(h * w * sizeof(wchar_t), MEM_TAG_UI);
 
 	/* Make the terrain access arrays */
-	s->ta = mem_zalloc(h * sizeof(int*));
-	s->tc = mem_zalloc(h * sizeof(wchar_t*));
+	s->ta = mem_zalloc_tag(h * sizeof(int*), MEM_TAG_UI);
+	s->tc = mem_zalloc_tag(h * sizeof(wchar_t*), MEM_TAG_UI);
 
 	/* Make the terrain content arrays */
-	s->vta = mem_zalloc(h * w * sizeof(int));
-	s->vtc = mem_zalloc(h * w * sizeof(wchar_t));
+	s->vta = mem_zalloc_tag(h * w * sizeof(int), MEM_TAG_UI);
+	s->vtc = mem_zalloc_tag(h * w * sizeof(wchar_t), MEM_TAG_UI);
 
 	/* Prepare the window access arrays */
 	for (y = 0; y < h; y++) {
@@ -653,6 +653,102 @@ void Term_queue_chars(int x, int y, int n, int a, const wchar_t *s)
  * ------------------------------------------------------------------------ */
 
 
+/**
+ * Number of grids compared at a time when looking for changes in a row
+ */
+#define TERM_DIFF_BLOCK 16
+
+/**
+ * Check whether "n" grids starting at (x,y) are the same in the displayed
+ * and requested images; terrain is only compared if "terrain" is set.
+ */
+static bool Term_fresh_same(int x, int y, int n, bool terrain)
+{
+	term_win *old = Term->old;
+	term_win *scr = Term->scr;
+
+	if (memcmp(&old->a[y][x], &scr->a[y][x], n * sizeof(int))) return FALSE;
+	if (memcmp(&old->c[y][x], &scr->c[y][x], n * sizeof(wchar_t)))
+		return FALSE;
+	if (!terrain) return TRUE;
+	if (memcmp(&old->ta[y][x], &scr->ta[y][x], n * sizeof(int))) return FALSE;
+	if (memcmp(&old->tc[y][x], &scr->tc[y][x], n * sizeof(wchar_t)))
+		return FALSE;
+
+	return TRUE;
+}
+
+/**
+ * Narrow the modified columns of a row (see "Term_fresh") to the first
+ * and last grids which really differ from what is displayed.
+ *
+ * Unchanged grids are skipped a block at a time, so rows which were only
+ * touched (or were changed and then changed back) cost a few block
+ * compares rather than a grid-by-grid scan.  If nothing changed, "x1"
+ * ends up past "x2".
+ */
+static void Term_fresh_row_trim(int y, int *x1, int *x2, bool terrain)
+{
+	int n;
+
+	/* Skip unchanged grids on the left */
+	while (*x1 <= *x2) {
+		n = MIN(TERM_DIFF_BLOCK, *x2 - *x1 + 1);
+		if (!Term_fresh_same(*x1, y, n, terrain)) {
+			while (Term_fresh_same(*x1, y, 1, terrain)) (*x1)++;
+			break;
+		}
+		*x1 += n;
+	}
+
+	/* Skip unchanged grids on the right */
+	while (*x1 <= *x2) {
+		n = MIN(TERM_DIFF_BLOCK, *x2 - *x1 + 1);
+		if (!Term_fresh_same(*x2 - n + 1, y, n, terrain)) {
+			while (Term_fresh_same(*x2, y, 1, terrain)) (*x2)--;
+			break;
+		}
+		*x2 -= n;
+	}
+}
+
+/**
+ * Draw some text from the requested image, or wipe it if it is "black"
+ * and the "Term->always_text" flag is not set.
+ *
+ * If the term has a "Term->batch_hook" the run is queued instead, and the
+ * whole frame's worth of runs is sent in one call by "Term_fresh()".
+ */
+static void Term_fresh_span(int x, int y, int n, int a, const wchar_t *s)
+{
+	bool wipe = !a && !Term->always_text;
+	struct term_span *span;
+
+	if (!Term->batch_hook) {
+		if (wipe)
+			(void)((*Term->wipe_hook)(x, y, n));
+		else
+			(void)((*Term->text_hook)(x, y, n, a, s));
+		return;
+	}
+
+	/* Make room */
+	if (Term->span_num == Term->span_max) {
+		Term->span_max = Term->span_max ? 2 * Term->span_max : 4 * Term->hgt;
+		Term->spans = mem_realloc(Term->spans,
+								  Term->span_max * sizeof(*span));
+	}
+
+	/* Queue the run */
+	span = &Term->spans[Term->span_num++];
+	span->x = x;
+	span->y = y;
+	span->n = n;
+	span->a = a;
+	span->s = wipe ? NULL : s;
+}
+
+
 /**
  * Flush a row of the current window (see "Term_fresh")
  *
@@ -770,9 +866,6 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 	int nta;
 	wchar_t ntc;
 
-	/* The "always_text" flag */
-	int always_text = Term->always_text;
-
 	/* Pending length */
 	int fn = 0;
 
@@ -809,10 +902,7 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 			/* Flush */
 			if (fn) {
 				/* Draw pending chars (normal or black) */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
@@ -833,10 +923,7 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 			/* Flush */
 			if (fn) {
 				/* Draw pending chars (normal or black) */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
@@ -857,10 +944,7 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 			/* Flush */
 			if (fn) {
 				/* Draw the pending chars, erase leading spaces */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
@@ -877,10 +961,7 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 	/* Flush */
 	if (fn) {
 		/* Draw pending chars (normal or black) */
-		if (fa || always_text)
-			(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-		else
-			(void)((*Term->wipe_hook)(fx, y, fn));
+		Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 	}
 }
 
@@ -900,9 +981,6 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 	int *scr_aa = Term->scr->a[y];
 	wchar_t *scr_cc = Term->scr->c[y];
 
-	/* The "always_text" flag */
-	int always_text = Term->always_text;
-
 	/* Pending length */
 	int fn = 0;
 
@@ -934,10 +1012,7 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 			/* Flush */
 			if (fn) 	{
 				/* Draw pending chars (normal or black) */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
@@ -956,10 +1031,7 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 			/* Flush */
 			if (fn) {
 				/* Draw the pending chars, erase leading spaces */
-				if (fa || always_text)
-					(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-				else
-					(void)((*Term->wipe_hook)(fx, y, fn));
+				Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 
 				/* Forget */
 				fn = 0;
@@ -976,10 +1048,7 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 	/* Flush */
 	if (fn) {
 		/* Draw pending chars (normal or black) */
-		if (fa || always_text)
-			(void)((*Term->text_hook)(fx, y, fn, fa, &scr_cc[fx]));
-		else
-			(void)((*Term->wipe_hook)(fx, y, fn));
+		Term_fresh_span(fx, y, fn, fa, &scr_cc[fx]);
 	}
 }
 
@@ -1087,6 +1156,19 @@ bool smlcurs = TRUE;
  * high-bit set) to be sent (one pair at a time) to the "Term->pict_hook"
  * hook, which can draw these pairs in whatever way it would like.
  *
+ * Before a row is flushed, its modified columns are narrowed to the first
+ * and last grids which actually differ, comparing a block of grids at a
+ * time, so only the real changes are scanned grid by grid.
+ *
+ * If the "Term->batch_hook" hook is set, the text and wipe stripes are not
+ * sent to "Term->text_hook" and "Term->wipe_hook" one at a time, but are
+ * collected as "term_span" runs and passed to "Term->batch_hook" in one
+ * call after all rows have been scanned (and before the new cursor is
+ * drawn).  Ports for which every drawing call is costly, such as those
+ * talking to a remote display, can then group the work as they see fit.
+ * Note that "TERM_XTRA_FROSH" is then sent before the row is drawn, so
+ * such ports should do their flushing on "TERM_XTRA_FRESH".
+ *
  * Normally, the "Term_wipe()" function is used only to display "blanks"
  * that were induced by "Term_clear()" or "Term_erase()", and then only
  * if the "attr_blank" and "char_blank" fields have not been redefined
@@ -1262,6 +1344,10 @@ errr Term_fresh(void)
 
 			/* Flush each "modified" row */
 			if (x1 <= x2) {
+				/* Ignore grids which are already displayed correctly */
+				Term_fresh_row_trim(y, &x1, &x2,
+									Term->always_pict || Term->higher_pict);
+
 				/* Use "Term_pict()" - always, sometimes or never */
 				if (Term->always_pict)
 					/* Flush the row */
@@ -1285,6 +1371,12 @@ errr Term_fresh(void)
 		/* No rows are invalid */
 		Term->y1 = h;
 		Term->y2 = 0;
+
+		/* Send the queued text and wipes in one go */
+		if (Term->span_num) {
+			(void)((*Term->batch_hook)(Term->spans, Term->span_num));
+			Term->span_num = 0;
+		}
 	}
 
 
@@ -2412,6 +2504,9 @@ errr term_nuke(term *t)
 	mem_free(t->x1);
 	mem_free(t->x2);
 
+	/* Free the queued runs */
+	mem_free(t->spans);
+
 	/* Free the input queue */
 	mem_free(t->key_queue);
 
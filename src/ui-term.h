@@ -57,6 +57,21 @@ struct term_win
 };
 
 
+/**
+ * A run of grids to be drawn by the "Term->batch_hook" hook
+ *
+ * If "s" is set, the "n" chars it points to are drawn in attr "a";
+ * otherwise the grids are wiped.  "s" points into the requested screen
+ * image, so it is only valid during the call to the hook.
+ */
+struct term_span {
+	int x, y;
+	int n;
+	int a;
+	const wchar_t *s;
+};
+
+
 /**
  * An actual "term" structure
  *
@@ -155,6 +170,10 @@ struct term_win
  *	- Hook for drawing a string of chars using an attr
  *
  *	- Hook for drawing a sequence of special attr/char pairs
+ *
+ *	- Hook for drawing a frame's text and blank spaces at once (optional)
+ *
+ *	- Runs queued for the batch hook
  */
 
 typedef struct term term;
@@ -233,6 +252,12 @@ struct term
 
 	void (*view_map_hook)(term *t);
 
+	errr (*batch_hook)(const struct term_span *spans, int n);
+
+	struct term_span *spans;
+	int span_num;
+	int span_max;
+
 };
 
 
@@ -21,6 +21,7 @@
 #include "cmds.h"
 #include "effects.h"
 #include "game-input.h"
+#include "generate.h"
 #include "grafmode.h"
 #include "init.h"
 #include "mon-lore.h"
@@ -239,6 +240,43 @@ static void do_cmd_keylog(void) {
 }
 
 
+/**
+ * Show how much memory each subsystem is using.  Accounting is off until
+ * this is first used, so only blocks allocated since then are counted.
+ */
+static void do_cmd_memory(void)
+{
+	int i;
+	char buf[80];
+
+	if (!(mem_flags & MEM_ACCOUNT)) {
+		mem_flags |= MEM_ACCOUNT;
+		msg("Memory accounting started.");
+		return;
+	}
+
+	screen_save();
+
+	prt("Memory allocated since accounting started:", 0, 0);
+	strnfmt(buf, sizeof(buf), "    %-10s %10s %10s %8s %8s %8s", "tag",
+			"live", "peak", "blocks", "allocs", "frees");
+	prt(buf, 2, 0);
+
+	for (i = 0; i <= MEM_TAG_MAX; i++) {
+		const struct mem_stats *stats = mem_tag_stats(i);
+		strnfmt(buf, sizeof(buf), "    %-10s %10lu %10lu %8lu %8lu %8lu",
+				mem_tag_name(i), (unsigned long) stats->live,
+				(unsigned long) stats->peak, (unsigned long) stats->blocks,
+				(unsigned long) stats->allocs, (unsigned long) stats->frees);
+		prt(buf, i + 3, 0);
+	}
+
+	prt("Press any key to continue.", MEM_TAG_MAX + 5, 0);
+	anykey();
+	screen_load();
+}
+
+
 /**
  * Teleport to the requested target
  */
@@ -1438,6 +1476,36 @@ static void do_cmd_wiz_zap(int d)
 }
 
 
+/**
+ * Start gathering level generation statistics, or write out the ones
+ * gathered so far and stop
+ */
+static void do_cmd_wiz_gen_stats(void)
+{
+	char buf[1024];
+	ang_file *f;
+
+	if (!gen_stats_on) {
+		gen_stats_reset();
+		gen_stats_on = TRUE;
+		msg("Gathering level generation statistics.");
+		return;
+	}
+
+	path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "genstats.log");
+	f = file_open(buf, MODE_WRITE, FTYPE_TEXT);
+	if (!f) {
+		msg("Couldn't open %s.", buf);
+		return;
+	}
+
+	gen_stats_dump(f);
+	file_close(f);
+	gen_stats_on = FALSE;
+	msg("Level generation statistics written to %s.", buf);
+}
+
+
 /**
  * Query square flags - needs alteration if list-square-flags.h changes
  */
@@ -1950,6 +2018,13 @@ void get_debug_command(void)
 			break;
 		}
 
+		/* Memory use */
+		case 'M':
+		{
+			do_cmd_memory();
+			break;
+		}
+
 		/* Magic Mapping */
 		case 'm':
 		{
@@ -2016,6 +2091,13 @@ void get_debug_command(void)
 			break;
 		}
 		
+		/* Level generation statistics */
+		case 'R':
+		{
+			do_cmd_wiz_gen_stats();
+			break;
+		}
+
 		/* Query the dungeon */
 		case 'q':
 		{
@@ -666,6 +666,567 @@ static void spoil_mon_info(const char *fname)
 	msg("Successfully created a spoiler file.");
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Machine-readable spoilers
+ *
+ * Kinds, artifacts, egos and monster races are written as records in a
+ * single pass.  Each record goes to every requested format at once: a plain
+ * text listing, one CSV file per record type, and a JSON Lines file.
+ *
+ * Artifact records carry the properties from the artifact spoiler and monster
+ * records the full description from the monster info spoiler.  Kind and ego
+ * records hold summary fields only.  The .spo text spoilers are still written
+ * by the functions above.
+ * ------------------------------------------------------------------------ */
+
+#define SPOIL_BUF_LEN	8192
+
+/**
+ * A field of a spoiler record; numbers are left unquoted in JSON
+ */
+struct spoil_field {
+	const char *name;
+	bool number;
+};
+
+/**
+ * A record type, with the fields every record of that type has
+ */
+struct spoil_section {
+	const char *type;
+	const struct spoil_field *fields;
+	int count;
+	void (*write)(const struct spoil_section *sec);
+};
+
+/**
+ * A buffered output file in one of the spoiler formats
+ */
+struct spoil_sink {
+	int format;
+	ang_file *f;
+	char buf[SPOIL_BUF_LEN];
+	size_t len;
+	bool ok;
+};
+
+static const struct spoil_field kind_fields[] = {
+	{ "index", TRUE },
+	{ "tval", FALSE },
+	{ "name", FALSE },
+	{ "level", TRUE },
+	{ "cost", TRUE },
+	{ "weight", FALSE },
+	{ "damage_ac", FALSE },
+};
+
+static const struct spoil_field artifact_fields[] = {
+	{ "index", TRUE },
+	{ "tval", FALSE },
+	{ "name", FALSE },
+	{ "alloc_prob", TRUE },
+	{ "alloc_min", TRUE },
+	{ "alloc_max", TRUE },
+	{ "weight", TRUE },
+	{ "cost", TRUE },
+	{ "power", TRUE },
+	{ "properties", FALSE },
+};
+
+static const struct spoil_field ego_fields[] = {
+	{ "index", TRUE },
+	{ "name", FALSE },
+	{ "level", TRUE },
+	{ "rarity", TRUE },
+	{ "rating", TRUE },
+	{ "alloc_prob", TRUE },
+	{ "alloc_min", TRUE },
+	{ "alloc_max", TRUE },
+	{ "cost", TRUE },
+};
+
+static const struct spoil_field monster_fields[] = {
+	{ "index", TRUE },
+	{ "name", FALSE },
+	{ "base", FALSE },
+	{ "level", TRUE },
+	{ "rarity", TRUE },
+	{ "speed", TRUE },
+	{ "hp", TRUE },
+	{ "ac", TRUE },
+	{ "exp", TRUE },
+	{ "colour", FALSE },
+	{ "symbol", FALSE },
+	{ "unique", TRUE },
+	{ "questor", TRUE },
+	{ "description", FALSE },
+};
+
+/**
+ * The open sinks, and the base name for their files
+ */
+static struct spoil_sink *spoil_sinks[3];
+static int spoil_sink_count;
+static const char *spoil_base;
+
+static void spoil_sink_flush(struct spoil_sink *sink)
+{
+	if (sink->len && sink->ok)
+		sink->ok = file_write(sink->f, sink->buf, sink->len);
+	sink->len = 0;
+}
+
+static void spoil_sink_put(struct spoil_sink *sink, const char *str,
+						   size_t n)
+{
+	/* Write big strings straight through */
+	if (n >= SPOIL_BUF_LEN) {
+		spoil_sink_flush(sink);
+		if (sink->ok)
+			sink->ok = file_write(sink->f, str, n);
+		return;
+	}
+
+	if (sink->len + n > SPOIL_BUF_LEN)
+		spoil_sink_flush(sink);
+	memcpy(sink->buf + sink->len, str, n);
+	sink->len += n;
+}
+
+static void spoil_sink_puts(struct spoil_sink *sink, const char *str)
+{
+	spoil_sink_put(sink, str, strlen(str));
+}
+
+static bool spoil_sink_open(struct spoil_sink *sink, const char *fname)
+{
+	char buf[1024];
+
+	path_build(buf, sizeof(buf), ANGBAND_DIR_USER, fname);
+	sink->f = file_open(buf, MODE_WRITE, FTYPE_TEXT);
+	sink->len = 0;
+	sink->ok = sink->f ? TRUE : FALSE;
+
+	return sink->ok;
+}
+
+static bool spoil_sink_close(struct spoil_sink *sink)
+{
+	if (!sink->f) return sink->ok;
+
+	spoil_sink_flush(sink);
+	if (!file_close(sink->f))
+		sink->ok = FALSE;
+	sink->f = NULL;
+
+	return sink->ok;
+}
+
+/**
+ * Write a CSV value, quoted if it needs to be
+ */
+static void spoil_put_csv(struct spoil_sink *sink, const char *str)
+{
+	const char *s;
+
+	if (!strpbrk(str, ",\"\r\n")) {
+		spoil_sink_puts(sink, str);
+		return;
+	}
+
+	spoil_sink_put(sink, "\"", 1);
+	for (s = str; *s; s++) {
+		if (*s == '"')
+			spoil_sink_put(sink, "\"\"", 2);
+		else
+			spoil_sink_put(sink, s, 1);
+	}
+	spoil_sink_put(sink, "\"", 1);
+}
+
+/**
+ * Write a JSON string; UTF-8 passes through unchanged
+ */
+static void spoil_put_json(struct spoil_sink *sink, const char *str)
+{
+	const char *s;
+
+	spoil_sink_put(sink, "\"", 1);
+	for (s = str; *s; s++) {
+		if (*s == '"' || *s == '\\') {
+			spoil_sink_put(sink, "\\", 1);
+			spoil_sink_put(sink, s, 1);
+		} else if ((byte)*s < 0x20) {
+			char esc[8];
+			strnfmt(esc, sizeof(esc), "\\u%04x", (byte)*s);
+			spoil_sink_puts(sink, esc);
+		} else {
+			spoil_sink_put(sink, s, 1);
+		}
+	}
+	spoil_sink_put(sink, "\"", 1);
+}
+
+/**
+ * Start a record type; CSV gets a file of its own with a header row
+ */
+static void spoil_section_begin(const struct spoil_section *sec)
+{
+	int i, j;
+
+	for (i = 0; i < spoil_sink_count; i++) {
+		struct spoil_sink *sink = spoil_sinks[i];
+
+		if (sink->format == SPOIL_TEXT) {
+			char title[80];
+			strnfmt(title, sizeof(title), "%ss", sec->type);
+			spoil_sink_puts(sink, "\n");
+			spoil_sink_puts(sink, title);
+			spoil_sink_puts(sink, "\n");
+			for (j = strlen(title); j > 0; j--)
+				spoil_sink_put(sink, "=", 1);
+			spoil_sink_puts(sink, "\n\n");
+		} else if (sink->format == SPOIL_CSV) {
+			char fname[256];
+			strnfmt(fname, sizeof(fname), "%s-%ss.csv", spoil_base,
+					sec->type);
+			if (!spoil_sink_open(sink, fname)) continue;
+			for (j = 0; j < sec->count; j++) {
+				if (j) spoil_sink_put(sink, ",", 1);
+				spoil_sink_puts(sink, sec->fields[j].name);
+			}
+			spoil_sink_put(sink, "\n", 1);
+		}
+	}
+}
+
+static void spoil_section_end(void)
+{
+	int i;
+
+	for (i = 0; i < spoil_sink_count; i++)
+		if (spoil_sinks[i]->format == SPOIL_CSV)
+			spoil_sink_close(spoil_sinks[i]);
+}
+
+/**
+ * Write one record, given its values as strings, to every sink
+ */
+static void spoil_record(const struct spoil_section *sec, const char **values)
+{
+	int i, j;
+
+	for (i = 0; i < spoil_sink_count; i++) {
+		struct spoil_sink *sink = spoil_sinks[i];
+
+		if (!sink->f) continue;
+
+		if (sink->format == SPOIL_TEXT) {
+			spoil_sink_puts(sink, sec->type);
+			spoil_sink_put(sink, " ", 1);
+			spoil_sink_puts(sink, values[0]);
+			spoil_sink_put(sink, "\n", 1);
+			for (j = 1; j < sec->count; j++) {
+				spoil_sink_puts(sink, "  ");
+				spoil_sink_puts(sink, sec->fields[j].name);
+				spoil_sink_puts(sink, ": ");
+				spoil_sink_puts(sink, values[j]);
+				spoil_sink_put(sink, "\n", 1);
+			}
+			spoil_sink_put(sink, "\n", 1);
+		} else if (sink->format == SPOIL_CSV) {
+			for (j = 0; j < sec->count; j++) {
+				if (j) spoil_sink_put(sink, ",", 1);
+				spoil_put_csv(sink, values[j]);
+			}
+			spoil_sink_put(sink, "\n", 1);
+		} else {
+			spoil_sink_puts(sink, "{\"type\":");
+			spoil_put_json(sink, sec->type);
+			for (j = 0; j < sec->count; j++) {
+				spoil_sink_put(sink, ",", 1);
+				spoil_put_json(sink, sec->fields[j].name);
+				spoil_sink_put(sink, ":", 1);
+				if (sec->fields[j].number)
+					spoil_sink_puts(sink, values[j]);
+				else
+					spoil_put_json(sink, values[j]);
+			}
+			spoil_sink_puts(sink, "}\n");
+		}
+	}
+}
+
+/**
+ * Value buffers for building a record
+ */
+#define SPOIL_MAX_FIELDS	16
+static char spoil_vals[SPOIL_MAX_FIELDS][1024];
+static const char *spoil_valp[SPOIL_MAX_FIELDS];
+
+/**
+ * Buffer for the one long, descriptive field a record may have
+ */
+static char spoil_long[SPOIL_BUF_LEN];
+
+static void spoil_set(int field, const char *fmt, ...)
+{
+	va_list vp;
+
+	va_start(vp, fmt);
+	vstrnfmt(spoil_vals[field], sizeof(spoil_vals[field]), fmt, vp);
+	va_end(vp);
+	spoil_valp[field] = spoil_vals[field];
+}
+
+/**
+ * Set a field to the text of a textblock, as UTF-8 without the trailing
+ * line breaks
+ */
+static void spoil_set_text(int field, textblock *tb)
+{
+	const wchar_t *text = textblock_text(tb);
+	size_t len = 0;
+
+	for (; *text; text++) {
+		char mb[MB_LEN_MAX];
+		int n = wctomb(mb, *text);
+
+		if (n <= 0) continue;
+		if (len + n >= sizeof(spoil_long)) break;
+		memcpy(spoil_long + len, mb, n);
+		len += n;
+	}
+	while (len && (spoil_long[len - 1] == '\n' || spoil_long[len - 1] == ' '))
+		len--;
+	spoil_long[len] = '\0';
+
+	spoil_valp[field] = spoil_long;
+}
+
+static void spoil_data_kinds(const struct spoil_section *sec)
+{
+	int k;
+
+	for (k = 1; k < z_info->k_max; k++) {
+		struct object_kind *kind = &k_info[k];
+		int lev;
+		s32b val;
+
+		if (!kind->name || !kind->tval) continue;
+
+		/* Hack -- Skip instant-artifacts */
+		if (kf_has(kind->kind_flags, KF_INSTA_ART)) continue;
+
+		kind_info(spoil_vals[2], sizeof(spoil_vals[2]), spoil_vals[6],
+				  sizeof(spoil_vals[6]), spoil_vals[5],
+				  sizeof(spoil_vals[5]), &lev, &val, k);
+		spoil_set(0, "%d", k);
+		spoil_set(1, "%s", tval_find_name(kind->tval));
+		spoil_valp[2] = spoil_vals[2];
+		spoil_set(3, "%d", lev);
+		spoil_set(4, "%ld", (long)val);
+		spoil_valp[5] = spoil_vals[5] + strspn(spoil_vals[5], " ");
+		spoil_valp[6] = spoil_vals[6];
+
+		spoil_record(sec, spoil_valp);
+	}
+}
+
+static void spoil_data_artifacts(const struct spoil_section *sec)
+{
+	int j;
+
+	for (j = 1; j < z_info->a_max; j++) {
+		struct artifact *art = &a_info[j];
+		struct object *obj;
+		textblock *tb;
+		char *temp;
+
+		if (!art->name || !art->tval) continue;
+
+		/* Attempt to "forge" the artifact */
+		obj = object_new();
+		if (!make_fake_artifact(obj, art)) {
+			object_delete(obj);
+			continue;
+		}
+		object_know_all_but_flavor(obj);
+
+		spoil_set(0, "%d", j);
+		spoil_set(1, "%s", tval_find_name(art->tval));
+		object_desc(spoil_vals[2], sizeof(spoil_vals[2]), obj, ODESC_PREFIX |
+					ODESC_COMBAT | ODESC_EXTRA | ODESC_SPOIL);
+		spoil_valp[2] = spoil_vals[2];
+		spoil_set(3, "%d", art->alloc_prob);
+		spoil_set(4, "%d", art->alloc_min);
+		spoil_set(5, "%d", art->alloc_max);
+		spoil_set(6, "%d", art->weight);
+		spoil_set(7, "%d", art->cost);
+		spoil_set(8, "%d", object_power(obj, FALSE, NULL, TRUE));
+
+		/* The same properties as the text spoiler, without the flavour */
+		temp = art->text;
+		art->text = NULL;
+		tb = object_info_spoil_text(obj);
+		art->text = temp;
+		if (OPT(birth_randarts) && art->text)
+			textblock_append(tb, "%s.\n", art->text);
+		spoil_set_text(9, tb);
+		textblock_free(tb);
+
+		spoil_record(sec, spoil_valp);
+		object_delete(obj);
+	}
+}
+
+static void spoil_data_egos(const struct spoil_section *sec)
+{
+	int i;
+
+	for (i = 1; i < z_info->e_max; i++) {
+		struct ego_item *ego = &e_info[i];
+
+		if (!ego->name) continue;
+
+		spoil_set(0, "%d", i);
+		spoil_set(1, "%s", ego->name);
+		spoil_set(2, "%d", ego->level);
+		spoil_set(3, "%d", ego->rarity);
+		spoil_set(4, "%d", ego->rating);
+		spoil_set(5, "%d", ego->alloc_prob);
+		spoil_set(6, "%d", ego->alloc_min);
+		spoil_set(7, "%d", ego->alloc_max);
+		spoil_set(8, "%d", ego->cost);
+
+		spoil_record(sec, spoil_valp);
+	}
+}
+
+static void spoil_data_monsters(const struct spoil_section *sec)
+{
+	int i;
+
+	for (i = 1; i < z_info->r_max; i++) {
+		struct monster_race *race = &r_info[i];
+		char symbol[MB_LEN_MAX + 1] = { 0 };
+		textblock *tb;
+
+		if (!race->name) continue;
+
+		wctomb(symbol, race->d_char);
+
+		spoil_set(0, "%d", i);
+		spoil_set(1, "%s", race->name);
+		spoil_set(2, "%s", race->base ? race->base->name : "");
+		spoil_set(3, "%d", race->level);
+		spoil_set(4, "%d", race->rarity);
+		spoil_set(5, "%d", race->speed - 110);
+		spoil_set(6, "%d", race->avg_hp);
+		spoil_set(7, "%d", race->ac);
+		spoil_set(8, "%ld", (long)race->mexp);
+		spoil_set(9, "%s", attr_to_text(race->d_attr));
+		spoil_set(10, "%s", symbol);
+		spoil_set(11, "%d", rf_has(race->flags, RF_UNIQUE) ? 1 : 0);
+		spoil_set(12, "%d", rf_has(race->flags, RF_QUESTOR) ? 1 : 0);
+
+		/* The full description from the text monster spoiler */
+		tb = textblock_new();
+		lore_description(tb, race, &l_list[i], TRUE);
+		spoil_set_text(13, tb);
+		textblock_free(tb);
+
+		spoil_record(sec, spoil_valp);
+	}
+}
+
+static const struct spoil_section spoil_sections[] = {
+	{ "kind", kind_fields, N_ELEMENTS(kind_fields), spoil_data_kinds },
+	{ "artifact", artifact_fields, N_ELEMENTS(artifact_fields),
+	  spoil_data_artifacts },
+	{ "ego", ego_fields, N_ELEMENTS(ego_fields), spoil_data_egos },
+	{ "monster", monster_fields, N_ELEMENTS(monster_fields),
+	  spoil_data_monsters },
+};
+
+/**
+ * Write machine-readable spoilers for all kinds, artifacts, egos and monster
+ * races to files in the user directory named after `name`, in each of the
+ * given SPOIL_* formats.  Returns FALSE if any file couldn't be written.
+ */
+bool spoil_data(const char *name, int formats)
+{
+	static struct spoil_sink text, csv, json;
+	char fname[256];
+	bool ok = TRUE;
+	int i;
+
+	spoil_base = name;
+	spoil_sink_count = 0;
+
+	if (formats & SPOIL_TEXT) {
+		text.format = SPOIL_TEXT;
+		strnfmt(fname, sizeof(fname), "%s.txt", name);
+		if (spoil_sink_open(&text, fname)) {
+			spoil_sinks[spoil_sink_count++] = &text;
+			spoil_sink_puts(&text, format("Data Spoilers for %s\n", buildid));
+		} else {
+			ok = FALSE;
+		}
+	}
+
+	if (formats & SPOIL_CSV) {
+		csv.format = SPOIL_CSV;
+		csv.f = NULL;
+		csv.ok = TRUE;
+		spoil_sinks[spoil_sink_count++] = &csv;
+	}
+
+	if (formats & SPOIL_JSON) {
+		json.format = SPOIL_JSON;
+		strnfmt(fname, sizeof(fname), "%s.jsonl", name);
+		if (spoil_sink_open(&json, fname))
+			spoil_sinks[spoil_sink_count++] = &json;
+		else
+			ok = FALSE;
+	}
+
+	/* Stream each record type through the sinks */
+	for (i = 0; i < (int)N_ELEMENTS(spoil_sections); i++) {
+		const struct spoil_section *sec = &spoil_sections[i];
+
+		assert(sec->count <= SPOIL_MAX_FIELDS);
+		spoil_section_begin(sec);
+		sec->write(sec);
+		spoil_section_end();
+		if ((formats & SPOIL_CSV) && !csv.ok) ok = FALSE;
+	}
+
+	for (i = 0; i < spoil_sink_count; i++)
+		if (!spoil_sink_close(spoil_sinks[i]))
+			ok = FALSE;
+	spoil_sink_count = 0;
+
+	if (ok)
+		msg("Successfully created spoiler files.");
+	else
+		msg("Cannot create spoiler files.");
+
+	return ok;
+}
+
+/**
+ * Write all the text spoiler files
+ */
+void spoil_text(void)
+{
+	spoil_obj_desc("obj-desc.spo");
+	spoil_artifact("artifact.spo");
+	spoil_mon_desc("mon-desc.spo");
+	spoil_mon_info("mon-info.spo");
+}
+
 static void spoiler_menu_act(const char *title, int row)
 {
 	if (row == 0)
@@ -676,6 +1237,8 @@ static void spoiler_menu_act(const char *title, int row)
 		spoil_mon_desc("mon-desc.spo");
 	else if (row == 3)
 		spoil_mon_info("mon-info.spo");
+	else if (row == 4)
+		spoil_data("spoilers", SPOIL_TEXT | SPOIL_CSV | SPOIL_JSON);
 
 	event_signal(EVENT_MESSAGE_FLUSH);
 }
@@ -687,6 +1250,7 @@ static menu_action spoil_actions[] =
 	{ 0, 0, "Brief Artifact Info (artifact.spo)",	spoiler_menu_act },
 	{ 0, 0, "Brief Monster Info (mon-desc.spo)",	spoiler_menu_act },
 	{ 0, 0, "Full Monster Info (mon-info.spo)",		spoiler_menu_act },
+	{ 0, 0, "Data Export (spoilers.txt/csv/jsonl)",	spoiler_menu_act },
 };
 
 
@@ -1692,84 +1692,12 @@ void stats_collect(void)
 	}
 }
 
-#define DIST_MAX 10000
-
-void calc_cave_distances(int **cave_dist)
+/**
+ * Grids the player could walk through, for the disconnection statistics
+ */
+static bool square_isopen_fully(struct chunk *c, int y, int x)
 {
-	int dist, i;
-	int oy, ox, ty, tx, d;
-
-	/* Squares with distance from player of n - 1 */
-	int d_x_old[DIST_MAX];
-	int d_y_old[DIST_MAX];
-	int d_old_max;
-
-	/* Squares with distance from player of n */
-	int d_x_new[DIST_MAX];
-	int d_y_new[DIST_MAX];
-	int d_new_max;
-
-	/* Get player location */
-	oy = d_y_old[0] = player->py;
-	ox = d_x_old[0] = player->px;
-	d_old_max = 1;
-
-	/* Distance from player starts at 0 */
-	dist = 0;
-
-	/* Assign the distance value to the first square (player) */
-	cave_dist[oy][ox] = dist;
-
-	do {
-		d_new_max = 0;
-		dist++;
-
-		/* Loop over all visited squares of the previous iteration */
-		for (i = 0; i < d_old_max; i++){
-
-			/* Get the square we want to look at */
-			oy = d_y_old[i];
-			ox = d_x_old[i];
-
-			/* debug
-			msg("x: %d y: %d dist: %d %d ",ox,oy,dist-1,i); */
-
-			/* Get all adjacent squares */
-			for (d = 0; d < 8; d++) {
-				/* Adjacent square location */
-				ty = oy + ddy_ddd[d];
-				tx = ox + ddx_ddd[d];
-
-				if (!(square_in_bounds_fully(cave, ty, tx))) continue;
-
-				/* Have we been here before? */
-				if (cave_dist[ty][tx] >= 0) continue;
-
-				/* Is it a wall? */
-				if (square_iswall(cave, ty, tx)) continue;
-
-				/* Add the new location */
-				d_y_new[d_new_max] = ty;
-				d_x_new[d_new_max] = tx;
-
-				/* Assign the distance to that spot */
-				cave_dist[ty][tx] = dist;
-
-				d_new_max++;
-
-				/* debug
-				msg("x: %d y: %d dist: %d ",tx,ty,dist); */
-			}
-		}
-
-		/* Copy the new distance list to the old one */
-		for (i = 0; i < d_new_max; i++) {
-			d_y_old[i] = d_y_new[i];
-			d_x_old[i] = d_x_new[i];
-		}
-		d_old_max = d_new_max;
-
-	} while ((d_old_max > 0) || dist == DIST_MAX);
+	return square_in_bounds_fully(c, y, x) && !square_iswall(c, y, x);
 }
 
 void pit_stats(void)
@@ -1857,7 +1785,8 @@ void disconnect_stats(void)
 {
 	int i, y, x;
 
-	int **cave_dist;
+	struct cave_regions *regions;
+	int home;
 
 	bool has_dsc, has_dsc_from_stairs;
 
@@ -1896,18 +1825,9 @@ void disconnect_stats(void)
 		/* Make a new cave */
 		cave_generate(&cave, player);
 
-		/* Allocate the distance array */
-		cave_dist = mem_zalloc(cave->height * sizeof(int*));
-		for (y = 0; y < cave->height; y++)
-			cave_dist[y] = mem_zalloc(cave->width * sizeof(int));
-
-		/* Set all cave spots to inaccessible */
-		for (y = 0; y < cave->height; y++)
-			for (x = 1; x < cave->width; x++)
-				cave_dist[y][x] = -1;
-
-		/* Fill the distance array with the correct distances */
-		calc_cave_distances(cave_dist);
+		/* Label the areas the player could walk between */
+		regions = cave_regions_new(cave, square_isopen_fully, TRUE);
+		home = cave_region_at(regions, player->py, player->px);
 
 		/* Cycle through the dungeon */
 		for (y = 1; y < cave->height - 1; y++) {
@@ -1917,16 +1837,11 @@ void disconnect_stats(void)
 				if (square_iswall(cave, y, x)) continue;
 
 				/* Can we get there? */
-				if (cave_dist[y][x] >= 0) {
+				if (cave_region_at(regions, y, x) == home) {
 
 					/* Is it a  down stairs? */
-					if (square_isdownstairs(cave, y, x)) {
-
+					if (square_isdownstairs(cave, y, x))
 						has_dsc_from_stairs = FALSE;
-
-						/* debug
-						msg("dist to stairs: %d",cave_dist[y][x]); */
-					}
 					continue;
 				}
 
@@ -1944,10 +1859,7 @@ void disconnect_stats(void)
 
 		msg("Iteration: %d",i); 
 
-		/* Free arrays */
-		for (y = 0; x < cave->height; x++)
-			mem_free(cave_dist[y]);
-		mem_free(cave_dist);
+		cave_regions_free(regions);
 	}
 
 	msg("Total levels with disconnected areas: %ld",dsc_area);
@@ -29,6 +29,18 @@ void disconnect_stats(void);
 void pit_stats(void);
 
 /* wiz-spoil.c */
+
+/**
+ * Formats for spoil_data()
+ */
+enum {
+	SPOIL_TEXT = 0x01,
+	SPOIL_CSV = 0x02,
+	SPOIL_JSON = 0x04
+};
+
 void do_cmd_spoilers(void);
+bool spoil_data(const char *name, int formats);
+void spoil_text(void);
 
 #endif /* !INCLUDED_WIZARD_H */
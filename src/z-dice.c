@@ -31,6 +31,12 @@ struct dice_s {
 	int b, x, y, m;
 	bool ex_b, ex_x, ex_y, ex_m;
 	dice_expression_entry_t *expressions;
+
+	/* Compiled form: the constant parts, and the expression to evaluate for
+	 * each variable part (NULL for constant or unbound parts) */
+	random_value value;
+	const expression_t *parts[4];
+	bool constant;
 };
 
 /**
@@ -172,6 +178,10 @@ static void dice_reset(dice_t *dice)
 	dice->ex_y = FALSE;
 	dice->ex_m = FALSE;
 
+	memset(&dice->value, 0, sizeof(dice->value));
+	memset(dice->parts, 0, sizeof(dice->parts));
+	dice->constant = TRUE;
+
 	if (dice->expressions == NULL)
 		return;
 
@@ -188,6 +198,42 @@ static void dice_reset(dice_t *dice)
 	}
 }
 
+/**
+ * Get the expression bound to a variable part of the dice, or NULL if the
+ * part is constant or its variable is unbound.
+ */
+static const expression_t *dice_part_expression(dice_t *dice, bool variable,
+												int index)
+{
+	if (!variable || dice->expressions == NULL)
+		return NULL;
+
+	return dice->expressions[index].expression;
+}
+
+/**
+ * Work out the compiled form of the dice, after parsing or binding, so that
+ * getting the values only has to evaluate the bound expressions.
+ */
+static void dice_compile(dice_t *dice)
+{
+	int i;
+
+	dice->value.base = dice->ex_b ? 0 : dice->b;
+	dice->value.dice = dice->ex_x ? 0 : dice->x;
+	dice->value.sides = dice->ex_y ? 0 : dice->y;
+	dice->value.m_bonus = dice->ex_m ? 0 : dice->m;
+
+	dice->parts[0] = dice_part_expression(dice, dice->ex_b, dice->b);
+	dice->parts[1] = dice_part_expression(dice, dice->ex_x, dice->x);
+	dice->parts[2] = dice_part_expression(dice, dice->ex_y, dice->y);
+	dice->parts[3] = dice_part_expression(dice, dice->ex_m, dice->m);
+
+	dice->constant = TRUE;
+	for (i = 0; i < 4; i++)
+		if (dice->parts[i]) dice->constant = FALSE;
+}
+
 /**
  * Allocate and initialize a new dice object. Returns NULL if it was unable to
  * be created.
@@ -283,6 +329,7 @@ int dice_bind_expression(dice_t *dice, const char *name,
 			if (dice->expressions[i].expression == NULL)
 				return -1;
 
+			dice_compile(dice);
 			return i;
 		}
 	}
@@ -494,6 +541,7 @@ bool dice_parse_string(dice_t *dice, const char *string)
 		}
 	}
 
+	dice_compile(dice);
 	return TRUE;
 }
 
@@ -508,41 +556,18 @@ void dice_random_value(dice_t *dice, random_value *v)
 	if (v == NULL)
 		return;
 
-	if (dice->ex_b) {
-		if (dice->expressions != NULL && dice->expressions[dice->b].expression != NULL)
-			v->base = expression_evaluate(dice->expressions[dice->b].expression);
-		else
-			v->base = 0;
-	}
-	else
-		v->base = dice->b;
-
-	if (dice->ex_x) {
-		if (dice->expressions != NULL && dice->expressions[dice->x].expression != NULL)
-			v->dice = expression_evaluate(dice->expressions[dice->x].expression);
-		else
-			v->dice = 0;
-	}
-	else
-		v->dice = dice->x;
-
-	if (dice->ex_y) {
-		if (dice->expressions != NULL && dice->expressions[dice->y].expression != NULL)
-			v->sides = expression_evaluate(dice->expressions[dice->y].expression);
-		else
-			v->sides = 0;
-	}
-	else
-		v->sides = dice->y;
+	*v = dice->value;
+	if (dice->constant)
+		return;
 
-	if (dice->ex_m) {
-		if (dice->expressions != NULL && dice->expressions[dice->m].expression != NULL)
-			v->m_bonus = expression_evaluate(dice->expressions[dice->m].expression);
-		else
-			v->m_bonus = 0;
-	}
-	else
-		v->m_bonus = dice->m;
+	if (dice->parts[0])
+		v->base = expression_evaluate(dice->parts[0]);
+	if (dice->parts[1])
+		v->dice = expression_evaluate(dice->parts[1]);
+	if (dice->parts[2])
+		v->sides = expression_evaluate(dice->parts[2]);
+	if (dice->parts[3])
+		v->m_bonus = expression_evaluate(dice->parts[3]);
 }
 
 /**
@@ -591,6 +616,25 @@ int dice_roll(dice_t *dice, random_value *v)
 	return rv.base + damroll(rv.dice, rv.sides);
 }
 
+/**
+ * Roll the dice a number of times, as dice_roll() would, evaluating any
+ * bound expressions only once.
+ *
+ * \param dice is the dice object to roll.
+ * \param rolls is filled with the results.
+ * \param n is the number of rolls to make.
+ */
+void dice_roll_batch(dice_t *dice, int *rolls, int n)
+{
+	random_value rv;
+	int i;
+
+	dice_random_value(dice, &rv);
+
+	for (i = 0; i < n; i++)
+		rolls[i] = rv.base + damroll(rv.dice, rv.sides);
+}
+
 /**
  * Test the dice object against the given values.
  */
@@ -34,6 +34,7 @@ int dice_bind_expression(dice_t *dice, const char *name,
 void dice_random_value(dice_t *dice, random_value *v);
 int dice_evaluate(dice_t *dice, int level, aspect aspect, random_value *v);
 int dice_roll(dice_t *dice, random_value *v);
+void dice_roll_batch(dice_t *dice, int *rolls, int n);
 bool dice_test_values(dice_t *dice, int base, int dice_count, int sides,
 					  int bonus);
 bool dice_test_variables(dice_t *dice, const char *base, const char *dice_name,
@@ -25,11 +25,26 @@ struct expression_operation_s {
 	s16b operand;
 };
 
+/**
+ * A compiled operation: the value is added to, multiplied or divided by the
+ * operand.
+ */
+typedef struct expression_step_s {
+	byte operator;
+	s32b operand;
+} expression_step_t;
+
 struct expression_s {
 	expression_base_value_f base_value;
 	size_t operation_count;
 	size_t operations_size;
 	expression_operation_t *operations;
+
+	/* The operations compiled down to as few steps as possible, or to a
+	 * constant if there is no base value */
+	size_t step_count;
+	expression_step_t *steps;
+	s32b constant;
 };
 
 /**
@@ -123,6 +138,112 @@ static expression_input_t expression_input_for_operator(expression_operator_t op
 	return EXPRESSION_INPUT_INVALID;
 }
 
+/**
+ * Apply the compiled steps of an expression to a value.
+ */
+static s32b expression_apply(const expression_t *expression, s32b start)
+{
+	size_t i;
+	u32b value = (u32b) start;
+
+	for (i = 0; i < expression->step_count; i++) {
+		const expression_step_t *step = &expression->steps[i];
+
+		switch (step->operator) {
+			case OPERATOR_ADD:
+				value += (u32b) step->operand;
+				break;
+			case OPERATOR_MUL:
+				value *= (u32b) step->operand;
+				break;
+			case OPERATOR_DIV:
+				value = (u32b) ((s32b) value / step->operand);
+				break;
+			default:
+				break;
+		}
+	}
+
+	return (s32b) value;
+}
+
+/**
+ * Compile the operations of an expression.  Negation is multiplication by
+ * -1, subtraction is addition of the negative, and runs of additions or of
+ * multiplications become a single step; these give the same results as
+ * applying the operations one by one, overflow included.  Division isn't
+ * combined with anything, as it rounds.  With no base value the whole
+ * expression is worked out here.
+ */
+static void expression_compile(expression_t *expression)
+{
+	size_t i, n = 0;
+
+	mem_free(expression->steps);
+	expression->steps = NULL;
+	expression->step_count = 0;
+
+	if (expression->operation_count)
+		expression->steps = mem_zalloc(expression->operation_count *
+									   sizeof(expression_step_t));
+
+	for (i = 0; i < expression->operation_count; i++) {
+		expression_operation_t *op = &expression->operations[i];
+		expression_step_t step;
+
+		switch (op->operator) {
+			case OPERATOR_ADD:
+				step.operator = OPERATOR_ADD;
+				step.operand = op->operand;
+				break;
+			case OPERATOR_SUB:
+				step.operator = OPERATOR_ADD;
+				step.operand = -op->operand;
+				break;
+			case OPERATOR_MUL:
+				step.operator = OPERATOR_MUL;
+				step.operand = op->operand;
+				break;
+			case OPERATOR_DIV:
+				step.operator = OPERATOR_DIV;
+				step.operand = op->operand;
+				break;
+			case OPERATOR_NEG:
+				step.operator = OPERATOR_MUL;
+				step.operand = -1;
+				break;
+			default:
+				continue;
+		}
+
+		/* Combine with the step before if we can */
+		if (n && step.operator != OPERATOR_DIV &&
+			expression->steps[n - 1].operator == step.operator) {
+			expression_step_t *last = &expression->steps[n - 1];
+			if (step.operator == OPERATOR_ADD)
+				last->operand = (s32b) ((u32b) last->operand +
+										(u32b) step.operand);
+			else
+				last->operand = (s32b) ((u32b) last->operand *
+										(u32b) step.operand);
+		} else {
+			expression->steps[n++] = step;
+		}
+
+		/* Drop steps that do nothing */
+		if ((expression->steps[n - 1].operator == OPERATOR_ADD &&
+			 expression->steps[n - 1].operand == 0) ||
+			(expression->steps[n - 1].operator == OPERATOR_MUL &&
+			 expression->steps[n - 1].operand == 1))
+			n--;
+	}
+	expression->step_count = n;
+
+	/* Fold a constant expression */
+	if (expression->base_value == NULL)
+		expression->constant = expression_apply(expression, 0);
+}
+
 /**
  * Allocate and initialize a new expression object. Returns NULL if it was
  * unable to be created.
@@ -161,6 +282,7 @@ void expression_free(expression_t *expression)
 		expression->operations = NULL;
 	}
 
+	mem_free(expression->steps);
 	mem_free(expression);
 }
 
@@ -197,6 +319,7 @@ expression_t *expression_copy(const expression_t *source)
 		copy->operations[i].operator = source->operations[i].operator;
 	}
 
+	expression_compile(copy);
 	return copy;
 }
 
@@ -207,6 +330,7 @@ void expression_set_base_value(expression_t *expression,
 							   expression_base_value_f function)
 {
 	expression->base_value = function;
+	expression_compile(expression);
 }
 
 /**
@@ -215,35 +339,10 @@ void expression_set_base_value(expression_t *expression,
  */
 s32b expression_evaluate(expression_t const * const expression)
 {
-	size_t i;
-	s32b value = 0;
-
-	if (expression->base_value != NULL)
-		value = expression->base_value();
-
-	for (i = 0; i < expression->operation_count; i++) {
-		switch (expression->operations[i].operator) {
-			case OPERATOR_ADD:
-				value += expression->operations[i].operand;
-				break;
-			case OPERATOR_SUB:
-				value -= expression->operations[i].operand;
-				break;
-			case OPERATOR_MUL:
-				value *= expression->operations[i].operand;
-				break;
-			case OPERATOR_DIV:
-				value /= expression->operations[i].operand;
-				break;
-			case OPERATOR_NEG:
-				value = -value;
-				break;
-			default:
-				break;
-		}
-	}
+	if (expression->base_value == NULL)
+		return expression->constant;
 
-	return value;
+	return expression_apply(expression, expression->base_value());
 }
 
 /**
@@ -380,6 +479,7 @@ s16b expression_add_operations_string(expression_t *expression,
 	for (i = 0; i < count; i++) {
 		expression_add_operation(expression, operations[i]);
 	}
+	expression_compile(expression);
 
 	string_free(parse_string);
 	return count;
@@ -354,6 +354,61 @@ bool file_newer(const char *first, const char *second)
 
 
 
+/**
+ * Get the size and modification time of a file.
+ */
+bool file_stat(const char *fname, u32b *size, u32b *mtime)
+{
+#ifdef HAVE_STAT
+	struct stat st;
+
+	if (stat(fname, &st) != 0) return FALSE;
+
+	*size = (u32b) st.st_size;
+	*mtime = (u32b) st.st_mtime;
+	return TRUE;
+#else /* HAVE_STAT */
+	ang_file *f = file_open(fname, MODE_READ, FTYPE_RAW);
+	long len;
+
+	if (!f) return FALSE;
+	len = (fseek(f->fh, 0, SEEK_END) == 0) ? ftell(f->fh) : -1;
+	file_close(f);
+	if (len < 0) return FALSE;
+
+	*size = (u32b) len;
+	*mtime = 0;
+	return TRUE;
+#endif /* !HAVE_STAT */
+}
+
+/**
+ * Get an FNV-1a checksum and the size of a file's contents.
+ */
+bool file_checksum(const char *fname, u32b *sum, u32b *size)
+{
+	char buf[4096];
+	ang_file *f;
+	int n;
+
+	f = file_open(fname, MODE_READ, FTYPE_RAW);
+	if (!f) return FALSE;
+
+	*sum = 2166136261UL;
+	*size = 0;
+	while ((n = file_read(f, buf, sizeof(buf))) > 0) {
+		int i;
+		for (i = 0; i < n; i++) {
+			*sum ^= (byte)buf[i];
+			*sum *= 16777619UL;
+		}
+		*size += n;
+	}
+
+	file_close(f);
+	return n == 0;
+}
+
 
 /** File-handle functions **/
 
@@ -476,6 +531,14 @@ bool file_skip(ang_file *f, int bytes)
 	return (fseek(f->fh, bytes, SEEK_CUR) == 0);
 }
 
+/**
+ * Seek to byte 'pos' from the start of file 'f'.
+ */
+bool file_seek(ang_file *f, u32b pos)
+{
+	return (fseek(f->fh, pos, SEEK_SET) == 0);
+}
+
 /**
  * Read a single, 8-bit character from file 'f'.
  */
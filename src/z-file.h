@@ -131,6 +131,21 @@ bool file_move(const char *fname, const char *newname);
  */
 bool file_newer(const char *first, const char *second);
 
+/**
+ * Gets the size and modification time of `fname`; the time is 0 where it
+ * isn't known.
+ *
+ * Returns TRUE if successful, FALSE otherwise.
+ */
+bool file_stat(const char *fname, u32b *size, u32b *mtime);
+
+/**
+ * Gets an FNV-1a checksum and the size of the contents of `fname`.
+ *
+ * Returns TRUE if successful, FALSE otherwise.
+ */
+bool file_checksum(const char *fname, u32b *sum, u32b *size);
+
 
 /** File handle creation **/
 
@@ -213,6 +228,12 @@ bool file_vputf(ang_file *f, const char *fmt, va_list vp);
  */
 bool file_skip(ang_file *f, int bytes);
 
+/**
+ * Seek to byte 'pos' from the start of the file.
+ * \returns TRUE if successful, FALSE otherwise.
+ */
+bool file_seek(ang_file *f, u32b pos);
+
 /**
  * Reads n bytes from file 'f' into buffer 'buf'.
  * \returns Number of bytes read; -1 on error
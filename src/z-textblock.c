@@ -28,7 +28,30 @@
 #include "z-form.h"
 
 #define TEXTBLOCK_LEN_INITIAL		128
-#define TEXTBLOCK_LEN_INCR(x)		((x) + 128)
+#define TEXTBLOCK_LEN_INCR(x)		((x) * 2)
+
+/**
+ * Number of line layouts kept per textblock; one for the screen and one for
+ * a file is the usual need.
+ */
+#define TEXTBLOCK_LAYOUTS			2
+
+/**
+ * Longest formatted append which is built on the stack
+ */
+#define TEXTBLOCK_FORMAT_LEN		1024
+
+/**
+ * The split of a textblock into lines at some width
+ */
+struct textblock_layout {
+	size_t width;
+	size_t n_lines;
+	size_t alloc;
+	size_t *line_starts;
+	size_t *line_lengths;
+	u32b used;
+};
 
 struct textblock {
 	wchar_t *text;
@@ -36,6 +59,9 @@ struct textblock {
 
 	size_t strlen;
 	size_t size;
+
+	struct textblock_layout layouts[TEXTBLOCK_LAYOUTS];
+	u32b clock;
 };
 
 
@@ -45,11 +71,11 @@ struct textblock {
  */
 textblock *textblock_new(void)
 {
-	textblock *tb = mem_zalloc(sizeof *tb);
+	textblock *tb = mem_zalloc_tag(sizeof *tb, MEM_TAG_UI);
 
 	tb->size = TEXTBLOCK_LEN_INITIAL;
-	tb->text = mem_zalloc(tb->size * sizeof *tb->text);
-	tb->attrs = mem_zalloc(tb->size);
+	tb->text = mem_zalloc_tag(tb->size * sizeof *tb->text, MEM_TAG_UI);
+	tb->attrs = mem_zalloc_tag(tb->size, MEM_TAG_UI);
 
 	return tb;
 }
@@ -59,44 +85,94 @@ textblock *textblock_new(void)
  */
 void textblock_free(textblock *tb)
 {
+	size_t i;
+
+	for (i = 0; i < TEXTBLOCK_LAYOUTS; i++) {
+		mem_free(tb->layouts[i].line_starts);
+		mem_free(tb->layouts[i].line_lengths);
+	}
 	mem_free(tb->text);
 	mem_free(tb->attrs);
 	mem_free(tb);
 }
 
+/**
+ * Forget the line layouts of a textblock whose text has changed, keeping
+ * their storage for reuse.
+ */
+static void textblock_changed(textblock *tb)
+{
+	size_t i;
+
+	for (i = 0; i < TEXTBLOCK_LAYOUTS; i++)
+		tb->layouts[i].width = 0;
+}
+
 /**
  * Resize the internal textblock storage (if needed) to hold additional
- * characters.
+ * characters, and a terminator after them.
+ *
+ * Storage grows geometrically, so building a block from many small appends
+ * copies each character only a constant number of times on average.
  *
  * \param tb is the textblock we need to resize.
  * \param additional_size is how many characters we want to add.
  */
 void textblock_resize_if_needed(textblock *tb, size_t additional_size)
 {
-	size_t remaining = tb->size - tb->strlen;
+	size_t needed = tb->strlen + additional_size + 1;
+
+	textblock_changed(tb);
 
 	/* If we need more room, reallocate it */
-	if (remaining < additional_size) {
-		tb->size = TEXTBLOCK_LEN_INCR(tb->strlen + additional_size);
+	if (tb->size < needed) {
+		while (tb->size < needed)
+			tb->size = TEXTBLOCK_LEN_INCR(tb->size);
 		tb->text = mem_realloc(tb->text, tb->size * sizeof *tb->text);
 		tb->attrs = mem_realloc(tb->attrs, tb->size);
 	}
 }
 
+/**
+ * Convert a string in the native (external) format straight into the end of
+ * the text block.
+ */
+static void textblock_append_mbs(textblock *tb, byte attr, const char *str,
+								 size_t len)
+{
+	size_t new_length;
+
+	/* No string has more wide characters than bytes */
+	textblock_resize_if_needed(tb, len);
+
+	new_length = text_mbstowcs(tb->text + tb->strlen, str,
+							   tb->size - tb->strlen);
+	assert(new_length != (size_t) -1); /* The string was badly formed */
+	memset(tb->attrs + tb->strlen, attr, new_length);
+	tb->strlen += new_length;
+	tb->text[tb->strlen] = 0;
+}
+
 static void textblock_vappend_c(textblock *tb, byte attr, const char *fmt,
 		va_list vp)
 {
-	size_t temp_len = TEXTBLOCK_LEN_INITIAL;
-	char *temp_space = mem_zalloc(temp_len);
-	int new_length;
+	char local[TEXTBLOCK_FORMAT_LEN];
+	size_t temp_len = sizeof(local);
+	char *temp_space = local;
+	size_t len;
+
+	/* Plain strings need no formatting */
+	if (!strchr(fmt, '%')) {
+		textblock_append_mbs(tb, attr, fmt, strlen(fmt));
+		return;
+	}
 
-	/* We have to format the incoming string in native (external) format
-	 * re-allocating the temporary space as necessary. Once it's been
-	 * successfully formatted, we can then do the conversion to wide chars
+	/* We have to format the incoming string in native (external) format,
+	 * moving to the heap if it is long. Once it's been successfully
+	 * formatted, we can then do the conversion to wide chars
 	 */
 	while (1) {
 		va_list args;
-		size_t len;
 
 		VA_COPY(args, vp);
 		len = vstrnfmt(temp_space, temp_len, fmt, args);
@@ -107,19 +183,15 @@ static void textblock_vappend_c(textblock *tb, byte attr, const char *fmt,
 		}
 
 		temp_len = TEXTBLOCK_LEN_INCR(temp_len);
-		temp_space = mem_realloc(temp_space, temp_len * sizeof *temp_space);
+		if (temp_space == local)
+			temp_space = mem_alloc(temp_len * sizeof *temp_space);
+		else
+			temp_space = mem_realloc(temp_space, temp_len * sizeof *temp_space);
 	}
 
-	/* Get extent of addition in wide chars */
-	new_length = text_mbstowcs(NULL, temp_space, 0);
-	assert(new_length >= 0); /* If this fails, the string was badly formed */
-	textblock_resize_if_needed(tb, new_length);
-
-	/* Convert to wide chars, into the text block buffer */
-	text_mbstowcs(tb->text + tb->strlen, temp_space, tb->size - tb->strlen);
-	memset(tb->attrs + tb->strlen, attr, new_length);
-	tb->strlen += new_length;
-	mem_free(temp_space);
+	textblock_append_mbs(tb, attr, temp_space, len);
+	if (temp_space != local)
+		mem_free(temp_space);
 }
 
 /**
@@ -131,6 +203,7 @@ void textblock_append_pict(textblock *tb, byte attr, int c)
 	tb->text[tb->strlen] = (wchar_t)c;
 	tb->attrs[tb->strlen] = attr;
 	tb->strlen += 1;
+	tb->text[tb->strlen] = 0;
 }
 
 /**
@@ -160,6 +233,7 @@ void textblock_append_utf8(textblock *tb, const char *utf8_string)
 
 	memset(tb->attrs + tb->strlen, COLOUR_WHITE, new_length);
 	tb->strlen += new_length;
+	tb->text[tb->strlen] = 0;
 }
 
 /**
@@ -189,6 +263,18 @@ void textblock_append_c(textblock *tb, byte attr, const char *fmt, ...)
 
 }
 
+/**
+ * Append the contents of one textblock to another.
+ */
+void textblock_append_textblock(textblock *tb, const textblock *tba)
+{
+	textblock_resize_if_needed(tb, tba->strlen);
+	memcpy(tb->text + tb->strlen, tba->text, tba->strlen * sizeof *tb->text);
+	memcpy(tb->attrs + tb->strlen, tba->attrs, tba->strlen);
+	tb->strlen += tba->strlen;
+	tb->text[tb->strlen] = 0;
+}
+
 /**
  * Return a pointer to the text inputted thus far.
  */
@@ -205,53 +291,159 @@ const byte *textblock_attrs(textblock *tb)
 	return tb->attrs;
 }
 
-static void new_line(size_t **line_starts, size_t **line_lengths,
-		size_t *n_lines, size_t *cur_line,
-		size_t start, size_t len)
+/* ------------------ Textblock caches ---------------- */
+
+/**
+ * A cache of built textblocks, each stored against a key made by the caller
+ * from everything the text depends on.  When full, the least recently used
+ * entry is replaced.
+ */
+struct textblock_cache {
+	struct textblock_cache_entry {
+		void *key;
+		size_t key_len;
+		textblock *tb;
+		u32b used;
+	} *entries;
+	size_t size;
+	u32b clock;
+};
+
+/**
+ * Make a cache holding up to size textblocks.
+ */
+textblock_cache *textblock_cache_new(size_t size)
+{
+	textblock_cache *cache = mem_zalloc(sizeof *cache);
+
+	cache->size = size;
+	cache->entries = mem_zalloc(size * sizeof *cache->entries);
+
+	return cache;
+}
+
+/**
+ * Forget everything in a cache.
+ */
+void textblock_cache_clear(textblock_cache *cache)
+{
+	size_t i;
+
+	for (i = 0; i < cache->size; i++) {
+		struct textblock_cache_entry *entry = &cache->entries[i];
+		if (!entry->tb) continue;
+		mem_free(entry->key);
+		textblock_free(entry->tb);
+		memset(entry, 0, sizeof *entry);
+	}
+}
+
+/**
+ * Free a cache.
+ */
+void textblock_cache_free(textblock_cache *cache)
+{
+	if (!cache) return;
+	textblock_cache_clear(cache);
+	mem_free(cache->entries);
+	mem_free(cache);
+}
+
+/**
+ * Find the textblock stored against a key.
+ * \return the textblock, which belongs to the cache, or NULL
+ */
+const textblock *textblock_cache_find(textblock_cache *cache, const void *key,
+									  size_t key_len)
+{
+	size_t i;
+
+	for (i = 0; i < cache->size; i++) {
+		struct textblock_cache_entry *entry = &cache->entries[i];
+		if (entry->tb && entry->key_len == key_len &&
+				!memcmp(entry->key, key, key_len)) {
+			entry->used = ++cache->clock;
+			return entry->tb;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Store a copy of a textblock against a key.
+ */
+void textblock_cache_add(textblock_cache *cache, const void *key,
+						 size_t key_len, const textblock *tb)
+{
+	struct textblock_cache_entry *entry = &cache->entries[0];
+	size_t i;
+
+	/* Replace an empty or the least recently used entry */
+	for (i = 0; i < cache->size && entry->tb; i++)
+		if (!cache->entries[i].tb || cache->entries[i].used < entry->used)
+			entry = &cache->entries[i];
+
+	if (entry->tb) {
+		mem_free(entry->key);
+		textblock_free(entry->tb);
+	}
+
+	entry->key = mem_alloc(key_len);
+	memcpy(entry->key, key, key_len);
+	entry->key_len = key_len;
+	entry->tb = textblock_new();
+	textblock_append_textblock(entry->tb, tb);
+	entry->used = ++cache->clock;
+}
+
+/* ------------------ Line layouts ---------------- */
+
+static void new_line(struct textblock_layout *layout, size_t start, size_t len)
 {
-	if (*cur_line == *n_lines) {
+	if (layout->n_lines == layout->alloc) {
 		/* this number is not arbitrary: it's the height of a "standard" term */
-		(*n_lines) += 24;
+		layout->alloc += 24;
 
-		*line_starts = mem_realloc(*line_starts,
-				*n_lines * sizeof **line_starts);
-		*line_lengths = mem_realloc(*line_lengths,
-				*n_lines * sizeof **line_lengths);
+		layout->line_starts = mem_realloc(layout->line_starts,
+				layout->alloc * sizeof *layout->line_starts);
+		layout->line_lengths = mem_realloc(layout->line_lengths,
+				layout->alloc * sizeof *layout->line_lengths);
 	}
 
-	(*line_starts)[*cur_line] = start;
-	(*line_lengths)[*cur_line] = len;
+	layout->line_starts[layout->n_lines] = start;
+	layout->line_lengths[layout->n_lines] = len;
 
-	(*cur_line)++;
+	layout->n_lines++;
 }
 
 /**
- * Given a certain width, split a textblock into wrapped lines of text.
- *
- * \returns Number of lines in output.
+ * Split a textblock into wrapped lines of text at a certain width.
  */
-size_t textblock_calculate_lines(textblock *tb,
-		size_t **line_starts, size_t **line_lengths, size_t width)
+static void textblock_layout_build(textblock *tb,
+		struct textblock_layout *layout, size_t width)
 {
 	const wchar_t *text = tb->text;
 
-	size_t cur_line = 0, n_lines = 0;
-
 	size_t len = tb->strlen;
 	size_t text_offset;
 
 	size_t line_start = 0, line_length = 0;
 	size_t word_start = 0, word_length = 0;
 
-	assert(width > 0);
+	layout->width = width;
+	layout->n_lines = 0;
 
 	for (text_offset = 0; text_offset < len; text_offset++) {
 		if (text[text_offset] == L'\n') {
-			new_line(line_starts, line_lengths, &n_lines, &cur_line,
-					line_start, line_length);
+			new_line(layout, line_start, line_length);
 
 			line_start = text_offset + 1;
 			line_length = 0;
+
+			/* A word doesn't carry on over a newline */
+			word_start = 0;
+			word_length = 0;
 		} else if (text[text_offset] == L' ') {
 			line_length++;
 
@@ -264,8 +456,7 @@ size_t textblock_calculate_lines(textblock *tb,
 
 		/* special case: if we have a very long word, just slice it */
 		if (word_length == width) {
-			new_line(line_starts, line_lengths, &n_lines, &cur_line,
-					line_start, line_length);
+			new_line(layout, line_start, line_length);
 
 			line_start += line_length;
 			line_length = 0;
@@ -277,15 +468,74 @@ size_t textblock_calculate_lines(textblock *tb,
 			while (text[line_start + last_word_offset] != L' ')
 				last_word_offset--;
 
-			new_line(line_starts, line_lengths, &n_lines, &cur_line,
-					line_start, last_word_offset);
+			new_line(layout, line_start, last_word_offset);
 
 			line_start += word_start;
 			line_length = word_length;
 		}
 	}
+}
+
+/**
+ * Given a certain width, split a textblock into wrapped lines of text.
+ *
+ * The split is kept with the textblock until its text changes, so showing the
+ * same block again at the same width (as pagers do on every redraw) costs
+ * nothing.
+ *
+ * \param tb is the textblock to split
+ * \param line_starts is set to the offset of each line in the text
+ * \param line_lengths is set to the length of each line
+ * \param width is the width to wrap at
+ * \returns Number of lines in output; the arrays belong to the textblock and
+ * are valid until it is next changed or freed.
+ */
+size_t textblock_lines(textblock *tb, const size_t **line_starts,
+		const size_t **line_lengths, size_t width)
+{
+	struct textblock_layout *layout = &tb->layouts[0];
+	size_t i;
 
-	return cur_line;
+	assert(width > 0);
+
+	/* Find a layout at this width, or the least recently used one */
+	for (i = 0; i < TEXTBLOCK_LAYOUTS; i++) {
+		if (tb->layouts[i].width == width) {
+			layout = &tb->layouts[i];
+			break;
+		}
+		if (tb->layouts[i].used < layout->used)
+			layout = &tb->layouts[i];
+	}
+
+	if (layout->width != width)
+		textblock_layout_build(tb, layout, width);
+	layout->used = ++tb->clock;
+
+	*line_starts = layout->line_starts;
+	*line_lengths = layout->line_lengths;
+	return layout->n_lines;
+}
+
+/**
+ * Given a certain width, split a textblock into wrapped lines of text.
+ *
+ * \returns Number of lines in output; the caller frees the arrays.
+ */
+size_t textblock_calculate_lines(textblock *tb,
+		size_t **line_starts, size_t **line_lengths, size_t width)
+{
+	const size_t *starts, *lengths;
+	size_t n_lines = textblock_lines(tb, &starts, &lengths, width);
+
+	*line_starts = mem_realloc(*line_starts, (n_lines + 1) * sizeof **line_starts);
+	*line_lengths = mem_realloc(*line_lengths, (n_lines + 1) * sizeof **line_lengths);
+	if (n_lines) {
+		memcpy(*line_starts, starts, n_lines * sizeof **line_starts);
+		memcpy(*line_lengths, lengths, n_lines * sizeof **line_lengths);
+	}
+
+	return n_lines;
 }
 
 /**
@@ -293,15 +543,14 @@ size_t textblock_calculate_lines(textblock *tb,
  */
 void textblock_to_file(textblock *tb, ang_file *f, int indent, int wrap_at)
 {
-	size_t *line_starts = NULL;
-	size_t *line_lengths = NULL;
+	const size_t *line_starts, *line_lengths;
 
 	size_t n_lines, i;
 
 	int width = wrap_at - indent;
 	assert(width > 0);
 
-	n_lines = textblock_calculate_lines(tb, &line_starts, &line_lengths, width);
+	n_lines = textblock_lines(tb, &line_starts, &line_lengths, width);
 
 	for (i = 0; i < n_lines; i++) {
 		/* For some reason, the %*c part of the format string was still
@@ -312,9 +561,6 @@ void textblock_to_file(textblock *tb, ang_file *f, int indent, int wrap_at)
 			file_putf(f, "%*c%.*ls\n", indent, ' ', line_lengths[i],
 					  tb->text + line_starts[i]);
 	}
-
-	mem_free(line_starts);
-	mem_free(line_lengths);
 }
 
 
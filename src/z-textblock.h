@@ -33,15 +33,29 @@ void textblock_append(textblock *tb, const char *fmt, ...);
 void textblock_append_c(textblock *tb, byte attr, const char *fmt, ...);
 void textblock_append_pict(textblock *tb, byte attr, int c);
 void textblock_append_utf8(textblock *tb, const char *utf8_string);
+void textblock_append_textblock(textblock *tb, const textblock *tba);
 
 const wchar_t *textblock_text(textblock *tb);
 const byte *textblock_attrs(textblock *tb);
 
+size_t textblock_lines(textblock *tb, const size_t **line_starts,
+		const size_t **line_lengths, size_t width);
 size_t textblock_calculate_lines(textblock *tb, size_t **line_starts,
 								 size_t **line_lengths, size_t width);
 
 void textblock_to_file(textblock *tb, ang_file *f, int indent, int wrap_at);
 
+/** Opaque cache of built textblocks */
+typedef struct textblock_cache textblock_cache;
+
+textblock_cache *textblock_cache_new(size_t size);
+void textblock_cache_clear(textblock_cache *cache);
+void textblock_cache_free(textblock_cache *cache);
+const textblock *textblock_cache_find(textblock_cache *cache, const void *key,
+									  size_t key_len);
+void textblock_cache_add(textblock_cache *cache, const void *key,
+						 size_t key_len, const textblock *tb);
+
 extern ang_file *text_out_file;
 extern void (*text_out_hook)(byte a, const char *str);
 extern int text_out_wrap;
@@ -20,10 +20,91 @@
 
 unsigned int mem_flags = 0;
 
-#define SZ(uptr)	*((size_t *)((char *)(uptr) - sizeof(size_t)))
+/**
+ * Each block is preceded by its length and the tag it is accounted to, with
+ * MEM_COUNTED set if it was allocated while accounting was on (and so should
+ * be taken off the counts when freed).
+ */
+#define MEM_HEADER	(2 * sizeof(size_t))
+#define MEM_COUNTED	0x100
+
+#define SZ(uptr)	(((size_t *)(uptr))[-2])
+#define TAG(uptr)	(((size_t *)(uptr))[-1])
+
+static const char *mem_tag_names[] = {
+	"misc",
+	"cave",
+	"objects",
+	"monsters",
+	"parser",
+	"ui",
+	"strings",
+	"total"
+};
+
+/**
+ * The counts for each tag, and for all of them together
+ */
+static struct mem_stats mem_stats[MEM_TAG_MAX + 1];
+
+/**
+ * The tag given to blocks allocated without one
+ */
+static int mem_tag = MEM_TAG_MISC;
+
+/**
+ * Add a block to the counts for its tag and the total
+ */
+static void mem_count_alloc(int tag, size_t len)
+{
+	int size_class = 0;
+	int i;
+
+	while ((size_class < MEM_SIZE_CLASSES - 1) &&
+		   (len > ((size_t) 16 << size_class)))
+		size_class++;
+
+	for (i = 0; i < 2; i++) {
+		struct mem_stats *stats = &mem_stats[i ? MEM_TAG_MAX : tag];
+		stats->live += len;
+		stats->blocks++;
+		stats->allocs++;
+		stats->sizes[size_class]++;
+		if (stats->live > stats->peak) stats->peak = stats->live;
+	}
+}
+
+/**
+ * Take a block off the counts for its tag and the total
+ */
+static void mem_count_free(int tag, size_t len)
+{
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		struct mem_stats *stats = &mem_stats[i ? MEM_TAG_MAX : tag];
+		stats->live -= len;
+		stats->blocks--;
+		stats->frees++;
+	}
+}
 
 /**
- * Allocate `len` bytes of memory.
+ * Change the size of a block in the counts for its tag and the total
+ */
+static void mem_count_resize(int tag, size_t old_len, size_t len)
+{
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		struct mem_stats *stats = &mem_stats[i ? MEM_TAG_MAX : tag];
+		stats->live = stats->live - old_len + len;
+		if (stats->live > stats->peak) stats->peak = stats->live;
+	}
+}
+
+/**
+ * Allocate `len` bytes of memory, accounted to `tag`.
  *
  * Returns:
  *  - NULL if `len` == 0; or
@@ -31,57 +112,143 @@ unsigned int mem_flags = 0;
  *
  * Doesn't return on out of memory.
  */
-void *mem_alloc(size_t len)
+void *mem_alloc_tag(size_t len, int tag)
 {
 	char *mem;
 
 	/* Allow allocation of "zero bytes" */
 	if (len == 0) return (NULL);
 
-	mem = malloc(len + sizeof(size_t));
+	mem = malloc(len + MEM_HEADER);
 	if (!mem)
 		quit("Out of Memory!");
-	mem += sizeof(size_t);
+	mem += MEM_HEADER;
 	if (mem_flags & MEM_POISON_ALLOC)
 		memset(mem, 0xCC, len);
 	SZ(mem) = len;
+	TAG(mem) = tag;
+
+	if (mem_flags & MEM_ACCOUNT) {
+		TAG(mem) |= MEM_COUNTED;
+		mem_count_alloc(tag, len);
+	}
 
 	return mem;
 }
 
-void *mem_zalloc(size_t len)
+void *mem_zalloc_tag(size_t len, int tag)
 {
-	void *mem = mem_alloc(len);
-	memset(mem, 0, len);
+	void *mem = mem_alloc_tag(len, tag);
+	if (mem) memset(mem, 0, len);
 	return mem;
 }
 
+/**
+ * Allocate `len` bytes of memory, accounted to the current tag.
+ */
+void *mem_alloc(size_t len)
+{
+	return mem_alloc_tag(len, mem_tag);
+}
+
+void *mem_zalloc(size_t len)
+{
+	return mem_zalloc_tag(len, mem_tag);
+}
+
 void mem_free(void *p)
 {
 	if (!p) return;
 
+	if (TAG(p) & MEM_COUNTED)
+		mem_count_free(TAG(p) & ~MEM_COUNTED, SZ(p));
+
 	if (mem_flags & MEM_POISON_FREE)
 		memset(p, 0xCD, SZ(p));
-	free((char *)p - sizeof(size_t));
+	free((char *)p - MEM_HEADER);
 }
 
+/**
+ * Resize a block, keeping the tag it was allocated with.
+ */
 void *mem_realloc(void *p, size_t len)
 {
 	char *m = p;
+	size_t old_len = m ? SZ(m) : 0;
+	size_t tag = m ? TAG(m) : (size_t) mem_tag;
 
 	/* Fail gracefully */
 	if (len == 0) return (NULL);
 
-	m = realloc(m ? m - sizeof(size_t) : NULL, len + sizeof(size_t));
-	m += sizeof(size_t);
+	m = realloc(m ? m - MEM_HEADER : NULL, len + MEM_HEADER);
 
 	/* Handle OOM */
 	if (!m) quit("Out of Memory!");
+	m += MEM_HEADER;
 	SZ(m) = len;
 
+	if (tag & MEM_COUNTED) {
+		mem_count_resize(tag & ~MEM_COUNTED, old_len, len);
+	} else if (!p && (mem_flags & MEM_ACCOUNT)) {
+		tag |= MEM_COUNTED;
+		mem_count_alloc(tag & ~MEM_COUNTED, len);
+	}
+	TAG(m) = tag;
+
 	return m;
 }
 
+/* ------------------ Accounting ---------------- */
+
+/**
+ * Set the tag that untagged allocations are accounted to.
+ * \return the previous tag, to be restored when done
+ */
+int mem_tag_set(int tag)
+{
+	int old = mem_tag;
+
+	assert(tag >= 0 && tag < MEM_TAG_MAX);
+	mem_tag = tag;
+
+	return old;
+}
+
+/**
+ * The name of a tag; MEM_TAG_MAX is the total over all tags.
+ */
+const char *mem_tag_name(int tag)
+{
+	assert(tag >= 0 && tag <= MEM_TAG_MAX);
+	return mem_tag_names[tag];
+}
+
+/**
+ * The memory use of a tag; MEM_TAG_MAX is the total over all tags.
+ */
+const struct mem_stats *mem_tag_stats(int tag)
+{
+	assert(tag >= 0 && tag <= MEM_TAG_MAX);
+	return &mem_stats[tag];
+}
+
+/**
+ * Start the counts again from the memory in use now: peaks are set to the
+ * live bytes and the allocation counts are cleared.
+ */
+void mem_stats_reset(void)
+{
+	int i;
+
+	for (i = 0; i <= MEM_TAG_MAX; i++) {
+		struct mem_stats *stats = &mem_stats[i];
+		stats->peak = stats->live;
+		stats->allocs = 0;
+		stats->frees = 0;
+		memset(stats->sizes, 0, sizeof(stats->sizes));
+	}
+}
+
 /**
  * Duplicates an existing string `str`, allocating as much memory as necessary.
  */
@@ -95,7 +262,7 @@ char *string_make(const char *str)
 
 	/* Allocate space for the string (including terminator) */
 	siz = strlen(str) + 1;
-	res = mem_alloc(siz);
+	res = mem_alloc_tag(siz, MEM_TAG_STRING);
 
 	/* Copy the string (with terminator) */
 	my_strcpy(res, str, siz);
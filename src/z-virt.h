@@ -15,21 +15,62 @@
 #include "h-basic.h"
 
 
+/**
+ * Subsystems that memory is accounted to
+ */
+enum {
+	MEM_TAG_MISC = 0,
+	MEM_TAG_CAVE,
+	MEM_TAG_OBJECT,
+	MEM_TAG_MONSTER,
+	MEM_TAG_PARSER,
+	MEM_TAG_UI,
+	MEM_TAG_STRING,
+
+	MEM_TAG_MAX
+};
+
+/**
+ * Number of size classes in the allocation histograms: up to 16 bytes, up
+ * to 32, and so on, with the last holding everything bigger.
+ */
+#define MEM_SIZE_CLASSES	12
+
+/**
+ * Memory use of one subsystem, kept while MEM_ACCOUNT is set in mem_flags
+ */
+struct mem_stats {
+	size_t live;					/* Bytes in use */
+	size_t peak;					/* Most bytes ever in use */
+	size_t blocks;					/* Blocks in use */
+	u32b allocs;					/* Blocks allocated */
+	u32b frees;						/* Blocks freed */
+	u32b sizes[MEM_SIZE_CLASSES];	/* Blocks allocated by size class */
+};
+
 /**
  * Replacements for malloc() and friends that die on failure.
  */
 void *mem_alloc(size_t len);
 void *mem_zalloc(size_t len);
+void *mem_alloc_tag(size_t len, int tag);
+void *mem_zalloc_tag(size_t len, int tag);
 void mem_free(void *p);
 void *mem_realloc(void *p, size_t len);
 
+int mem_tag_set(int tag);
+const char *mem_tag_name(int tag);
+const struct mem_stats *mem_tag_stats(int tag);
+void mem_stats_reset(void);
+
 char *string_make(const char *str);
 void string_free(char *str);
 char *string_append(char *s1, const char *s2);
 
 enum {
 	MEM_POISON_ALLOC = 0x00000001,
-	MEM_POISON_FREE  = 0x00000002
+	MEM_POISON_FREE  = 0x00000002,
+	MEM_ACCOUNT      = 0x00000004
 };
 
 extern unsigned int mem_flags;